@@ -0,0 +1,390 @@
+/************************************************************************
+ *
+ * Interface   : asciip_canvas.h
+ *
+ * Description : Contains methods to rasterize series onto a character
+ *               grid.
+ *
+ *               A canvas is one contiguous buffer of rows, each ending
+ *               in a newline, so that a whole frame is printed with a
+ *               single write. The axis mapping is set once per frame
+ *               and reduced to a scale per axis. Points are then
+ *               binned in one pass: two multiplies, a range check and
+ *               a store per point. Line segments between consecutive
+ *               points are clipped to the plot area and stepped
+ *               through the cells with integer Bresenham.
+ *
+ *               In braille mode every cell is a 2x4 grid of dots, so
+ *               the same pass draws at twice the columns and four
+ *               times the rows. Dots are ORed into one byte mask per
+ *               cell and only encoded to UTF-8 when a frame is
+ *               printed.
+ *
+ *               Large plots are cut into chunks of points rasterized
+ *               on the shared scheduler. Marking a cell twice leaves
+ *               it as marking it once, so the frame is the same as
+ *               from a single pass.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_CANVAS__
+#define __ASCIIP_CANVAS__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_ring.h"
+#include "asciip_series.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Points read from a list per batch while drawing it */
+#define ASCIIP_CANVAS_LIST_BATCH 512
+
+/* Points per chunk of a plot, plots below twice this are one chunk */
+#define ASCIIP_CANVAS_CHUNK (1 << 15)
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_canvas_t
+{
+   size_t   width;        /* Columns of the plot area */
+   size_t   height;       /* Rows of the plot area */
+   size_t   stride;       /* Bytes per row, width plus the newline */
+   char    *cells;        /* height rows of stride bytes, top row first */
+   uint8_t  mode;         /* asciip_canvas_mode_e value */
+   size_t   grid_width;   /* Drawable columns, cells or dots */
+   size_t   grid_height;  /* Drawable rows, cells or dots */
+   uint8_t *dots;         /* Braille dot mask per cell, row major */
+   char    *frame;        /* Braille frame encoded for output */
+   double   x_min;        /* x value at the left edge */
+   double   x_max;        /* x value at the right edge */
+   double   y_min;        /* y value at the bottom edge */
+   double   y_max;        /* y value at the top edge */
+   double   x_scale;      /* Grid columns per x unit */
+   double   y_scale;      /* Grid rows per y unit */
+
+} Asciip_Canvas;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+typedef enum _asciip_canvas_style_e
+{
+   ASCIIP_CANVAS_POINTS = 0x0,
+   ASCIIP_CANVAS_LINES  = 0x1
+
+} asciip_canvas_style_e;
+
+typedef enum _asciip_canvas_mode_e
+{
+   ASCIIP_CANVAS_TEXT    = 0x0,
+   ASCIIP_CANVAS_BRAILLE = 0x1
+
+} asciip_canvas_mode_e;
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_canvas_init
+ *
+ * Description : Initializes a blank canvas of width by height cells
+ *               mapping [0, 1] on both axes.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : width  - Number of columns, at least 1.
+ *               height - Number of rows, at least 1.
+ *               result - Pointer to store new canvas in.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL          - There was an error creating the canvas.
+ *               Asciip_Canvas - Created canvas.
+ *
+ ************************************************************************/
+Asciip_Canvas *asciip_canvas_init(size_t          width,
+                                  size_t          height,
+                                  Asciip_Canvas **result,
+                                  Asciip_Error   *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_destroy
+ *
+ * Description : Releases the canvas and its cells.
+ *
+ * Parameters  : canvas - Canvas to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_canvas_destroy(Asciip_Canvas *canvas);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_clear
+ *
+ * Description : Blanks every cell and clears every dot.
+ *
+ * Parameters  : canvas - Canvas to clear.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_canvas_clear(Asciip_Canvas *canvas);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_ring
+ *
+ * Description : Rasterizes every point of a ring, oldest first, as
+ *               asciip_canvas_plot. The ring is read in place, and in
+ *               line style the wrap point is joined up.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to draw on.
+ *               ring   - Ring to draw.
+ *               style  - asciip_canvas_style_e value.
+ *               mark   - Character to draw with.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, nothing was drawn.
+ *                0 - Ring drawn.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_draw_ring(Asciip_Canvas     *canvas,
+                               const Asciip_Ring *ring,
+                               uint8_t            style,
+                               char               mark,
+                               Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_set_mode
+ *
+ * Description : Selects whole-cell characters or 2x4 braille dots per
+ *               cell, then clears the canvas. The range is kept. In
+ *               braille mode the mark of a drawing call is ignored.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to change.
+ *               mode   - asciip_canvas_mode_e value.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, the mode is unchanged.
+ *                0 - Mode set.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_set_mode(Asciip_Canvas *canvas,
+                              uint8_t        mode,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_set_range
+ *
+ * Description : Sets the values at the edges of the plot area. Both
+ *               edges of an axis are inside the plot area.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to change.
+ *               x_min  - x value at the left edge.
+ *               x_max  - x value at the right edge.
+ *               y_min  - y value at the bottom edge.
+ *               y_max  - y value at the top edge.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, a range was not finite or
+ *                    empty. The mapping is unchanged.
+ *                0 - Range set.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_set_range(Asciip_Canvas *canvas,
+                               double         x_min,
+                               double         x_max,
+                               double         y_min,
+                               double         y_max,
+                               Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_fit
+ *
+ * Description : Sets the range to the extents in bounds, as given by
+ *               asciip_stats_series or asciip_summary_get. Axes with a
+ *               single value are widened by 0.5 either side, axes with
+ *               no values map [0, 1]. An infinite extent is replaced by
+ *               the finite one, or [0, 1] if neither is finite, and a
+ *               span wider than the largest double is cut down to
+ *               2^1023 around its midpoint, so any bounds can be drawn.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to change.
+ *               bounds - Extents to fit.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, a parameter was NULL.
+ *                0 - Range set.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_fit(Asciip_Canvas       *canvas,
+                         const Asciip_Bounds *bounds,
+                         Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_plot
+ *
+ * Description : Rasterizes count points from x and y arrays in one
+ *               pass, split over the shared scheduler from
+ *               2 * ASCIIP_CANVAS_CHUNK points. Points outside the
+ *               range, or with a NaN value, are skipped; in line style
+ *               a NaN also breaks the line.
+ *
+ * Parameters  : canvas - Canvas to draw on.
+ *               xs     - x values of the points.
+ *               ys     - y values of the points.
+ *               count  - Number of points.
+ *               style  - asciip_canvas_style_e value.
+ *               mark   - Character to draw with.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_canvas_plot(Asciip_Canvas *canvas,
+                        const double  *xs,
+                        const double  *ys,
+                        size_t         count,
+                        uint8_t        style,
+                        char           mark);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_series
+ *
+ * Description : Rasterizes every point of a series, as
+ *               asciip_canvas_plot.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to draw on.
+ *               series - Series to draw.
+ *               style  - asciip_canvas_style_e value.
+ *               mark   - Character to draw with.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, nothing was drawn.
+ *                0 - Series drawn.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_draw_series(Asciip_Canvas       *canvas,
+                                 const Asciip_Series *series,
+                                 uint8_t              style,
+                                 char                 mark,
+                                 Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_list
+ *
+ * Description : Rasterizes every point of a list, as
+ *               asciip_canvas_plot, reading it in batches of
+ *               ASCIIP_CANVAS_LIST_BATCH points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to draw on.
+ *               list   - List to draw.
+ *               style  - asciip_canvas_style_e value.
+ *               mark   - Character to draw with.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, nothing was drawn.
+ *                0 - List drawn.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_draw_list(Asciip_Canvas     *canvas,
+                               const Asciip_List *list,
+                               uint8_t            style,
+                               char               mark,
+                               Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_frame
+ *
+ * Description : Gets the rows of the canvas as printed, each ending in
+ *               a newline. Braille cells are encoded to UTF-8, with a
+ *               space for a cell without dots. The frame is owned by
+ *               the canvas and valid until it is next drawn on.
+ *
+ * Parameters  : canvas - Canvas to get the frame of.
+ *               length - Pointer to store the frame length in bytes.
+ *
+ * Returns     : const char * - Frame, not NUL terminated.
+ *
+ ************************************************************************/
+const char *asciip_canvas_frame(Asciip_Canvas *canvas,
+                                size_t        *length);
+
+
+/************************************************************************
+ * Name        : asciip_canvas_print
+ *
+ * Description : Writes the frame of the canvas to stream with a single
+ *               fwrite.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : canvas - Canvas to print.
+ *               stream - Stream to write to.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error writing.
+ *                0 - Canvas written.
+ *
+ ************************************************************************/
+int8_t asciip_canvas_print(Asciip_Canvas *canvas,
+                           FILE          *stream,
+                           Asciip_Error  *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_CANVAS__ */
@@ -0,0 +1,176 @@
+/************************************************************************
+ *
+ * Interface   : asciip_channel.h
+ *
+ * Description : Contains methods to pass buffers between two threads
+ *               through a bounded queue.
+ *
+ *               A channel is a ring of pointers with room for a fixed
+ *               number of items. A push into a full channel waits for
+ *               the consumer, and a pop from an empty channel waits for
+ *               the producer. A producer therefore can never run more
+ *               than capacity items ahead, which keeps the memory of a
+ *               pipeline bounded.
+ *
+ *               Items are expected to be whole batches, not single
+ *               points, so one lock per item costs little. Pairing a
+ *               channel of filled buffers with a channel of empty ones
+ *               lets two stages recycle a fixed set of buffers without
+ *               allocating.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_CHANNEL__
+#define __ASCIIP_CHANNEL__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_channel_t
+{
+   void            **items;      /* capacity slots */
+   size_t            capacity;   /* Most items held at once */
+   size_t            head;       /* Slot of the oldest item */
+   size_t            size;       /* Items held */
+   uint8_t           closed;     /* Set by asciip_channel_close */
+   pthread_mutex_t   lock;       /* Guards everything above */
+   pthread_cond_t    readable;   /* Signalled when an item or close arrives */
+   pthread_cond_t    writable;   /* Signalled when a slot or close frees up */
+
+} Asciip_Channel;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_channel_init
+ *
+ * Description : Initializes an open, empty channel holding up to
+ *               capacity items.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : capacity - Most items held at once, at least 1.
+ *               result   - Pointer to store new channel in.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : NULL           - There was an error creating the
+ *                                channel.
+ *               Asciip_Channel - Created channel.
+ *
+ ************************************************************************/
+Asciip_Channel *asciip_channel_init(size_t            capacity,
+                                    Asciip_Channel  **result,
+                                    Asciip_Error     *error);
+
+
+/************************************************************************
+ * Name        : asciip_channel_destroy
+ *
+ * Description : Releases the channel. Items still held are not freed,
+ *               and no thread may be waiting on it.
+ *
+ * Parameters  : channel - Channel to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_channel_destroy(Asciip_Channel *channel);
+
+
+/************************************************************************
+ * Name        : asciip_channel_push
+ *
+ * Description : Adds an item, waiting while the channel is full.
+ *
+ * Parameters  : channel - Channel to add to.
+ *               item    - Item to add.
+ *
+ * Returns     : -1 - The channel was closed, the item was not added.
+ *                0 - Item added.
+ *
+ ************************************************************************/
+int8_t asciip_channel_push(Asciip_Channel *channel,
+                           void           *item);
+
+
+/************************************************************************
+ * Name        : asciip_channel_pop
+ *
+ * Description : Removes the oldest item, waiting while the channel is
+ *               empty and open. Items pushed before the channel was
+ *               closed are still handed out.
+ *
+ * Parameters  : channel - Channel to remove from.
+ *
+ * Returns     : NULL   - The channel is closed and empty.
+ *               void * - Oldest item.
+ *
+ ************************************************************************/
+void *asciip_channel_pop(Asciip_Channel *channel);
+
+
+/************************************************************************
+ * Name        : asciip_channel_try_pop
+ *
+ * Description : Removes the oldest item if there is one, without
+ *               waiting.
+ *
+ * Parameters  : channel - Channel to remove from.
+ *
+ * Returns     : NULL   - The channel is empty.
+ *               void * - Oldest item.
+ *
+ ************************************************************************/
+void *asciip_channel_try_pop(Asciip_Channel *channel);
+
+
+/************************************************************************
+ * Name        : asciip_channel_close
+ *
+ * Description : Marks that no more items will be pushed and wakes every
+ *               waiting thread. Further pushes fail.
+ *
+ * Parameters  : channel - Channel to close.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_channel_close(Asciip_Channel *channel);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_CHANNEL__ */
@@ -0,0 +1,281 @@
+/************************************************************************
+ *
+ * Interface   : asciip_decimate.h
+ *
+ * Description : Contains methods to reduce a series to a few points per
+ *               column before it is rendered.
+ *
+ *               The x range is cut into a fixed number of buckets and
+ *               points are streamed through once, in any order and in
+ *               any number of batches. Each bucket only keeps its
+ *               count, the sums of its points and the points with its
+ *               smallest and largest y, so memory is O(buckets) however
+ *               many points pass through.
+ *
+ *               Min/max output keeps both extremes of every bucket, at
+ *               most two points per bucket, so every column spans the
+ *               same rows it would with every point drawn. Largest-
+ *               Triangle-Three-Buckets output keeps one point per
+ *               bucket, the extreme that makes the largest triangle
+ *               with the point kept before it and the mean of the next
+ *               bucket, plus the leftmost and rightmost points.
+ *
+ *               With as many buckets as a canvas has grid columns and
+ *               the same x range, buckets line up with columns exactly.
+ *               For a comparable point count use twice as many buckets
+ *               for Largest-Triangle-Three-Buckets.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_DECIMATE__
+#define __ASCIIP_DECIMATE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Points read from a list per batch while decimating it */
+#define ASCIIP_DECIMATE_LIST_BATCH 512
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_decimate_bucket_t
+{
+   double min_x;    /* x of the point with the smallest y */
+   double min_y;    /* Smallest y */
+   double max_x;    /* x of the point with the largest y */
+   double max_y;    /* Largest y */
+   double sum_x;    /* Sum of x over the bucket */
+   double sum_y;    /* Sum of y over the bucket */
+   size_t count;    /* Points in the bucket */
+
+} Asciip_Decimate_Bucket;
+
+
+typedef struct _asciip_decimate_t
+{
+   uint8_t                 method;    /* asciip_decimate_method_e value */
+   size_t                  buckets;   /* Number of buckets */
+   Asciip_Decimate_Bucket *bucket;    /* Buckets, left to right */
+   double                  x_min;     /* x value at the left edge */
+   double                  x_max;     /* x value at the right edge */
+   double                  x_scale;   /* Buckets per x unit */
+   size_t                  count;     /* Points inside the range */
+   double                  first[2];  /* Leftmost point inside the range */
+   double                  last[2];   /* Rightmost point inside the range */
+   uint8_t                 before;    /* A point left of the range was seen */
+   double                  prev[2];   /* Nearest point left of the range */
+   uint8_t                 after;     /* A point right of the range was seen */
+   double                  next[2];   /* Nearest point right of the range */
+
+} Asciip_Decimate;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+typedef enum _asciip_decimate_method_e
+{
+   ASCIIP_DECIMATE_MINMAX = 0x0,
+   ASCIIP_DECIMATE_LTTB   = 0x1
+
+} asciip_decimate_method_e;
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_decimate_init
+ *
+ * Description : Initializes an empty decimator with buckets over the
+ *               x range [0, 1].
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : buckets - Number of buckets, at least 1.
+ *               method  - asciip_decimate_method_e value.
+ *               result  - Pointer to store new decimator in.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : NULL            - There was an error creating the
+ *                                 decimator.
+ *               Asciip_Decimate - Created decimator.
+ *
+ ************************************************************************/
+Asciip_Decimate *asciip_decimate_init(size_t            buckets,
+                                      uint8_t           method,
+                                      Asciip_Decimate **result,
+                                      Asciip_Error     *error);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_destroy
+ *
+ * Description : Releases the decimator and its buckets.
+ *
+ * Parameters  : decimate - Decimator to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_decimate_destroy(Asciip_Decimate *decimate);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_clear
+ *
+ * Description : Forgets every point added, keeping the range.
+ *
+ * Parameters  : decimate - Decimator to clear.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_decimate_clear(Asciip_Decimate *decimate);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_set_range
+ *
+ * Description : Sets the x values at the edges of the first and last
+ *               bucket, both inside, and clears the decimator.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : decimate - Decimator to change.
+ *               x_min    - x value at the left edge.
+ *               x_max    - x value at the right edge.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : -1 - There was an error, the range was not finite or
+ *                    empty. The decimator is unchanged.
+ *                0 - Range set.
+ *
+ ************************************************************************/
+int8_t asciip_decimate_set_range(Asciip_Decimate *decimate,
+                                 double           x_min,
+                                 double           x_max,
+                                 Asciip_Error    *error);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_add
+ *
+ * Description : Streams count points from x and y arrays into the
+ *               buckets. Points with a value that is not finite are
+ *               skipped. Of the points outside the range only the
+ *               nearest on each side is kept, so that lines still run
+ *               off the edges of the plot.
+ *
+ * Parameters  : decimate - Decimator to add to.
+ *               xs       - x values of the points.
+ *               ys       - y values of the points.
+ *               count    - Number of points.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_decimate_add(Asciip_Decimate *decimate,
+                         const double    *xs,
+                         const double    *ys,
+                         size_t           count);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_add_series
+ *
+ * Description : Streams every point of a series into the buckets, as
+ *               asciip_decimate_add.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : decimate - Decimator to add to.
+ *               series   - Series to add.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : -1 - There was an error, nothing was added.
+ *                0 - Series added.
+ *
+ ************************************************************************/
+int8_t asciip_decimate_add_series(Asciip_Decimate     *decimate,
+                                  const Asciip_Series *series,
+                                  Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_add_list
+ *
+ * Description : Streams every point of a list into the buckets, as
+ *               asciip_decimate_add, reading it in batches of
+ *               ASCIIP_DECIMATE_LIST_BATCH points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : decimate - Decimator to add to.
+ *               list     - List to add.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : -1 - There was an error, nothing was added.
+ *                0 - List added.
+ *
+ ************************************************************************/
+int8_t asciip_decimate_add_list(Asciip_Decimate   *decimate,
+                                const Asciip_List *list,
+                                Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_decimate_output
+ *
+ * Description : Appends the reduced points to a series in increasing
+ *               x order: the nearest point left of the range, the
+ *               points chosen from the buckets, then the nearest point
+ *               right of the range. The decimator is left unchanged.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : decimate - Decimator to read.
+ *               result   - Series to append the points to.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : -1 - There was an error, result may hold some of the
+ *                    points.
+ *                0 - Points appended.
+ *
+ ************************************************************************/
+int8_t asciip_decimate_output(const Asciip_Decimate *decimate,
+                              Asciip_Series         *result,
+                              Asciip_Error          *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_DECIMATE__ */
@@ -0,0 +1,179 @@
+/************************************************************************
+ *
+ * Interface   : asciip_file.h
+ *
+ * Description : Contains methods to save a series to a binary file and
+ *               to load one back without copying it.
+ *
+ *               A series file is a fixed header followed by the x and
+ *               y columns as raw doubles in host byte order. The header
+ *               holds the point count, the byte offset of each column,
+ *               whether x is sorted, and the bounds of both axes, so
+ *               that a loaded file can be fitted and searched without
+ *               a pass over the points.
+ *
+ *               Loading maps the file read-only and points a series at
+ *               the columns in the mapping. Nothing is read or copied
+ *               up front. Pages are faulted in as they are drawn, so
+ *               the time from opening to the first frame does not grow
+ *               with the file size.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_FILE__
+#define __ASCIIP_FILE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* First bytes of every series file, NUL included */
+#define ASCIIP_FILE_MAGIC "ASCIIPS"
+
+/* Format version written, and the only one read */
+#define ASCIIP_FILE_VERSION 1
+
+/* Written as is so that a file from a host of the other byte order is
+ * rejected */
+#define ASCIIP_FILE_BYTE_ORDER 0x01020304u
+
+/* Header flag set when x is non-decreasing with no NaN values */
+#define ASCIIP_FILE_SORTED 0x1u
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_file_axis_t
+{
+   double   min;     /* Smallest value, NaN when count is 0 */
+   double   max;     /* Largest value, NaN when count is 0 */
+   double   sum;     /* Sum of the values */
+   uint64_t count;   /* Number of values that are not NaN */
+   uint64_t nans;    /* Number of NaN values */
+
+} Asciip_File_Axis;
+
+
+typedef struct _asciip_file_header_t
+{
+   char             magic[8];     /* ASCIIP_FILE_MAGIC */
+   uint32_t         version;      /* ASCIIP_FILE_VERSION */
+   uint32_t         byte_order;   /* ASCIIP_FILE_BYTE_ORDER */
+   uint32_t         flags;        /* ASCIIP_FILE_SORTED or 0 */
+   uint32_t         reserved;     /* Written as 0 */
+   uint64_t         count;        /* Number of points */
+   uint64_t         x_offset;     /* Byte offset of the x column */
+   uint64_t         y_offset;     /* Byte offset of the y column */
+   Asciip_File_Axis x;            /* Bounds of the x values */
+   Asciip_File_Axis y;            /* Bounds of the y values */
+
+} Asciip_File_Header;
+
+
+typedef struct _asciip_file_t
+{
+   const void    *map;      /* Read-only mapping of the whole file */
+   size_t         length;   /* Bytes mapped */
+   Asciip_Series  series;   /* Columns in the mapping, never written */
+   Asciip_Bounds  bounds;   /* Bounds from the header */
+   uint8_t        sorted;   /* Non-zero when x is sorted */
+
+} Asciip_File;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_file_write
+ *
+ * Description : Saves a series to path in the series file format,
+ *               replacing any file there. The bounds and the sorted
+ *               flag are computed while writing.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : path   - File to write.
+ *               series - Series to save.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error writing the file.
+ *                0 - File written.
+ *
+ ************************************************************************/
+int8_t asciip_file_write(const char          *path,
+                         const Asciip_Series *series,
+                         Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_file_init
+ *
+ * Description : Maps a series file read-only. The series of the result
+ *               points into the mapping and must not be written to or
+ *               grown; it can be passed to anything taking a const
+ *               series. The header is checked against the file size
+ *               before anything is exposed.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : path   - File to load.
+ *               result - Pointer to store the loaded file in.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL        - There was an error opening, mapping or
+ *                             checking the file.
+ *               Asciip_File - Loaded file.
+ *
+ ************************************************************************/
+Asciip_File *asciip_file_init(const char    *path,
+                              Asciip_File  **result,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_file_destroy
+ *
+ * Description : Unmaps a loaded file. Its series must no longer be in
+ *               use.
+ *
+ * Parameters  : file - File to release, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_file_destroy(Asciip_File *file);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_FILE__ */
@@ -8,6 +8,18 @@
  *               Gives methods to handle allocation and de-allocation 
  *               of memory required for the list, nodes, and points.
  * 
+ *               Sizes and indices are size_t so a list is only bounded
+ *               by memory. Each point costs one Asciip_Point and one
+ *               Asciip_Node allocation (32 bytes of payload on 64-bit
+ *               targets plus allocator overhead); use Asciip_Series
+ *               for large series, or a pooled list to carve points and
+ *               nodes from shared blocks.
+ * 
+ *               Random access goes through a chunk index built on the
+ *               first get or remove: asciip_list_get and 
+ *               asciip_list_remove run in O(log n) plus a walk of at
+ *               most ASCIIP_LIST_INDEX_CHUNK nodes.
+ * 
  * Author(s)   : N. McCallum
  * 
  * Version     : 0.1
@@ -25,6 +37,7 @@ extern "C"
 /************************************************************************
  * Standard Header Includes
  ************************************************************************/
+#include <stddef.h>
 #include <stdint.h>
 
 /************************************************************************
@@ -36,6 +49,9 @@ extern "C"
  ************************************************************************/
 #define MAX_ERROR_MESSAGE_LEN 50
 
+/* Nodes per chunk of the random access index */
+#define ASCIIP_LIST_INDEX_CHUNK 64
+
 /************************************************************************
  * Type and Struct Definitions
  ************************************************************************/
@@ -57,9 +73,13 @@ typedef struct _asciip_point_node_t
 
 typedef struct _asciip_point_list_t
 {
-   uint16_t     size;   /* Size of list */
-   Asciip_Node *head;   /* Starting element in list */
-   Asciip_Node *tail;   /* Last element in list */
+   size_t                 size;   /* Size of list */
+   Asciip_Node           *head;   /* Starting element in list */
+   Asciip_Node           *tail;   /* Last element in list */
+   struct _asciip_pool_t *pool;   /* Node and point storage, NULL if malloc'd */
+   struct _asciip_list_index_t *index;   /* Chunk index for random access, NULL until used */
+   uint8_t                keep_sorted;   /* Insert points in x order instead of appending */
+   struct _asciip_summary_t *summary;   /* Running bounds, NULL unless tracked */
    
 } Asciip_List;
 
@@ -72,14 +92,41 @@ typedef struct _asciip_error_t
 
 } Asciip_Error;
 
+
+typedef struct _asciip_list_iter_t
+{
+   Asciip_Node *node;   /* Next node to visit, NULL at the end */
+
+} Asciip_List_Iter;
+
+
+/* Point filter for batch removal, returns non-zero to select the point */
+typedef uint8_t (*Asciip_Point_Pred)(double  x,
+                                     double  y,
+                                     void   *context);
+
 /************************************************************************
  * Constant and Enumeration Definitions
  ************************************************************************/
+typedef enum _asciip_err_e
+{
+   ASCIIP_ERR_NULL_PTR = 0x0,
+   ASCIIP_ERR_MEM      = 0x1,
+   ASCIIP_ERR_INDEX    = 0x2,
+   ASCIIP_ERR_RANGE    = 0x3,
+   ASCIIP_ERR_IO       = 0x4,
+   ASCIIP_ERR_MAX_NUM  = 0x5
+   
+} asciip_err_e;
 
 /************************************************************************
  * Functions
  ************************************************************************/ 
 void report_error(Asciip_Error *error, uint8_t error_code, const char *error_message);
+
+/* Turns the stderr echo of report_error on or off, on by default. Set it
+ * before any thread reports errors */
+void report_error_echo(uint8_t echo);
 /************************************************************************
  * Name        : asciip_list_init
  * 
@@ -106,6 +153,37 @@ Asciip_List *asciip_list_init(Asciip_Point  *init_point,
                               Asciip_Error  *error);
 
 
+/************************************************************************
+ * Name        : asciip_list_init_pooled
+ * 
+ * Description : Initializes a new empty Ascii_List that owns a pool.
+ *               Every node and point of the list is carved from the
+ *               pool's blocks, so building the list calls malloc once
+ *               per block instead of twice per point, and destroying
+ *               it releases everything in O(blocks).
+ * 
+ *               Points passed to asciip_list_add are copied into the
+ *               pool and the passed point is destroyed. Points returned
+ *               by asciip_list_remove are copied out of the pool and
+ *               are released with asciip_point_destroy as usual.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : block_points - Points per pool block, 0 uses the
+ *                              pool default.
+ *               result       - Pointer to store new list in.
+ *               error        - Error tracker to hold errors that occur 
+ *                              in the method call.
+ * 
+ * Returns     : NULL        - There was an error creating the list.
+ *               Asciip_List - Created list. 
+ * 
+ ************************************************************************/ 
+Asciip_List *asciip_list_init_pooled(size_t         block_points,
+                                     Asciip_List  **result,
+                                     Asciip_Error  *error);
+
+
 /************************************************************************
  * Name        : asciip_list_destroy
  * 
@@ -132,6 +210,10 @@ int8_t asciip_list_destroy(Asciip_List  *list,
  * Description : Adds point to new node and appends it to the back
  *               of the list.
  * 
+ *               In keep sorted mode the node is instead placed after
+ *               the last point whose x is less than or equal to the
+ *               point's x.
+ * 
  *               If error is NULL, the errors will not be tracked.
  * 
  * Parameters  : list  - List to add point to.
@@ -139,14 +221,67 @@ int8_t asciip_list_destroy(Asciip_List  *list,
  *               error - Error tracker to hold errors that occur 
  *                       in the method call.
  * 
- * Returns     : -1 - There was an error adding the point to the list.
- *                0 - Point added to list successfully.
+ * Returns     : -1 - There was an error adding the point to the list,
+ *                    the caller still owns the point.
+ *                0 - Point added to list successfully. A pooled list
+ *                    copies the point and frees the caller's.
  * 
  ************************************************************************/                              
 int8_t asciip_list_add(Asciip_List  *list,
                        Asciip_Point *point,
                        Asciip_Error *error);
 
+/************************************************************************
+ * Name        : asciip_list_add_xy
+ * 
+ * Description : Creates the point (x, y) and appends it to the back of
+ *               the list. Pooled lists carve both the point and the 
+ *               node from the pool.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list  - List to add point to.
+ *               x     - x value of point.
+ *               y     - y value of point.
+ *               error - Error tracker to hold errors that occur 
+ *                       in the method call.
+ * 
+ * Returns     : -1 - There was an error adding the point to the list.
+ *                0 - Point added to list successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_add_xy(Asciip_List  *list,
+                          double        x,
+                          double        y,
+                          Asciip_Error *error);
+
+/************************************************************************
+ * Name        : asciip_list_add_many
+ * 
+ * Description : Creates a point for each (xs[i], ys[i]) pair and adds
+ *               them to the list in order, as asciip_list_add_xy would.
+ *               The caller's arrays are only read.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list  - List to add points to.
+ *               xs    - x values of the points.
+ *               ys    - y values of the points.
+ *               count - Number of points.
+ *               error - Error tracker to hold errors that occur 
+ *                       in the method call.
+ * 
+ * Returns     : -1 - There was an error, points before the failing
+ *                    one were added.
+ *                0 - All points added to list successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_add_many(Asciip_List  *list,
+                            const double *xs,
+                            const double *ys,
+                            size_t        count,
+                            Asciip_Error *error);
+
 /************************************************************************
  * Name        : asciip_list_remove
  * 
@@ -162,15 +297,111 @@ int8_t asciip_list_add(Asciip_List  *list,
  *                       in the method call.
  * 
  * Returns     : NULL        - There was an error removing node from 
- *                             list or the index doesn't exist.
+ *                             list or the index doesn't exist. The
+ *                             list is unchanged.
  *               Ascii_Point - Point removed from list.
  * 
  ************************************************************************/                              
 Asciip_Point *asciip_list_remove(Asciip_List  *list,
-                                 uint16_t      index,
+                                 size_t        index,
+                                 Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_remove_range
+ * 
+ * Description : Removes count points starting at index in one pass,
+ *               with a single lookup for the first node.
+ * 
+ *               If removed is not NULL the points are added to it in 
+ *               order (nodes move across without copying when neither
+ *               list is pooled), otherwise they are released.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list    - List to remove points from.
+ *               index   - Index of the first point to remove.
+ *               count   - Number of points to remove.
+ *               removed - List to move removed points to, NULL to
+ *                         release them. Must not be list.
+ *               error   - Error tracker to hold errors that occur 
+ *                         in the method call.
+ * 
+ * Returns     : -1 - There was an error, the range is out of bounds
+ *                    or removed could not take a point. Points 
+ *                    before the failing one were removed.
+ *                0 - Points removed successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_remove_range(Asciip_List  *list,
+                                 size_t        index,
+                                 size_t        count,
+                                 Asciip_List  *removed,
                                  Asciip_Error *error);
 
 
+/************************************************************************
+ * Name        : asciip_list_remove_outside
+ * 
+ * Description : Removes every point with x outside [lo, hi), including
+ *               points whose x is NaN, in one pass over the list.
+ * 
+ *               Removed points go to removed as in 
+ *               asciip_list_remove_range.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list    - List to remove points from.
+ *               lo      - Smallest x kept.
+ *               hi      - x values at or past this are removed.
+ *               removed - List to move removed points to, NULL to
+ *                         release them.
+ *               error   - Error tracker to hold errors that occur 
+ *                         in the method call.
+ * 
+ * Returns     : -1 - There was an error, points already visited were
+ *                    removed and the rest kept.
+ *                0 - Points removed successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_remove_outside(Asciip_List  *list,
+                                  double        lo,
+                                  double        hi,
+                                  Asciip_List  *removed,
+                                  Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_remove_if
+ * 
+ * Description : Removes every point pred selects in one pass over the
+ *               list, keeping the order of the rest.
+ * 
+ *               Removed points go to removed as in 
+ *               asciip_list_remove_range.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list    - List to remove points from.
+ *               pred    - Returns non-zero for points to remove.
+ *               context - Passed to every pred call.
+ *               removed - List to move removed points to, NULL to
+ *                         release them.
+ *               error   - Error tracker to hold errors that occur 
+ *                         in the method call.
+ * 
+ * Returns     : -1 - There was an error, points already visited were
+ *                    removed and the rest kept.
+ *                0 - Points removed successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_remove_if(Asciip_List       *list,
+                             Asciip_Point_Pred  pred,
+                             void              *context,
+                             Asciip_List       *removed,
+                             Asciip_Error      *error);
+
+
 /************************************************************************
  * Name        : asciip_list_get
  * 
@@ -191,16 +422,37 @@ Asciip_Point *asciip_list_remove(Asciip_List  *list,
  * 
  ************************************************************************/                              
 Asciip_Point *asciip_list_get(Asciip_List  *list,
-                              uint16_t      index,
+                              size_t        index,
                               Asciip_Point *result,
                               Asciip_Error *error);
 
 
+/************************************************************************
+ * Name        : asciip_list_index_chunks
+ * 
+ * Description : Gets the number of chunks in the random access index,
+ *               empty ones included. Chunks left empty by removes are
+ *               dropped once they are more than half of the index, so
+ *               the count stays within twice the chunks holding nodes.
+ * 
+ * Parameters  : list - List to inspect.
+ * 
+ * Returns     : Chunk count, 0 if list is NULL or the index is not 
+ *               built yet.
+ * 
+ ************************************************************************/                              
+size_t asciip_list_index_chunks(const Asciip_List *list);
+
+
 /************************************************************************
  * Name        : asciip_list_sort
  * 
  * Description : Sorts the list of points based on the x value of the 
- *               point from lowest to highest.
+ *               point from lowest to highest. The sort is stable.
+ * 
+ *               Short lists are merge sorted in place; longer lists 
+ *               are relinked in the order produced by the radix
+ *               engine in asciip_sort.h.
  * 
  *               If error is NULL, the errors will not be tracked.
  * 
@@ -216,6 +468,181 @@ int8_t asciip_list_sort(Asciip_List  *list,
                         Asciip_Error *error);
 
 
+/************************************************************************
+ * Name        : asciip_list_keep_sorted
+ * 
+ * Description : Turns keep sorted mode on or off. While it is on the
+ *               list stays ordered by x: asciip_list_add and 
+ *               asciip_list_add_xy insert each point after the last
+ *               point with an x less than or equal to it, so the list
+ *               never needs a full sort before rendering.
+ * 
+ *               A point at or past the current tail x is appended in
+ *               O(1). Other points are placed by binary search over the
+ *               chunk index in O(log^2 n).
+ * 
+ *               Turning the mode on sorts the list once.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list   - List to change.
+ *               enable - Non-zero to keep the list sorted.
+ *               error  - Error tracker to hold errors that occur 
+ *                        in the method call.
+ * 
+ * Returns     : -1 - There was an error sorting the list.
+ *                0 - Mode changed.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_keep_sorted(Asciip_List  *list,
+                               uint8_t       enable,
+                               Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_splice
+ * 
+ * Description : Moves every point of other into list in front of the
+ *               point at index, leaving other empty.
+ * 
+ *               When both lists allocate from the same place (neither
+ *               is pooled, or they share a pool through 
+ *               asciip_list_split) the node run is relinked without
+ *               touching its nodes: O(1) at either end, O(log n) in
+ *               the middle. Otherwise each point is copied into 
+ *               list's storage and released from other.
+ * 
+ *               Lists in keep sorted mode take the points through
+ *               asciip_list_merge instead and index is ignored. If
+ *               other is not ordered by x it is sorted first, so points
+ *               left in other after an error may have been reordered.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list  - List to move points into.
+ *               index - Index the first moved point ends up at,
+ *                       list size to append.
+ *               other - List to move points from. Must not be list.
+ *               error - Error tracker to hold errors that occur 
+ *                       in the method call.
+ * 
+ * Returns     : -1 - There was an error, points not yet moved are
+ *                    still in other.
+ *                0 - Points moved successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_splice(Asciip_List  *list,
+                          size_t        index,
+                          Asciip_List  *other,
+                          Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_concat
+ * 
+ * Description : Moves every point of other to the back of list, as
+ *               asciip_list_splice at index list size.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list  - List to move points into.
+ *               other - List to move points from. Must not be list.
+ *               error - Error tracker to hold errors that occur 
+ *                       in the method call.
+ * 
+ * Returns     : -1 - There was an error, points not yet moved are
+ *                    still in other.
+ *                0 - Points moved successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_concat(Asciip_List  *list,
+                          Asciip_List  *other,
+                          Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_split
+ * 
+ * Description : Moves the points from index to the end of list into a
+ *               new list in O(log n). No point is copied: the new list
+ *               shares list's pool, if any, and keep sorted mode.
+ *               A summary (see asciip_summary.h) is not carried over.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list   - List to split.
+ *               index  - Index of the first point to move.
+ *               result - Pointer to store new list in.
+ *               error  - Error tracker to hold errors that occur 
+ *                        in the method call.
+ * 
+ * Returns     : NULL        - There was an error, list is unchanged.
+ *               Asciip_List - New list holding the moved points.
+ * 
+ ************************************************************************/                              
+Asciip_List *asciip_list_split(Asciip_List   *list,
+                               size_t         index,
+                               Asciip_List  **result,
+                               Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_split_x
+ * 
+ * Description : Splits a list sorted by x at the first point with x
+ *               greater than or equal to x, found by binary search.
+ *               Points before it stay in list.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list   - List to split, sorted by x.
+ *               x      - Smallest x moved to the new list.
+ *               result - Pointer to store new list in.
+ *               error  - Error tracker to hold errors that occur 
+ *                        in the method call.
+ * 
+ * Returns     : NULL        - There was an error, list is unchanged.
+ *               Asciip_List - New list holding the moved points.
+ * 
+ ************************************************************************/                              
+Asciip_List *asciip_list_split_x(Asciip_List   *list,
+                                 double         x,
+                                 Asciip_List  **result,
+                                 Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_list_merge
+ * 
+ * Description : Merges count lists sorted by x into list, also sorted
+ *               by x, leaving the others empty. Nodes are relinked
+ *               through a heap over the list heads in O(n log count);
+ *               points are only copied from lists that do not share
+ *               list's storage (see asciip_list_splice).
+ * 
+ *               The merge is stable: equal x values keep list order,
+ *               then the order of others.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ * 
+ * Parameters  : list   - Sorted list to merge into.
+ *               others - Distinct sorted lists to merge from, none of
+ *                        them list.
+ *               count  - Number of lists in others.
+ *               error  - Error tracker to hold errors that occur 
+ *                        in the method call.
+ * 
+ * Returns     : -1 - There was an error. Every point is still held
+ *                    by one of the lists, but list may be unsorted.
+ *                0 - Lists merged successfully.
+ * 
+ ************************************************************************/                              
+int8_t asciip_list_merge(Asciip_List   *list,
+                         Asciip_List  **others,
+                         size_t         count,
+                         Asciip_Error  *error);
+
+
 /************************************************************************
  * Name        : asciip_point_init
  * 
@@ -253,6 +680,74 @@ Asciip_Point *asciip_point_init(double         x,
  ************************************************************************/                              
 void asciip_point_destroy(Asciip_Point *point);
 
+
+/************************************************************************
+ * Name        : asciip_list_iter_begin
+ * 
+ * Description : Positions the iterator at the first point of the list.
+ *               The iterator stays valid as long as the node it is
+ *               positioned on is not removed.
+ * 
+ * Parameters  : list - List to iterate over.
+ *               iter - Iterator to position.
+ * 
+ * Returns     : void
+ * 
+ ************************************************************************/                              
+static inline void asciip_list_iter_begin(const Asciip_List *list,
+                                          Asciip_List_Iter  *iter)
+{
+   iter->node = list->head;
+}
+
+
+/************************************************************************
+ * Name        : asciip_list_iter_next
+ * 
+ * Description : Returns the point under the iterator and advances it
+ *               to the next point. Does no bounds or NULL checks 
+ *               beyond detecting the end of the list.
+ * 
+ * Parameters  : iter - Iterator to advance.
+ * 
+ * Returns     : NULL         - The iterator is at the end of the list.
+ *               Asciip_Point - Next point in list order.
+ * 
+ ************************************************************************/                              
+static inline Asciip_Point *asciip_list_iter_next(Asciip_List_Iter *iter)
+{
+   Asciip_Node *nodep = iter->node;
+   
+   if (nodep == NULL)
+   {
+      return NULL;
+   }
+   
+   iter->node = nodep->next;
+   return nodep->data;
+}
+
+
+/************************************************************************
+ * Name        : asciip_list_iter_read
+ * 
+ * Description : Copies up to max points from the iterator into the
+ *               caller's x and y buffers and advances past them, so
+ *               batch consumers can work on contiguous arrays.
+ * 
+ * Parameters  : iter - Iterator to read from.
+ *               xs   - Buffer for at least max x values.
+ *               ys   - Buffer for at least max y values.
+ *               max  - Capacity of the buffers.
+ * 
+ * Returns     : Number of points copied, 0 at the end of the list.
+ * 
+ ************************************************************************/                              
+size_t asciip_list_iter_read(Asciip_List_Iter *iter,
+                             double           *xs,
+                             double           *ys,
+                             size_t            max);
+
 #ifdef __cplusplus
 } /* End extern */
 #endif
@@ -0,0 +1,212 @@
+/************************************************************************
+ *
+ * Interface   : asciip_live.h
+ *
+ * Description : Contains methods to tail a stream of points on screen,
+ *               redrawing at a fixed frame rate.
+ *
+ *               Producers push points into a fixed-capacity ring under
+ *               a lock held only for the copy. The refresh loop wakes
+ *               on an absolute monotonic deadline once per frame,
+ *               however fast or slow points arrive. Each frame drops
+ *               points older than the time window, autoscales to what
+ *               is left, draws it and sends the cells that changed
+ *               through asciip_term, so the plot updates in place with
+ *               one write per frame. A frame that overruns skips
+ *               the deadlines it missed instead of queueing behind
+ *               them.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_LIVE__
+#define __ASCIIP_LIVE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_canvas.h"
+#include "asciip_lists.h"
+#include "asciip_ring.h"
+#include "asciip_term.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_live_t
+{
+   Asciip_Ring     *ring;      /* Points on screen */
+   Asciip_Canvas   *canvas;    /* Frame being drawn */
+   Asciip_Term     *term;      /* Terminal frames are sent to */
+   double           window;    /* x span kept behind the newest point, 0 keeps all */
+   uint32_t         fps;       /* Frames per second */
+   uint8_t          style;     /* asciip_canvas_style_e value */
+   char             mark;      /* Character to draw with */
+   uint8_t          running;   /* Cleared by asciip_live_stop */
+   uint64_t         frames;    /* Frames written */
+   uint64_t         missed;    /* Frame deadlines skipped by late frames */
+   pthread_mutex_t  lock;      /* Guards ring and running */
+   pthread_cond_t   wake;      /* Signalled by asciip_live_stop */
+
+} Asciip_Live;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_live_init
+ *
+ * Description : Initializes a live plot keeping up to capacity points
+ *               on a width by height canvas. Nothing is allocated after
+ *               this call.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : capacity - Number of points kept, at least 1.
+ *               width    - Number of columns, at least 1.
+ *               height   - Number of rows, at least 1.
+ *               fps      - Frames per second, at least 1.
+ *               stream   - Stream to write frames to, flushed once
+ *                          here and then written to directly.
+ *               result   - Pointer to store new live plot in.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : NULL        - There was an error creating the plot.
+ *               Asciip_Live - Created live plot.
+ *
+ ************************************************************************/
+Asciip_Live *asciip_live_init(size_t         capacity,
+                              size_t         width,
+                              size_t         height,
+                              uint32_t       fps,
+                              FILE          *stream,
+                              Asciip_Live  **result,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_live_destroy
+ *
+ * Description : Releases the live plot, its ring and its canvas. The
+ *               loop must not be running.
+ *
+ * Parameters  : live - Live plot to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_live_destroy(Asciip_Live *live);
+
+
+/************************************************************************
+ * Name        : asciip_live_push
+ *
+ * Description : Adds count points as the newest, evicting the oldest
+ *               once the ring is full. Safe to call from any thread
+ *               while the loop runs.
+ *
+ * Parameters  : live  - Live plot to add to.
+ *               xs    - x values of the points, in increasing order.
+ *               ys    - y values of the points.
+ *               count - Number of points.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_live_push(Asciip_Live  *live,
+                      const double *xs,
+                      const double *ys,
+                      size_t        count);
+
+
+/************************************************************************
+ * Name        : asciip_live_frame
+ *
+ * Description : Draws and writes one frame of the points in the
+ *               window.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : live  - Live plot to draw.
+ *               error - Error tracker to hold errors that occur
+ *                       in the method call.
+ *
+ * Returns     : -1 - There was an error writing the frame.
+ *                0 - Frame written.
+ *
+ ************************************************************************/
+int8_t asciip_live_frame(Asciip_Live  *live,
+                         Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_live_run
+ *
+ * Description : Writes a frame every 1 / fps seconds on the calling
+ *               thread until asciip_live_stop is called or frames
+ *               have been written. After a stop one last frame is
+ *               written, so the screen shows every point pushed. If
+ *               the plot was already stopped only that frame is
+ *               written.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : live   - Live plot to run.
+ *               frames - Frames to write, 0 for no limit.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error writing a frame.
+ *                0 - Loop stopped or frames written.
+ *
+ ************************************************************************/
+int8_t asciip_live_run(Asciip_Live  *live,
+                       uint64_t      frames,
+                       Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_live_stop
+ *
+ * Description : Stops the loop, waking it if it is waiting for the
+ *               next frame. Safe to call from any thread.
+ *
+ * Parameters  : live - Live plot to stop.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_live_stop(Asciip_Live *live);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_LIVE__ */
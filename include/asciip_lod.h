@@ -0,0 +1,231 @@
+/************************************************************************
+ *
+ * Interface   : asciip_lod.h
+ *
+ * Description : Contains methods to keep a level of detail pyramid
+ *               over a series sorted by x, so that a zoomed or panned
+ *               view is reduced to columns without rescanning it.
+ *
+ *               Level 0 holds the smallest and largest y, and where
+ *               they are, of every ASCIIP_LOD_LEAF consecutive points.
+ *               Each level above merges pairs of buckets of the one
+ *               below, doubling the points per bucket. Only complete
+ *               buckets are kept; points past the last one are read
+ *               directly.
+ *
+ *               Because x is sorted, the points of a column are one
+ *               index range, found by binary search. The range is then
+ *               covered by O(log n) aligned buckets plus fewer than
+ *               ASCIIP_LOD_LEAF points at either end, so a query costs
+ *               O(columns log n) however many points are in view.
+ *
+ *               Level 0 is built in parallel. Appending points to the
+ *               series only adds the buckets they complete.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_LOD__
+#define __ASCIIP_LOD__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Points per level 0 bucket, a power of two */
+#define ASCIIP_LOD_LEAF 32
+
+/* Upper bound on pyramid levels */
+#define ASCIIP_LOD_MAX_LEVELS 48
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_lod_bucket_t
+{
+   double min;      /* Smallest finite y */
+   double max;      /* Largest finite y */
+   size_t min_at;   /* Index of the point with the smallest y */
+   size_t max_at;   /* Index of the point with the largest y */
+   size_t count;    /* Points with a finite y */
+
+} Asciip_Lod_Bucket;
+
+
+typedef struct _asciip_lod_level_t
+{
+   Asciip_Lod_Bucket *buckets;    /* Complete buckets, in x order */
+   size_t             size;       /* Number of buckets */
+   size_t             capacity;   /* Number of buckets that fit */
+
+} Asciip_Lod_Level;
+
+
+typedef struct _asciip_lod_t
+{
+   const Asciip_Series *series;                        /* Series summarized */
+   size_t               size;                          /* Points summarized */
+   uint32_t             threads;                       /* Build chunks, 0 picks */
+   Asciip_Lod_Level     level[ASCIIP_LOD_MAX_LEVELS];  /* Level 0 first */
+
+} Asciip_Lod;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_lod_init
+ *
+ * Description : Builds a pyramid over every point of a series. The
+ *               series must be sorted by x and have no NaN x values,
+ *               and must outlive the pyramid.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series  - Series to summarize.
+ *               threads - Chunks to build in on the shared
+ *                         scheduler, 0 picks asciip_sort_threads.
+ *               result  - Pointer to store new pyramid in.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : NULL       - There was an error creating the pyramid.
+ *               Asciip_Lod - Created pyramid.
+ *
+ ************************************************************************/
+Asciip_Lod *asciip_lod_init(const Asciip_Series  *series,
+                            uint32_t              threads,
+                            Asciip_Lod          **result,
+                            Asciip_Error         *error);
+
+
+/************************************************************************
+ * Name        : asciip_lod_destroy
+ *
+ * Description : Releases the pyramid. The series is not touched.
+ *
+ * Parameters  : lod - Pyramid to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_lod_destroy(Asciip_Lod *lod);
+
+
+/************************************************************************
+ * Name        : asciip_lod_update
+ *
+ * Description : Catches the pyramid up with points appended to the
+ *               series since it was built or last updated, in
+ *               O(appended) time. Appended points must keep the series
+ *               sorted. If the series shrank the pyramid is rebuilt.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : lod   - Pyramid to update.
+ *               error - Error tracker to hold errors that occur
+ *                       in the method call.
+ *
+ * Returns     : -1 - There was an error, the pyramid still summarizes
+ *                    the points it did before.
+ *                0 - Pyramid updated.
+ *
+ ************************************************************************/
+int8_t asciip_lod_update(Asciip_Lod   *lod,
+                         Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_lod_query
+ *
+ * Description : Reduces the points with x in [x_min, x_max] to one
+ *               bucket per column. Columns split the range evenly, the
+ *               right edge belongs to the last column, as on a canvas
+ *               with the same range and as many grid columns.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : lod     - Pyramid to read.
+ *               x_min   - x value at the left edge.
+ *               x_max   - x value at the right edge.
+ *               columns - Number of columns, at least 1.
+ *               result  - Array of columns buckets to fill. Columns
+ *                         without points get a count of 0.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, the range was not finite or
+ *                    empty.
+ *                0 - Columns filled.
+ *
+ ************************************************************************/
+int8_t asciip_lod_query(const Asciip_Lod  *lod,
+                        double             x_min,
+                        double             x_max,
+                        size_t             columns,
+                        Asciip_Lod_Bucket *result,
+                        Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_lod_output
+ *
+ * Description : Appends the points a view needs to a series, in x
+ *               order: the nearest point left of [x_min, x_max], the
+ *               points with the smallest and largest y of each column,
+ *               then the nearest point right of the range. Drawn with
+ *               the same range, every column spans the rows it would
+ *               with every point drawn.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : lod     - Pyramid to read.
+ *               x_min   - x value at the left edge.
+ *               x_max   - x value at the right edge.
+ *               columns - Number of columns, at least 1.
+ *               result  - Series to append the points to.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, result may hold some of the
+ *                    points.
+ *                0 - Points appended.
+ *
+ ************************************************************************/
+int8_t asciip_lod_output(const Asciip_Lod *lod,
+                         double            x_min,
+                         double            x_max,
+                         size_t            columns,
+                         Asciip_Series    *result,
+                         Asciip_Error     *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_LOD__ */
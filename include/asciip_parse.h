@@ -0,0 +1,254 @@
+/************************************************************************
+ *
+ * Interface   : asciip_parse.h
+ *
+ * Description : Contains methods to parse text of x/y pairs into
+ *               points.
+ *
+ *               Each line holds an x and a y value separated by spaces,
+ *               tabs or a comma; anything after a further separator is
+ *               ignored, so extra CSV columns are allowed. Blank lines
+ *               are passed over and lines that do not start with two
+ *               numbers, such as a CSV header, are counted as skipped.
+ *
+ *               Line ends are found with memchr, which the C library
+ *               vectorizes, and the numbers within a line are parsed in
+ *               place without allocating or copying: decimal digits are
+ *               gathered into an integer and scaled by an exact power
+ *               of ten, which rounds correctly while the digits fit in
+ *               53 bits and the exponent is at most 22. Anything else,
+ *               including inf and nan, falls back to strtod.
+ *
+ *               Streams are read through one large buffer, and parsed
+ *               points are added to the series a batch at a time.
+ *
+ *               Text held in memory, such as a mapped file, can be
+ *               parsed on several threads. It is cut into one chunk per
+ *               thread at line ends, the chunks are parsed on the
+ *               shared scheduler, each into a series of its own, and
+ *               the series are appended in input order. The first
+ *               chunk is parsed straight into the result, so one thread
+ *               copies nothing.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_PARSE__
+#define __ASCIIP_PARSE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Bytes read from a stream per read call */
+#define ASCIIP_PARSE_BUFFER (1 << 20)
+
+/* Points parsed before they are added to the series */
+#define ASCIIP_PARSE_BATCH 4096
+
+/* Bytes of text per parsing thread, below which no more are used */
+#define ASCIIP_PARSE_CHUNK (1 << 22)
+
+/* Most threads parsing one text */
+#define ASCIIP_PARSE_MAX_THREADS 64
+
+/* Bytes of a mapped file parsed per thread per pass, which bounds the
+ * points held outside the result */
+#define ASCIIP_PARSE_SEGMENT (1 << 24)
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_parse_stats_t
+{
+   uint64_t bytes;     /* Bytes of text parsed */
+   uint64_t lines;     /* Lines seen, blank lines included */
+   uint64_t points;    /* Points parsed */
+   uint64_t skipped;   /* Lines that were not blank and held no point */
+
+} Asciip_Parse_Stats;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_parse_number
+ *
+ * Description : Parses one number at the start of text, reading no
+ *               further than end. Leading whitespace is not skipped.
+ *
+ * Parameters  : text   - First character of the number.
+ *               end    - One past the last character that may be read.
+ *               result - Pointer to store the value in.
+ *
+ * Returns     : NULL         - text does not start with a number.
+ *               const char * - First character after the number.
+ *
+ ************************************************************************/
+const char *asciip_parse_number(const char *text,
+                                const char *end,
+                                double     *result);
+
+
+/************************************************************************
+ * Name        : asciip_parse_lines
+ *
+ * Description : Parses whole lines of text into points until the text
+ *               or the room for points runs out. A last line without a
+ *               newline is only parsed when final is set, otherwise it
+ *               is left for the caller to complete.
+ *
+ * Parameters  : text     - Text to parse.
+ *               length   - Bytes of text.
+ *               final    - Non-zero when no more text follows.
+ *               xs       - Array to store the x values in.
+ *               ys       - Array to store the y values in.
+ *               capacity - Room in xs and ys.
+ *               consumed - Pointer to store the bytes parsed in, always
+ *                          up to the end of a line.
+ *               stats    - Counters to add the lines and points parsed
+ *                          to, may be NULL. bytes is not changed.
+ *
+ * Returns     : Number of points stored.
+ *
+ ************************************************************************/
+size_t asciip_parse_lines(const char         *text,
+                          size_t              length,
+                          uint8_t             final,
+                          double             *xs,
+                          double             *ys,
+                          size_t              capacity,
+                          size_t             *consumed,
+                          Asciip_Parse_Stats *stats);
+
+
+/************************************************************************
+ * Name        : asciip_parse_fd
+ *
+ * Description : Reads a file descriptor to its end and adds every point
+ *               parsed to a series. A line longer than
+ *               ASCIIP_PARSE_BUFFER is counted as skipped.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : fd     - File descriptor to read.
+ *               series - Series to add the points to.
+ *               stats  - Counters to add to, may be NULL.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error reading or growing the series.
+ *                    The points parsed before it stay in the series.
+ *                0 - Stream parsed.
+ *
+ ************************************************************************/
+int8_t asciip_parse_fd(int                 fd,
+                       Asciip_Series      *series,
+                       Asciip_Parse_Stats *stats,
+                       Asciip_Error       *error);
+
+
+/************************************************************************
+ * Name        : asciip_parse_threads
+ *
+ * Description : Returns the number of threads used for length bytes of
+ *               text: one per ASCIIP_PARSE_CHUNK bytes, bounded by the
+ *               scheduler's workers and ASCIIP_PARSE_MAX_THREADS.
+ *
+ * Parameters  : length - Bytes of text to parse.
+ *
+ * Returns     : Thread count, at least 1.
+ *
+ ************************************************************************/
+uint32_t asciip_parse_threads(size_t length);
+
+
+/************************************************************************
+ * Name        : asciip_parse_text
+ *
+ * Description : Parses every line of text, the last one with or
+ *               without a newline, and appends the points to a series
+ *               in input order.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : text    - Text to parse.
+ *               length  - Bytes of text.
+ *               threads - Threads to use, 0 picks asciip_parse_threads.
+ *               series  - Series to append to.
+ *               stats   - Counters to add to, may be NULL.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error growing a series, nothing was
+ *                    appended.
+ *                0 - Text parsed.
+ *
+ ************************************************************************/
+int8_t asciip_parse_text(const char         *text,
+                         size_t              length,
+                         uint32_t            threads,
+                         Asciip_Series      *series,
+                         Asciip_Parse_Stats *stats,
+                         Asciip_Error       *error);
+
+
+/************************************************************************
+ * Name        : asciip_parse_file
+ *
+ * Description : Maps a regular file and parses it as
+ *               asciip_parse_text, ASCIIP_PARSE_SEGMENT bytes per thread
+ *               at a time. Anything that cannot be mapped, such as a
+ *               pipe, is read as asciip_parse_fd.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : path    - File to parse.
+ *               threads - Threads to use, 0 picks asciip_parse_threads.
+ *               series  - Series to append to.
+ *               stats   - Counters to add to, may be NULL.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error opening or reading the file,
+ *                    or growing the series. The points parsed before it
+ *                    stay in the series.
+ *                0 - File parsed.
+ *
+ ************************************************************************/
+int8_t asciip_parse_file(const char         *path,
+                         uint32_t            threads,
+                         Asciip_Series      *series,
+                         Asciip_Parse_Stats *stats,
+                         Asciip_Error       *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_PARSE__ */
@@ -0,0 +1,172 @@
+/************************************************************************
+ *
+ * Interface   : asciip_pool.h
+ *
+ * Description : Contains methods to handle a slab pool of fixed-size
+ *               objects.
+ *
+ *               Objects are carved from blocks holding many objects
+ *               each, so the allocator is only called once per block.
+ *               Released objects are kept on a free list for reuse and
+ *               destroying the pool releases every object in
+ *               O(blocks).
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_POOL__
+#define __ASCIIP_POOL__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+#define ASCIIP_POOL_DEFAULT_BLOCK_OBJECTS 1024
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_pool_block_t
+{
+   struct _asciip_pool_block_t *next;   /* Next block owned by the pool */
+
+} Asciip_Pool_Block;
+
+
+typedef struct _asciip_pool_t
+{
+   size_t             object_size;     /* Bytes per object, pointer aligned */
+   size_t             block_objects;   /* Objects carved from each block */
+   Asciip_Pool_Block *blocks;          /* Most recently allocated block first */
+   size_t             carved;          /* Objects carved from the first block */
+   void              *free_list;       /* Released objects ready for reuse */
+   size_t             mallocs;         /* Number of blocks allocated */
+   size_t             allocs;          /* Number of objects handed out */
+   size_t             refs;            /* Owners sharing the pool */
+
+} Asciip_Pool;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_pool_init
+ *
+ * Description : Initializes a new empty pool handing out objects of
+ *               object_size bytes. No block is allocated until the
+ *               first object is requested.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : object_size   - Size of each object in bytes.
+ *               block_objects - Number of objects per block, 0 uses
+ *                               ASCIIP_POOL_DEFAULT_BLOCK_OBJECTS.
+ *               result        - Pointer to store new pool in.
+ *               error         - Error tracker to hold errors that occur
+ *                               in the method call.
+ *
+ * Returns     : NULL        - There was an error creating the pool.
+ *               Asciip_Pool - Created pool.
+ *
+ ************************************************************************/
+Asciip_Pool *asciip_pool_init(size_t         object_size,
+                              size_t         block_objects,
+                              Asciip_Pool  **result,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_pool_retain
+ *
+ * Description : Adds an owner to the pool. Each owner calls
+ *               asciip_pool_destroy once when it is done with it.
+ *
+ * Parameters  : pool - Pool to share.
+ *
+ * Returns     : pool
+ *
+ ************************************************************************/
+Asciip_Pool *asciip_pool_retain(Asciip_Pool *pool);
+
+
+/************************************************************************
+ * Name        : asciip_pool_destroy
+ *
+ * Description : Drops one owner of the pool. When the last owner is
+ *               gone, releases every block held by the pool, and with
+ *               them every object ever handed out, then the pool
+ *               itself.
+ *
+ * Parameters  : pool - Pool to destroy.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_pool_destroy(Asciip_Pool *pool);
+
+
+/************************************************************************
+ * Name        : asciip_pool_alloc
+ *
+ * Description : Hands out one object, reusing a released object if
+ *               there is one and allocating a new block only when the
+ *               current block is exhausted.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : pool  - Pool to take the object from.
+ *               error - Error tracker to hold errors that occur
+ *                       in the method call.
+ *
+ * Returns     : NULL   - There was an error allocating the object.
+ *               void * - Uninitialized object of object_size bytes.
+ *
+ ************************************************************************/
+void *asciip_pool_alloc(Asciip_Pool  *pool,
+                        Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_pool_release
+ *
+ * Description : Returns an object taken from the pool so that it can
+ *               be handed out again. The memory stays owned by the
+ *               pool until it is destroyed.
+ *
+ * Parameters  : pool   - Pool the object was taken from.
+ *               object - Object to release.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_pool_release(Asciip_Pool *pool,
+                         void        *object);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_POOL__ */
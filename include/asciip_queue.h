@@ -0,0 +1,260 @@
+/************************************************************************
+ *
+ * Interface   : asciip_queue.h
+ *
+ * Description : Contains methods to collect points from many producer
+ *               threads and hand them to one consumer in batches,
+ *               without locks.
+ *
+ *               Every producer thread claims a lane of its own. A lane
+ *               is a single-producer, single-consumer ring of x and y
+ *               columns: the producer only moves the tail, the consumer
+ *               only moves the head, and each publishes its position
+ *               with one release store. Producers therefore never
+ *               contend with each other, and the consumer never blocks
+ *               a producer. The two positions live on separate cache
+ *               lines and the producer keeps a cached copy of the
+ *               head, so a push touches shared memory only when its
+ *               lane looks full.
+ *
+ *               The consumer drains each lane in at most two
+ *               contiguous runs per call. Points of one producer keep
+ *               their order; points of different producers are
+ *               interleaved a batch at a time.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_QUEUE__
+#define __ASCIIP_QUEUE__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Bytes per cache line, the spacing of positions written by different
+ * threads */
+#define ASCIIP_QUEUE_LINE 64
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_queue_lane_t
+{
+   size_t  tail;         /* Next slot the producer fills, published by it */
+   size_t  head_cache;   /* Producer's last look at head */
+   size_t  mask;         /* Slots less one, a power of two less one */
+   double *x;            /* x values, mask + 1 slots */
+   double *y;            /* y values, mask + 1 slots */
+   char    pad_producer[ASCIIP_QUEUE_LINE - 3 * sizeof(size_t) - 2 * sizeof(double *)];
+   size_t  head;         /* Next slot the consumer reads, published by it */
+   char    pad_consumer[ASCIIP_QUEUE_LINE - sizeof(size_t)];
+
+} Asciip_Queue_Lane;
+
+
+typedef struct _asciip_queue_t
+{
+   Asciip_Queue_Lane *lanes;      /* Lanes, one cache line aligned each */
+   size_t             count;      /* Number of lanes */
+   size_t             claimed;    /* Lanes handed out to producers */
+   size_t             next;       /* Lane the next drain starts at */
+
+} Asciip_Queue;
+
+
+/* Receives a contiguous run of drained points, returning -1 to leave
+ * them in the queue */
+typedef int8_t (*Asciip_Queue_Sink)(const double *xs,
+                                    const double *ys,
+                                    size_t        count,
+                                    void         *context);
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_queue_init
+ *
+ * Description : Initializes a queue of lanes for up to producers
+ *               threads, each holding capacity points. Nothing is
+ *               allocated after this call.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : producers - Number of lanes, at least 1.
+ *               capacity  - Points per lane, rounded up to a power of
+ *                           two.
+ *               result    - Pointer to store new queue in.
+ *               error     - Error tracker to hold errors that occur
+ *                           in the method call.
+ *
+ * Returns     : NULL         - There was an error creating the queue.
+ *               Asciip_Queue - Created queue.
+ *
+ ************************************************************************/
+Asciip_Queue *asciip_queue_init(size_t          producers,
+                                size_t          capacity,
+                                Asciip_Queue  **result,
+                                Asciip_Error   *error);
+
+
+/************************************************************************
+ * Name        : asciip_queue_destroy
+ *
+ * Description : Releases the queue and its lanes. No thread may be
+ *               using it.
+ *
+ * Parameters  : queue - Queue to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_queue_destroy(Asciip_Queue *queue);
+
+
+/************************************************************************
+ * Name        : asciip_queue_lane
+ *
+ * Description : Claims a lane for the calling producer thread. Safe to
+ *               call from any thread. A lane must only ever be pushed
+ *               to from one thread.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : queue - Queue to claim from.
+ *               error - Error tracker to hold errors that occur
+ *                       in the method call.
+ *
+ * Returns     : NULL              - There was an error, every lane was
+ *                                   claimed.
+ *               Asciip_Queue_Lane - Lane for the caller.
+ *
+ ************************************************************************/
+Asciip_Queue_Lane *asciip_queue_lane(Asciip_Queue *queue,
+                                     Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_queue_push
+ *
+ * Description : Adds a point to a lane if it has room.
+ *
+ * Parameters  : lane - Lane of the calling thread.
+ *               x    - Parameter value.
+ *               y    - f(x) value.
+ *
+ * Returns     : 1 - Point added.
+ *               0 - Lane full, the point was not added.
+ *
+ ************************************************************************/
+uint8_t asciip_queue_push(Asciip_Queue_Lane *lane,
+                          double             x,
+                          double             y);
+
+
+/************************************************************************
+ * Name        : asciip_queue_push_many
+ *
+ * Description : Adds as many of count points to a lane as it has room
+ *               for, oldest first, published with one store.
+ *
+ * Parameters  : lane  - Lane of the calling thread.
+ *               xs    - x values of the points.
+ *               ys    - y values of the points.
+ *               count - Number of points.
+ *
+ * Returns     : Number of points added.
+ *
+ ************************************************************************/
+size_t asciip_queue_push_many(Asciip_Queue_Lane *lane,
+                              const double      *xs,
+                              const double      *ys,
+                              size_t             count);
+
+
+/************************************************************************
+ * Name        : asciip_queue_drain
+ *
+ * Description : Hands every point published so far to a sink, lane by
+ *               lane, starting one lane further on each call so that
+ *               no lane is always served last. Must only be called from
+ *               one thread at a time.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : queue   - Queue to drain.
+ *               sink    - Function receiving each run of points.
+ *               context - User-defined value passed to sink.
+ *               drained - Pointer to store the number of points
+ *                         handed over in, may be NULL.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, the sink refused a run. It and
+ *                    the rest of its lane stay queued.
+ *                0 - Queue drained.
+ *
+ ************************************************************************/
+int8_t asciip_queue_drain(Asciip_Queue      *queue,
+                          Asciip_Queue_Sink  sink,
+                          void              *context,
+                          size_t            *drained,
+                          Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_queue_drain_series
+ *
+ * Description : Appends every point published so far to a series, as
+ *               asciip_queue_drain.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : queue   - Queue to drain.
+ *               series  - Series to append to.
+ *               drained - Pointer to store the number of points
+ *                         appended in, may be NULL.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error growing the series, the points
+ *                    not appended stay queued.
+ *                0 - Queue drained.
+ *
+ ************************************************************************/
+int8_t asciip_queue_drain_series(Asciip_Queue  *queue,
+                                 Asciip_Series *series,
+                                 size_t        *drained,
+                                 Asciip_Error  *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_QUEUE__ */
@@ -0,0 +1,222 @@
+/************************************************************************
+ *
+ * Interface   : asciip_ring.h
+ *
+ * Description : Contains methods to keep the most recent points of a
+ *               stream in a fixed-capacity ring buffer.
+ *
+ *               The x and y columns are allocated once, when the ring
+ *               is created. Pushing a point into a full ring overwrites
+ *               the oldest one, so both push and evict are O(1) and
+ *               never allocate. The points are read back, oldest first,
+ *               as at most two contiguous runs of the columns.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_RING__
+#define __ASCIIP_RING__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_ring_t
+{
+   size_t  capacity;   /* Number of points the ring holds */
+   size_t  head;       /* Slot of the oldest point */
+   size_t  size;       /* Number of points held */
+   double *x;          /* x values, capacity slots */
+   double *y;          /* y values, capacity slots */
+
+} Asciip_Ring;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_ring_init
+ *
+ * Description : Initializes an empty ring holding up to capacity
+ *               points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : capacity - Number of points kept, at least 1.
+ *               result   - Pointer to store new ring in.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : NULL        - There was an error creating the ring.
+ *               Asciip_Ring - Created ring.
+ *
+ ************************************************************************/
+Asciip_Ring *asciip_ring_init(size_t         capacity,
+                              Asciip_Ring  **result,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_ring_destroy
+ *
+ * Description : Releases the ring and its columns.
+ *
+ * Parameters  : ring - Ring to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_ring_destroy(Asciip_Ring *ring);
+
+
+/************************************************************************
+ * Name        : asciip_ring_clear
+ *
+ * Description : Drops every point.
+ *
+ * Parameters  : ring - Ring to clear.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_ring_clear(Asciip_Ring *ring);
+
+
+/************************************************************************
+ * Name        : asciip_ring_push
+ *
+ * Description : Adds a point as the newest, evicting the oldest if the
+ *               ring is full.
+ *
+ * Parameters  : ring - Ring to add to.
+ *               x    - Parameter value.
+ *               y    - f(x) value.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+static inline void asciip_ring_push(Asciip_Ring *ring,
+                                    double       x,
+                                    double       y)
+{
+   size_t slot = ring->head + ring->size;
+
+   slot = (slot < ring->capacity) ? slot : slot - ring->capacity;
+   ring->x[slot] = x;
+   ring->y[slot] = y;
+
+   if (ring->size < ring->capacity)
+   {
+      ring->size++;
+   }
+   else
+   {
+      ring->head = (ring->head + 1 < ring->capacity) ? ring->head + 1 : 0;
+   }
+}
+
+
+/************************************************************************
+ * Name        : asciip_ring_push_many
+ *
+ * Description : Adds count points from x and y arrays, oldest first,
+ *               with at most two copies per column. Of more than
+ *               capacity points only the newest are kept.
+ *
+ * Parameters  : ring  - Ring to add to.
+ *               xs    - x values of the points.
+ *               ys    - y values of the points.
+ *               count - Number of points.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_ring_push_many(Asciip_Ring  *ring,
+                           const double *xs,
+                           const double *ys,
+                           size_t        count);
+
+
+/************************************************************************
+ * Name        : asciip_ring_evict
+ *
+ * Description : Drops up to count of the oldest points.
+ *
+ * Parameters  : ring  - Ring to evict from.
+ *               count - Number of points to drop.
+ *
+ * Returns     : Number of points dropped.
+ *
+ ************************************************************************/
+size_t asciip_ring_evict(Asciip_Ring *ring,
+                         size_t       count);
+
+
+/************************************************************************
+ * Name        : asciip_ring_evict_before
+ *
+ * Description : Drops the oldest points while their x is below a
+ *               cutoff, such as the newest x less the time window on
+ *               screen. Costs O(1) per point dropped.
+ *
+ * Parameters  : ring - Ring to evict from.
+ *               x    - Smallest x kept at the head of the ring.
+ *
+ * Returns     : Number of points dropped.
+ *
+ ************************************************************************/
+size_t asciip_ring_evict_before(Asciip_Ring *ring,
+                                double       x);
+
+
+/************************************************************************
+ * Name        : asciip_ring_runs
+ *
+ * Description : Sets views on the points of the ring, oldest first, as
+ *               at most two contiguous runs of the columns. The offset
+ *               of a view is the age order of its first point. Nothing
+ *               is copied; the views stay valid until the ring is
+ *               modified.
+ *
+ * Parameters  : ring - Ring to read.
+ *               runs - Views to set. Unused views are left empty.
+ *
+ * Returns     : Number of non-empty runs, 0 to 2.
+ *
+ ************************************************************************/
+uint8_t asciip_ring_runs(const Asciip_Ring  *ring,
+                         Asciip_Series_View  runs[2]);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_RING__ */
@@ -0,0 +1,171 @@
+/************************************************************************
+ *
+ * Interface   : asciip_sched.h
+ *
+ * Description : Contains the task scheduler shared by every parallel
+ *               kernel of the library.
+ *
+ *               The scheduler owns one set of worker threads, started
+ *               on first use and asleep between jobs, so kernels never
+ *               create threads of their own. A job is a range of
+ *               indices cut into chunks of a fixed grain. The calling
+ *               thread takes the whole range, and every participant
+ *               splits what it holds in half, keeping the lower half
+ *               and pushing the upper half on its own deque, until it
+ *               holds a single chunk. Idle participants steal from the
+ *               top of the other deques, which holds the largest
+ *               halves, so work spreads out with few steals.
+ *
+ *               Chunk boundaries depend only on the range and the
+ *               grain, never on the number of workers. A kernel that
+ *               keeps one partial result per chunk and folds them in
+ *               order gets the same answer on any number of threads.
+ *               With one worker, every chunk runs on the calling
+ *               thread in order, which makes runs reproducible for
+ *               tests.
+ *
+ *               One job runs at a time. A job started while another
+ *               is running, or from inside a job, runs on the calling
+ *               thread alone, so threads are never oversubscribed.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_SCHED__
+#define __ASCIIP_SCHED__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Upper bound on workers, the calling thread included */
+#define ASCIIP_SCHED_MAX_WORKERS 64
+
+/* Tasks one deque holds. Halving a range of at most 2^32 chunks never
+ * leaves more than 32 halves on a deque */
+#define ASCIIP_SCHED_DEQUE 64
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/* Runs the indices [begin, end) of a job */
+typedef void (*Asciip_Sched_Body)(size_t  begin,
+                                  size_t  end,
+                                  void   *context);
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_sched_set_workers
+ *
+ * Description : Sets the number of workers, the calling thread of a
+ *               job included. Waits for a running job to finish and
+ *               stops the current workers; the new ones are started
+ *               by the next job.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : workers - Workers to use, 0 for one per online
+ *                         processor, 1 to run every job on the calling
+ *                         thread in chunk order.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, more than
+ *                    ASCIIP_SCHED_MAX_WORKERS workers were asked for.
+ *                0 - Worker count set.
+ *
+ ************************************************************************/
+int8_t asciip_sched_set_workers(uint32_t      workers,
+                                Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_sched_workers
+ *
+ * Description : Gets the number of workers a job runs on.
+ *
+ * Parameters  : void
+ *
+ * Returns     : Worker count, at least 1.
+ *
+ ************************************************************************/
+uint32_t asciip_sched_workers(void);
+
+
+/************************************************************************
+ * Name        : asciip_sched_parallel_for
+ *
+ * Description : Calls body once per chunk of [begin, end), the chunks
+ *               being [begin + k * grain, begin + (k + 1) * grain)
+ *               with the last one cut short at end. Returns once every
+ *               chunk has run. Chunks may run at the same time, in any
+ *               order, on any worker.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : begin   - First index.
+ *               end     - One past the last index.
+ *               grain   - Indices per chunk, at least 1.
+ *               body    - Function run on each chunk.
+ *               context - Passed to every call of body.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, body was NULL, grain was 0
+ *                    or there were 2^32 chunks or more. Nothing ran.
+ *                0 - Every chunk ran.
+ *
+ ************************************************************************/
+int8_t asciip_sched_parallel_for(size_t             begin,
+                                 size_t             end,
+                                 size_t             grain,
+                                 Asciip_Sched_Body  body,
+                                 void              *context,
+                                 Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_sched_shutdown
+ *
+ * Description : Waits for a running job to finish and stops the
+ *               workers. The next job starts them again.
+ *
+ * Parameters  : void
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_sched_shutdown(void);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_SCHED__ */
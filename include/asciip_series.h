@@ -0,0 +1,518 @@
+/************************************************************************
+ *
+ * Interface   : asciip_series.h
+ *
+ * Description : Contains methods to handle a series of points stored
+ *               in contiguous, growable x and y arrays.
+ *
+ *               A series is the cache-friendly alternative to the
+ *               linked Asciip_List. Points are not allocated one at a
+ *               time; the x and y columns grow geometrically so that
+ *               appending is amortized O(1) and a million point series
+ *               only ever holds two data allocations.
+ *
+ *               Memory budget: 16 bytes per point once reserved to
+ *               size, never more than ASCIIP_SERIES_MAX_BYTES_PER_POINT
+ *               while growing by doubling.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_SERIES__
+#define __ASCIIP_SERIES__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+#define ASCIIP_SERIES_MIN_CAPACITY 16
+
+/* Worst case bytes held per stored point: both columns at 2x slack */
+#define ASCIIP_SERIES_MAX_BYTES_PER_POINT (2 * 2 * sizeof(double))
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_series_t
+{
+   size_t  size;       /* Number of points stored */
+   size_t  capacity;   /* Number of points the columns can hold */
+   double *x;          /* Parameter values, contiguous */
+   double *y;          /* f(x) values, contiguous */
+
+} Asciip_Series;
+
+
+typedef struct _asciip_series_cursor_t
+{
+   const Asciip_Series *series;   /* Series being read */
+   size_t               pos;      /* Index of the next point to read */
+
+} Asciip_Series_Cursor;
+
+
+typedef struct _asciip_series_view_t
+{
+   const double *x;        /* x values of the points in view */
+   const double *y;        /* y values of the points in view */
+   size_t        size;     /* Number of points in view */
+   size_t        offset;   /* Series index of the first point in view */
+
+} Asciip_Series_View;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_series_init
+ *
+ * Description : Initializes a new empty Asciip_Series with room for
+ *               at least capacity points.
+ *
+ *               A capacity of 0 creates the series without allocating
+ *               the columns; they are allocated on the first add.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : capacity - Number of points to reserve up front.
+ *               result   - Pointer to store new series in.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : NULL          - There was an error creating the series.
+ *               Asciip_Series - Created series.
+ *
+ ************************************************************************/
+Asciip_Series *asciip_series_init(size_t          capacity,
+                                  Asciip_Series **result,
+                                  Asciip_Error   *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_destroy
+ *
+ * Description : Releases the columns and the series struct.
+ *
+ * Parameters  : series - Series to destroy.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_series_destroy(Asciip_Series *series);
+
+
+/************************************************************************
+ * Name        : asciip_series_reserve
+ *
+ * Description : Grows the columns so that the series can hold at least
+ *               capacity points without reallocating. Never shrinks.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series   - Series to grow.
+ *               capacity - Number of points required.
+ *               error    - Error tracker to hold errors that occur
+ *                          in the method call.
+ *
+ * Returns     : -1 - There was an error growing the series.
+ *                0 - Series can hold capacity points.
+ *
+ ************************************************************************/
+int8_t asciip_series_reserve(Asciip_Series *series,
+                             size_t         capacity,
+                             Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_add
+ *
+ * Description : Appends the point (x, y) to the back of the series,
+ *               doubling the capacity when the columns are full.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to add point to.
+ *               x      - x value of point.
+ *               y      - y value of point.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error adding the point.
+ *                0 - Point added to series successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_add(Asciip_Series *series,
+                         double         x,
+                         double         y,
+                         Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_add_many
+ *
+ * Description : Appends count points from the caller's x and y arrays
+ *               with a single capacity reservation and one copy per
+ *               column. The caller's arrays are only read.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to add points to.
+ *               xs     - x values of the points.
+ *               ys     - y values of the points.
+ *               count  - Number of points.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, no points were added.
+ *                0 - Points added to series successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_add_many(Asciip_Series *series,
+                              const double  *xs,
+                              const double  *ys,
+                              size_t         count,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_add_interleaved
+ *
+ * Description : Appends count points from a caller buffer holding
+ *               x0, y0, x1, y1, ... with a single capacity reservation
+ *               and one pass over the buffer.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to add points to.
+ *               xys    - Interleaved values, 2 * count doubles.
+ *               count  - Number of points.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, no points were added.
+ *                0 - Points added to series successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_add_interleaved(Asciip_Series *series,
+                                     const double  *xys,
+                                     size_t         count,
+                                     Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_adopt
+ *
+ * Description : Hands malloc'd x and y arrays of count points over to
+ *               the series. An empty series takes the arrays as its
+ *               columns without copying; otherwise the points are
+ *               appended and the arrays freed. The series owns the
+ *               arrays after the call either way, even on error.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to add points to.
+ *               xs     - malloc'd x values of the points.
+ *               ys     - malloc'd y values of the points.
+ *               count  - Number of points.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, no points were added.
+ *                0 - Points added to series successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_adopt(Asciip_Series *series,
+                           double        *xs,
+                           double        *ys,
+                           size_t         count,
+                           Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_get
+ *
+ * Description : Copies the point at the index passed from the user
+ *               into result.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to read point from.
+ *               index  - Index in series to get point from.
+ *               result - Point to copy the values into.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL         - There was an error getting index from
+ *                              series.
+ *               Asciip_Point - result, holding the point values.
+ *
+ ************************************************************************/
+Asciip_Point *asciip_series_get(const Asciip_Series *series,
+                                size_t               index,
+                                Asciip_Point        *result,
+                                Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_remove_range
+ *
+ * Description : Removes count points starting at index, moving the
+ *               points after the range down with one memmove per
+ *               column.
+ *
+ *               If removed is not NULL the points are appended to it
+ *               first, otherwise they are dropped.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series  - Series to remove points from.
+ *               index   - Index of the first point to remove.
+ *               count   - Number of points to remove.
+ *               removed - Series to append removed points to, NULL
+ *                         to drop them. Must not be series.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, the series is unchanged.
+ *                0 - Points removed successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_remove_range(Asciip_Series *series,
+                                  size_t         index,
+                                  size_t         count,
+                                  Asciip_Series *removed,
+                                  Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_remove_outside
+ *
+ * Description : Removes every point with x outside [lo, hi), including
+ *               points whose x is NaN, compacting the columns in one
+ *               pass.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series  - Series to remove points from.
+ *               lo      - Smallest x kept.
+ *               hi      - x values at or past this are removed.
+ *               removed - Series to append removed points to, NULL
+ *                         to drop them. Must not be series.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, points already visited were
+ *                    removed and the rest kept.
+ *                0 - Points removed successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_remove_outside(Asciip_Series *series,
+                                    double         lo,
+                                    double         hi,
+                                    Asciip_Series *removed,
+                                    Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_remove_if
+ *
+ * Description : Removes every point pred selects, compacting the
+ *               columns in one pass and keeping the order of the rest.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series  - Series to remove points from.
+ *               pred    - Returns non-zero for points to remove.
+ *               context - Passed to every pred call.
+ *               removed - Series to append removed points to, NULL
+ *                         to drop them. Must not be series.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error, points already visited were
+ *                    removed and the rest kept.
+ *                0 - Points removed successfully.
+ *
+ ************************************************************************/
+int8_t asciip_series_remove_if(Asciip_Series     *series,
+                               Asciip_Point_Pred  pred,
+                               void              *context,
+                               Asciip_Series     *removed,
+                               Asciip_Error      *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_from_list
+ *
+ * Description : Creates a new series holding a copy of every point in
+ *               the list, in list order. The list is not modified.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : list   - List to copy points from.
+ *               result - Pointer to store new series in.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL          - There was an error creating the series.
+ *               Asciip_Series - Created series.
+ *
+ ************************************************************************/
+Asciip_Series *asciip_series_from_list(const Asciip_List  *list,
+                                       Asciip_Series     **result,
+                                       Asciip_Error       *error);
+
+
+
+/************************************************************************
+ * Name        : asciip_series_sort
+ *
+ * Description : Stable sort of the series points by x, lowest first,
+ *               using the radix engine in asciip_sort.h. Large series
+ *               are sorted on several threads.
+ *
+ *               Needs scratch space of 16 bytes per point.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to sort.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error sorting, series is unchanged.
+ *                0 - Series sorted.
+ *
+ ************************************************************************/
+int8_t asciip_series_sort(Asciip_Series *series,
+                          Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_lower_bound
+ *
+ * Description : Binary search of a series sorted by x for the first
+ *               point with x not below a value. NaN x values, which
+ *               asciip_series_sort places past +infinity, are never
+ *               below it.
+ *
+ * Parameters  : series - Series sorted by x.
+ *               x      - Value to search for.
+ *
+ * Returns     : Index of the first point with x >= value, or the
+ *               series size if there is none.
+ *
+ ************************************************************************/
+size_t asciip_series_lower_bound(const Asciip_Series *series,
+                                 double               x);
+
+
+/************************************************************************
+ * Name        : asciip_series_range
+ *
+ * Description : Sets a view on the points with x in [lo, hi) of a
+ *               series sorted by x, found by binary search. The view
+ *               points into the series columns; nothing is copied or
+ *               allocated. It stays valid until the series is
+ *               modified. A view can be drawn with asciip_canvas_plot.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series sorted by x.
+ *               lo     - Smallest x in view.
+ *               hi     - x past the view. Empty if not above lo.
+ *               view   - View to set.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, a bound was NaN.
+ *                0 - View set.
+ *
+ ************************************************************************/
+int8_t asciip_series_range(const Asciip_Series *series,
+                           double               lo,
+                           double               hi,
+                           Asciip_Series_View  *view,
+                           Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_series_cursor_begin
+ *
+ * Description : Positions the cursor at the first point of the series.
+ *
+ * Parameters  : series - Series to read.
+ *               cursor - Cursor to position.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+static inline void asciip_series_cursor_begin(const Asciip_Series  *series,
+                                              Asciip_Series_Cursor *cursor)
+{
+   cursor->series = series;
+   cursor->pos = 0;
+}
+
+
+/************************************************************************
+ * Name        : asciip_series_cursor_next_run
+ *
+ * Description : Hands out the next contiguous run of points as
+ *               pointers into the series columns and advances past it.
+ *               The pointers stay valid until the series is modified.
+ *
+ * Parameters  : cursor - Cursor to advance.
+ *               max    - Largest run to return, 0 for no limit.
+ *               xs     - Set to the x values of the run.
+ *               ys     - Set to the y values of the run.
+ *
+ * Returns     : Number of points in the run, 0 at the end of the series.
+ *
+ ************************************************************************/
+static inline size_t asciip_series_cursor_next_run(Asciip_Series_Cursor  *cursor,
+                                                   size_t                 max,
+                                                   const double         **xs,
+                                                   const double         **ys)
+{
+   size_t count = cursor->series->size - cursor->pos;
+
+   if ((max != 0) && (count > max))
+   {
+      count = max;
+   }
+
+   *xs = cursor->series->x + cursor->pos;
+   *ys = cursor->series->y + cursor->pos;
+   cursor->pos += count;
+
+   return count;
+}
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_SERIES__ */
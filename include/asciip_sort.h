@@ -0,0 +1,154 @@
+/************************************************************************
+ *
+ * Interface   : asciip_sort.h
+ *
+ * Description : Contains the sort engine used to order series and lists
+ *               by x.
+ *
+ *               Doubles are mapped to unsigned keys that sort in the
+ *               same order as the values (IEEE-754 total order: -NaN,
+ *               -inf, ..., -0.0, +0.0, ..., +inf, +NaN) and sorted with
+ *               a stable least significant digit radix sort. Large
+ *               inputs are cut into slices run on the shared scheduler;
+ *               each pass builds per-slice digit histograms so the
+ *               parallel scatter stays stable.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_SORT__
+#define __ASCIIP_SORT__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Inputs smaller than this are sorted with a stable insertion sort */
+#define ASCIIP_SORT_SMALL 64
+
+/* Fewest points each sort slice is given before another is added */
+#define ASCIIP_SORT_THREAD_MIN (1 << 18)
+
+/* Upper bound on sort slices */
+#define ASCIIP_SORT_MAX_THREADS 64
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_sort_key
+ *
+ * Description : Maps a double to an unsigned key with the same order.
+ *
+ * Parameters  : value - Value to map.
+ *
+ * Returns     : Key for value.
+ *
+ ************************************************************************/
+static inline uint64_t asciip_sort_key(double value)
+{
+   uint64_t bits;
+
+   memcpy(&bits, &value, sizeof(bits));
+
+   /* Negative values reverse order, positive values move above them */
+   return (bits & ((uint64_t)1 << 63)) ? ~bits : (bits | ((uint64_t)1 << 63));
+}
+
+
+/************************************************************************
+ * Name        : asciip_sort_value
+ *
+ * Description : Maps a key made by asciip_sort_key back to its double.
+ *
+ * Parameters  : key - Key to map.
+ *
+ * Returns     : Value for key.
+ *
+ ************************************************************************/
+static inline double asciip_sort_value(uint64_t key)
+{
+   double value;
+
+   key = (key & ((uint64_t)1 << 63)) ? (key & ~((uint64_t)1 << 63)) : ~key;
+   memcpy(&value, &key, sizeof(value));
+
+   return value;
+}
+
+
+/************************************************************************
+ * Name        : asciip_sort_threads
+ *
+ * Description : Returns the number of slices the engine cuts n keys
+ *               into: one per ASCIIP_SORT_THREAD_MIN keys, bounded by
+ *               the scheduler's workers and ASCIIP_SORT_MAX_THREADS.
+ *
+ * Parameters  : count - Number of keys to sort.
+ *
+ * Returns     : Slice count, at least 1.
+ *
+ ************************************************************************/
+uint32_t asciip_sort_threads(size_t count);
+
+
+/************************************************************************
+ * Name        : asciip_sort_radix
+ *
+ * Description : Stable sort of keys in ascending order, applying the
+ *               same permutation to values.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : keys    - Keys to sort.
+ *               values  - Payload moved with each key.
+ *               count   - Number of keys.
+ *               threads - Slices to cut the keys into, 0 picks
+ *                         asciip_sort_threads.
+ *               error   - Error tracker to hold errors that occur
+ *                         in the method call.
+ *
+ * Returns     : -1 - There was an error sorting, keys are unchanged.
+ *                0 - Keys and values sorted.
+ *
+ ************************************************************************/
+int8_t asciip_sort_radix(uint64_t     *keys,
+                         uint64_t     *values,
+                         size_t        count,
+                         uint32_t      threads,
+                         Asciip_Error *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_SORT__ */
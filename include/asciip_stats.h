@@ -0,0 +1,194 @@
+/************************************************************************
+ *
+ * Interface   : asciip_stats.h
+ *
+ * Description : Contains the bounds and statistics kernel used to
+ *               autoscale plot axes.
+ *
+ *               One pass over each column gives the min, max, sum,
+ *               count and NaN count of the column. On x86 the pass is
+ *               vectorized with SSE2, or AVX2 when the processor
+ *               supports it, and reads the column at memory bandwidth.
+ *               Every other target, and linked lists, use the scalar
+ *               kernel, which gives the same results.
+ *
+ *               Large series are cut into chunks of each column that
+ *               are reduced on the shared scheduler and folded in
+ *               order. The chunks only depend on the series size, so
+ *               the sums are the same on any number of workers.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_STATS__
+#define __ASCIIP_STATS__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Fewest values per chunk, series below twice this are one chunk */
+#define ASCIIP_STATS_CHUNK (1 << 16)
+
+/* Most chunks a series is cut into */
+#define ASCIIP_STATS_MAX_CHUNKS 256
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_axis_stats_t
+{
+   double min;     /* Smallest value, NaN when count is 0 */
+   double max;     /* Largest value, NaN when count is 0 */
+   double sum;     /* Sum of the values */
+   size_t count;   /* Number of values that are not NaN */
+   size_t nans;    /* Number of NaN values */
+
+} Asciip_Axis_Stats;
+
+
+typedef struct _asciip_bounds_t
+{
+   Asciip_Axis_Stats x;   /* Statistics of the x values */
+   Asciip_Axis_Stats y;   /* Statistics of the y values */
+
+} Asciip_Bounds;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+typedef enum _asciip_stats_isa_e
+{
+   ASCIIP_STATS_SCALAR = 0x0,
+   ASCIIP_STATS_SSE2   = 0x1,
+   ASCIIP_STATS_AVX2   = 0x2
+
+} asciip_stats_isa_e;
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_stats_isa
+ *
+ * Description : Returns the widest instruction set the kernel can use
+ *               on this processor.
+ *
+ * Parameters  : void
+ *
+ * Returns     : asciip_stats_isa_e value.
+ *
+ ************************************************************************/
+uint8_t asciip_stats_isa(void);
+
+
+/************************************************************************
+ * Name        : asciip_stats_column
+ *
+ * Description : Computes the statistics of count values in one pass.
+ *               Infinities take part in min, max and sum; NaNs are
+ *               only counted.
+ *
+ * Parameters  : values - Values to reduce.
+ *               count  - Number of values.
+ *               isa    - Instruction set to use, lowered to
+ *                        asciip_stats_isa() if it is not supported.
+ *               result - Statistics of the values.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_stats_column(const double      *values,
+                         size_t             count,
+                         uint8_t            isa,
+                         Asciip_Axis_Stats *result);
+
+
+/************************************************************************
+ * Name        : asciip_stats_merge
+ *
+ * Description : Folds the statistics of one block of values into the
+ *               statistics of another, as if both were reduced
+ *               together.
+ *
+ * Parameters  : result - Statistics to fold into.
+ *               other  - Statistics to fold.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_stats_merge(Asciip_Axis_Stats       *result,
+                        const Asciip_Axis_Stats *other);
+
+
+/************************************************************************
+ * Name        : asciip_stats_series
+ *
+ * Description : Computes the bounds of both columns of a series with
+ *               the fastest supported kernel, in chunks on the shared
+ *               scheduler when it has at least 2 * ASCIIP_STATS_CHUNK
+ *               points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : series - Series to reduce.
+ *               result - Bounds of the series.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, result is unchanged.
+ *                0 - Bounds computed.
+ *
+ ************************************************************************/
+int8_t asciip_stats_series(const Asciip_Series *series,
+                           Asciip_Bounds       *result,
+                           Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_stats_list
+ *
+ * Description : Computes the bounds of both axes of a list with the
+ *               scalar kernel, in one walk of the nodes.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : list   - List to reduce.
+ *               result - Bounds of the list.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, result is unchanged.
+ *                0 - Bounds computed.
+ *
+ ************************************************************************/
+int8_t asciip_stats_list(const Asciip_List *list,
+                         Asciip_Bounds     *result,
+                         Asciip_Error      *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_STATS__ */
@@ -0,0 +1,209 @@
+/************************************************************************
+ *
+ * Interface   : asciip_summary.h
+ *
+ * Description : Contains methods to keep running bounds on a list so
+ *               that a renderer can autoscale without scanning.
+ *
+ *               Adding a point updates the count, sum, min and max in
+ *               O(1). Each axis also keeps a min heap and a max heap of
+ *               its values. Added values are only appended to the heaps
+ *               until a point is removed, so add-only lists never pay
+ *               for them. A removal records the value in a matching
+ *               heap of removed values and pops both heaps while their
+ *               tops agree, so the extents are correct again after
+ *               O(log n) work.
+ *
+ *               The mean of an axis is sum / count.
+ *
+ *               Operations that move whole runs between lists (splice,
+ *               concat, split, merge), and heaps holding more removed
+ *               values than live ones, mark the summary stale. The next
+ *               asciip_summary_get rebuilds it in one pass over the
+ *               list.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_SUMMARY__
+#define __ASCIIP_SUMMARY__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lists.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Removed values a summary holds beyond twice its live values before
+ * it is rebuilt */
+#define ASCIIP_SUMMARY_SLACK 64
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_summary_heap_t
+{
+   double *values;     /* Min heap, then values not yet sifted in */
+   size_t  size;       /* Number of values held */
+   size_t  heaped;     /* Number of leading values in heap order */
+   size_t  capacity;   /* Number of values allocated */
+
+} Asciip_Summary_Heap;
+
+
+typedef struct _asciip_summary_axis_t
+{
+   Asciip_Axis_Stats   stats;     /* Running statistics of the axis */
+   Asciip_Summary_Heap live[2];   /* Values, then negated values */
+   Asciip_Summary_Heap dead[2];   /* Removed values still in live */
+
+} Asciip_Summary_Axis;
+
+
+typedef struct _asciip_summary_t
+{
+   Asciip_Summary_Axis x;       /* Running bounds of the x values */
+   Asciip_Summary_Axis y;       /* Running bounds of the y values */
+   uint8_t             stale;   /* Rebuild from the list before use */
+
+} Asciip_Summary;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_summary_enable
+ *
+ * Description : Starts or stops keeping running bounds on a list.
+ *               Starting builds the summary from the current points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : list   - List to track.
+ *               enable - Non-zero to keep a summary.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, tracking is unchanged.
+ *                0 - Tracking changed.
+ *
+ ************************************************************************/
+int8_t asciip_summary_enable(Asciip_List  *list,
+                             uint8_t       enable,
+                             Asciip_Error *error);
+
+
+/************************************************************************
+ * Name        : asciip_summary_get
+ *
+ * Description : Copies the running bounds of a list into result, as
+ *               asciip_stats_list would compute them. O(1) unless the
+ *               summary is stale.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : list   - Tracked list.
+ *               result - Bounds of the list.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error, the list is not tracked or
+ *                    the summary could not be rebuilt.
+ *                0 - Bounds copied.
+ *
+ ************************************************************************/
+int8_t asciip_summary_get(Asciip_List   *list,
+                          Asciip_Bounds *result,
+                          Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_summary_add
+ *
+ * Description : Records a point added to the tracked list. Does
+ *               nothing if summary is NULL.
+ *
+ * Parameters  : summary - Summary of the list.
+ *               x       - x value of the point.
+ *               y       - y value of the point.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_summary_add(Asciip_Summary *summary,
+                        double          x,
+                        double          y);
+
+
+/************************************************************************
+ * Name        : asciip_summary_remove
+ *
+ * Description : Records a point removed from the tracked list. Does
+ *               nothing if summary is NULL.
+ *
+ * Parameters  : summary - Summary of the list.
+ *               x       - x value of the point.
+ *               y       - y value of the point.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_summary_remove(Asciip_Summary *summary,
+                           double          x,
+                           double          y);
+
+
+/************************************************************************
+ * Name        : asciip_summary_invalidate
+ *
+ * Description : Marks the summary to be rebuilt before its next use.
+ *               Does nothing if summary is NULL.
+ *
+ * Parameters  : summary - Summary of the list.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_summary_invalidate(Asciip_Summary *summary);
+
+
+/************************************************************************
+ * Name        : asciip_summary_destroy
+ *
+ * Description : Releases a summary.
+ *
+ * Parameters  : summary - Summary to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_summary_destroy(Asciip_Summary *summary);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_SUMMARY__ */
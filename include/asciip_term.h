@@ -0,0 +1,188 @@
+/************************************************************************
+ *
+ * Interface   : asciip_term.h
+ *
+ * Description : Contains methods to put canvas frames on a terminal,
+ *               sending only the cells that changed.
+ *
+ *               The terminal keeps the glyph last sent for every cell.
+ *               Each frame is compared against it cell by cell and
+ *               only changed cells are sent, each run preceded by an
+ *               ANSI cursor move. Short gaps between changes on a row
+ *               are bridged by resending the unchanged glyphs when
+ *               that is fewer bytes than the move. The frame is built
+ *               in a buffer sized for the worst case when the terminal
+ *               is created and sent with a single write, so a frame
+ *               that changes nothing costs no system call at all.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+#ifndef __ASCIIP_TERM__
+#define __ASCIIP_TERM__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_canvas.h"
+#include "asciip_lists.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Longest cursor move sent, ESC [ row ; col H with 5 digit numbers */
+#define ASCIIP_TERM_MOVE_MAX 14
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_term_t
+{
+   int       fd;             /* File descriptor frames are written to */
+   size_t    width;          /* Columns of the frames */
+   size_t    height;         /* Rows of the frames */
+   size_t    top;            /* Terminal row of the first frame row, from 1 */
+   uint32_t *shown;          /* Glyph last sent per cell, row major */
+   uint8_t   valid;          /* Cleared when the screen must be redrawn */
+   char     *buffer;         /* Frame being sent */
+   size_t    capacity;       /* Bytes the buffer holds */
+   uint64_t  frames;         /* Frames drawn */
+   size_t    bytes;          /* Bytes sent for the last frame */
+   uint32_t  writes;         /* Write calls made for the last frame */
+   uint64_t  total_bytes;    /* Bytes sent for every frame */
+   uint64_t  total_writes;   /* Write calls made for every frame */
+
+} Asciip_Term;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_term_init
+ *
+ * Description : Initializes output of width by height frames to a file
+ *               descriptor, allocating everything a frame needs. The
+ *               first frame redraws every cell.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : fd     - File descriptor to write to.
+ *               width  - Number of columns, 1 to 65535.
+ *               height - Number of rows, 1 to 65535.
+ *               result - Pointer to store new terminal in.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL        - There was an error creating the terminal.
+ *               Asciip_Term - Created terminal.
+ *
+ ************************************************************************/
+Asciip_Term *asciip_term_init(int            fd,
+                              size_t         width,
+                              size_t         height,
+                              Asciip_Term  **result,
+                              Asciip_Error  *error);
+
+
+/************************************************************************
+ * Name        : asciip_term_destroy
+ *
+ * Description : Releases the terminal. The file descriptor is not
+ *               closed.
+ *
+ * Parameters  : term - Terminal to destroy, may be NULL.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_term_destroy(Asciip_Term *term);
+
+
+/************************************************************************
+ * Name        : asciip_term_invalidate
+ *
+ * Description : Forgets what is on screen, so the next frame redraws
+ *               every cell, such as after the terminal was cleared.
+ *
+ * Parameters  : term - Terminal to invalidate.
+ *
+ * Returns     : void
+ *
+ ************************************************************************/
+void asciip_term_invalidate(Asciip_Term *term);
+
+
+/************************************************************************
+ * Name        : asciip_term_diff
+ *
+ * Description : Builds the bytes that bring the screen from the last
+ *               frame to the canvas, and records the canvas as shown.
+ *               Nothing is written.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : term   - Terminal to update.
+ *               canvas - Canvas of the terminal's width and height.
+ *               length - Pointer to store the byte count in.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : NULL         - There was an error, the canvas size did
+ *                              not match.
+ *               const char * - Bytes to send, owned by the terminal.
+ *
+ ************************************************************************/
+const char *asciip_term_diff(Asciip_Term         *term,
+                             const Asciip_Canvas *canvas,
+                             size_t              *length,
+                             Asciip_Error        *error);
+
+
+/************************************************************************
+ * Name        : asciip_term_draw
+ *
+ * Description : Sends the changes from the last frame to the canvas
+ *               with one write, retried only if the write is partial.
+ *               Updates the byte and write counts.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ *
+ * Parameters  : term   - Terminal to draw on.
+ *               canvas - Canvas of the terminal's width and height.
+ *               error  - Error tracker to hold errors that occur
+ *                        in the method call.
+ *
+ * Returns     : -1 - There was an error building or writing the
+ *                    frame. The next frame redraws every cell.
+ *                0 - Frame drawn.
+ *
+ ************************************************************************/
+int8_t asciip_term_draw(Asciip_Term         *term,
+                        const Asciip_Canvas *canvas,
+                        Asciip_Error        *error);
+
+#ifdef __cplusplus
+} /* End extern */
+#endif
+
+#endif /* End __ASCIIP_TERM__ */
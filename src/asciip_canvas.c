@@ -0,0 +1,835 @@
+/************************************************************************
+ *
+ * File        : asciip_canvas.c
+ *
+ * Description : Contains methods to rasterize series onto a character
+ *               grid.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_canvas.h"
+#include "asciip_sched.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_canvas_job_t
+{
+   Asciip_Canvas *canvas;   /* Canvas to draw on */
+   const double  *xs;       /* x values of the points */
+   const double  *ys;       /* y values of the points */
+   uint8_t        style;    /* asciip_canvas_style_e value */
+   char           mark;     /* Character to draw with */
+
+} Asciip_Canvas_Job;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/* Braille dot bit for each dot row and column of a cell */
+static const uint8_t asciip_canvas_braille_bits[4][2] =
+{
+   { 0x01, 0x08 },
+   { 0x02, 0x10 },
+   { 0x04, 0x20 },
+   { 0x40, 0x80 }
+};
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_canvas_cell
+ *
+ * Description : Turns a position in cell space, already known to be
+ *               inside [0, size], into a cell. The far edge belongs to
+ *               the last cell.
+ ************************************************************************/
+static inline long asciip_canvas_cell(double position,
+                                      size_t size)
+{
+   size_t cell = (size_t)position;
+
+   return (long)((cell < size) ? cell : size - 1);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_clip
+ *
+ * Description : Liang-Barsky clip of the segment (x0, y0) - (x1, y1) in
+ *               cell space to [0, width] by [0, height]. Returns 0 if
+ *               no part of the segment is inside.
+ ************************************************************************/
+static uint8_t asciip_canvas_clip(double *x0,
+                                  double *y0,
+                                  double *x1,
+                                  double *y1,
+                                  double  width,
+                                  double  height)
+{
+   double dx = *x1 - *x0;
+   double dy = *y1 - *y0;
+   double p[4];
+   double q[4];
+   double t0 = 0.0;
+   double t1 = 1.0;
+   double t;
+   uint8_t edge;
+
+   if (!isfinite(dx) || !isfinite(dy))
+   {
+      return 0;
+   }
+
+   p[0] = -dx;  q[0] = *x0;
+   p[1] = dx;   q[1] = width - *x0;
+   p[2] = -dy;  q[2] = *y0;
+   p[3] = dy;   q[3] = height - *y0;
+
+   for (edge = 0; edge < 4; edge++)
+   {
+      if (!(p[edge] < 0.0) && !(p[edge] > 0.0))
+      {
+         /* Parallel to this edge, inside only if on its inner side */
+         if (q[edge] < 0.0)
+         {
+            return 0;
+         }
+         continue;
+      }
+
+      t = q[edge] / p[edge];
+      if (p[edge] < 0.0)
+      {
+         t0 = (t > t0) ? t : t0;
+      }
+      else
+      {
+         t1 = (t < t1) ? t : t1;
+      }
+   }
+
+   if (t0 > t1)
+   {
+      return 0;
+   }
+
+   *x1 = *x0 + t1 * dx;
+   *y1 = *y0 + t1 * dy;
+   *x0 = *x0 + t0 * dx;
+   *y0 = *y0 + t0 * dy;
+
+   /* Rounding can leave an endpoint a hair outside */
+   *x0 = (*x0 < 0.0) ? 0.0 : ((*x0 > width) ? width : *x0);
+   *x1 = (*x1 < 0.0) ? 0.0 : ((*x1 > width) ? width : *x1);
+   *y0 = (*y0 < 0.0) ? 0.0 : ((*y0 > height) ? height : *y0);
+   *y1 = (*y1 < 0.0) ? 0.0 : ((*y1 > height) ? height : *y1);
+
+   return 1;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_set
+ *
+ * Description : Marks one pixel of the grid: a whole cell in text
+ *               mode, one dot of a cell in braille mode. Chunks of a
+ *               plot may mark the same cell at once, so cells are
+ *               stored and dots ORed atomically; a dot already set,
+ *               the usual case in a dense plot, is only read.
+ ************************************************************************/
+static inline void asciip_canvas_set(Asciip_Canvas *canvas,
+                                     long           col,
+                                     long           row,
+                                     char           mark)
+{
+   uint8_t *dotp;
+   uint8_t bit;
+
+   if (canvas->mode == ASCIIP_CANVAS_BRAILLE)
+   {
+      dotp = &canvas->dots[(size_t)(row >> 2) * canvas->width + (size_t)(col >> 1)];
+      bit = asciip_canvas_braille_bits[row & 3][col & 1];
+      if ((__atomic_load_n(dotp, __ATOMIC_RELAXED) & bit) == 0)
+      {
+         __atomic_fetch_or(dotp, bit, __ATOMIC_RELAXED);
+      }
+   }
+   else
+   {
+      __atomic_store_n(&canvas->cells[(size_t)row * canvas->stride + (size_t)col], mark, __ATOMIC_RELAXED);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_line
+ *
+ * Description : Draws the pixels from (x0, y0) to (x1, y1), both
+ *               inside the grid, with integer Bresenham stepping.
+ ************************************************************************/
+static void asciip_canvas_line(Asciip_Canvas *canvas,
+                               long           x0,
+                               long           y0,
+                               long           x1,
+                               long           y1,
+                               char           mark)
+{
+   long dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+   long dy = (y1 > y0) ? y0 - y1 : y1 - y0;
+   long sx = (x0 < x1) ? 1 : -1;
+   long sy = (y0 < y1) ? 1 : -1;
+   long err = dx + dy;
+   long e2;
+
+   for (;;)
+   {
+      asciip_canvas_set(canvas, x0, y0, mark);
+      if ((x0 == x1) && (y0 == y1))
+      {
+         break;
+      }
+
+      e2 = 2 * err;
+      if (e2 >= dy)
+      {
+         err += dy;
+         x0 += sx;
+      }
+      if (e2 <= dx)
+      {
+         err += dx;
+         y0 += sy;
+      }
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_segment
+ *
+ * Description : Draws the part of the segment between two positions in
+ *               cell space that lies inside the plot area.
+ ************************************************************************/
+static void asciip_canvas_segment(Asciip_Canvas *canvas,
+                                  double         fx0,
+                                  double         fy0,
+                                  double         fx1,
+                                  double         fy1,
+                                  char           mark)
+{
+   double width = (double)canvas->grid_width;
+   double height = (double)canvas->grid_height;
+
+   /* Both ends past the same edge, the usual case when zoomed in */
+   if (((fx0 < 0.0) && (fx1 < 0.0)) || ((fx0 > width) && (fx1 > width)) ||
+       ((fy0 < 0.0) && (fy1 < 0.0)) || ((fy0 > height) && (fy1 > height)))
+   {
+      return;
+   }
+
+   if (!asciip_canvas_clip(&fx0, &fy0, &fx1, &fy1, width, height))
+   {
+      return;
+   }
+
+   asciip_canvas_line(canvas,
+                      asciip_canvas_cell(fx0, canvas->grid_width), asciip_canvas_cell(fy0, canvas->grid_height),
+                      asciip_canvas_cell(fx1, canvas->grid_width), asciip_canvas_cell(fy1, canvas->grid_height),
+                      mark);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_points
+ *
+ * Description : Rasterizes count points in one pass.
+ ************************************************************************/
+static void asciip_canvas_points(Asciip_Canvas *canvas,
+                                 const double  *xs,
+                                 const double  *ys,
+                                 size_t         count,
+                                 uint8_t        style,
+                                 char           mark)
+{
+   double width = (double)canvas->grid_width;
+   double height = (double)canvas->grid_height;
+   double x_min = canvas->x_min;
+   double y_max = canvas->y_max;
+   double x_scale = canvas->x_scale;
+   double y_scale = canvas->y_scale;
+   double fx;
+   double fy;
+   double prev_fx = NAN;
+   double prev_fy = NAN;
+   long col;
+   long row;
+   long prev_col = -1;
+   long prev_row = -1;
+   size_t ind;
+
+   for (ind = 0; ind < count; ind++)
+   {
+      /* Grid space: columns from the left edge, rows from the top edge */
+      fx = (xs[ind] - x_min) * x_scale;
+      fy = (y_max - ys[ind]) * y_scale;
+
+      if ((fx >= 0.0) && (fx <= width) && (fy >= 0.0) && (fy <= height))
+      {
+         col = asciip_canvas_cell(fx, canvas->grid_width);
+         row = asciip_canvas_cell(fy, canvas->grid_height);
+
+         /* Dense series repeat cells, a repeat needs no drawing */
+         if ((style != ASCIIP_CANVAS_LINES) || (prev_col < 0))
+         {
+            asciip_canvas_set(canvas, col, row, mark);
+            if (style == ASCIIP_CANVAS_LINES)
+            {
+               /* Coming back into the plot area draws the clipped part */
+               if (!isnan(prev_fx + prev_fy))
+               {
+                  asciip_canvas_segment(canvas, prev_fx, prev_fy, fx, fy, mark);
+               }
+            }
+         }
+         else if ((col != prev_col) || (row != prev_row))
+         {
+            asciip_canvas_line(canvas, prev_col, prev_row, col, row, mark);
+         }
+      }
+      else
+      {
+         col = -1;
+         row = -1;
+         if ((style == ASCIIP_CANVAS_LINES) && !isnan(fx + fy + prev_fx + prev_fy))
+         {
+            asciip_canvas_segment(canvas, prev_fx, prev_fy, fx, fy, mark);
+         }
+      }
+
+      prev_fx = fx;
+      prev_fy = fy;
+      prev_col = col;
+      prev_row = row;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_chunk
+ *
+ * Description : Scheduler body, rasterizes points [begin, end) of a
+ *               plot. Starting from the point before joins the line to
+ *               the chunk before; marking that point again changes
+ *               nothing.
+ ************************************************************************/
+static void asciip_canvas_chunk(size_t  begin,
+                                size_t  end,
+                                void   *context)
+{
+   const Asciip_Canvas_Job *job = context;
+
+   begin -= (begin > 0);
+   asciip_canvas_points(job->canvas, job->xs + begin, job->ys + begin, end - begin, job->style, job->mark);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_init
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Initializes a blank canvas of width by height cells.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Canvas *asciip_canvas_init(size_t          width,
+                                  size_t          height,
+                                  Asciip_Canvas **result,
+                                  Asciip_Error   *error)
+{
+   Asciip_Canvas *canvas;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   /* Braille rows take up to 4 bytes a cell plus the newline */
+   if ((width == 0) || (height == 0) || (height > SIZE_MAX / 4) || (width >= SIZE_MAX / 4 / height - 1))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_canvas_init: Bad canvas size.");
+      return NULL;
+   }
+
+   if ((canvas = malloc(sizeof(Asciip_Canvas))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_canvas_init: Could not malloc canvas.");
+      return NULL;
+   }
+
+   canvas->width = width;
+   canvas->height = height;
+   canvas->stride = width + 1;
+   canvas->mode = ASCIIP_CANVAS_TEXT;
+   canvas->grid_width = width;
+   canvas->grid_height = height;
+   canvas->dots = NULL;
+   canvas->frame = NULL;
+   if ((canvas->cells = malloc(canvas->stride * height)) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_canvas_init: Could not malloc cells.");
+      free(canvas);
+      return NULL;
+   }
+
+   asciip_canvas_clear(canvas);
+   asciip_canvas_set_range(canvas, 0.0, 1.0, 0.0, 1.0, NULL);
+
+   *result = canvas;
+   return canvas;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_destroy
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Releases the canvas and its cells.
+ ************************************************************************/
+void asciip_canvas_destroy(Asciip_Canvas *canvas)
+{
+   if (canvas == NULL)
+   {
+      return;
+   }
+
+   free(canvas->cells);
+   free(canvas->dots);
+   free(canvas->frame);
+   free(canvas);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_clear
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Blanks every cell.
+ ************************************************************************/
+void asciip_canvas_clear(Asciip_Canvas *canvas)
+{
+   size_t row;
+
+   memset(canvas->cells, ' ', canvas->stride * canvas->height);
+   for (row = 0; row < canvas->height; row++)
+   {
+      canvas->cells[row * canvas->stride + canvas->width] = '\n';
+   }
+
+   if (canvas->dots != NULL)
+   {
+      memset(canvas->dots, 0, canvas->width * canvas->height);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_set_range
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Sets the values at the edges of the plot area.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_set_range(Asciip_Canvas *canvas,
+                               double         x_min,
+                               double         x_max,
+                               double         y_min,
+                               double         y_max,
+                               Asciip_Error  *error)
+{
+   if (canvas == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_set_range: Canvas was NULL.");
+      return -1;
+   }
+
+   if (!isfinite(x_max - x_min) || !isfinite(y_max - y_min) || !(x_max > x_min) || !(y_max > y_min))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_canvas_set_range: Range was empty.");
+      return -1;
+   }
+
+   canvas->x_min = x_min;
+   canvas->x_max = x_max;
+   canvas->y_min = y_min;
+   canvas->y_max = y_max;
+   canvas->x_scale = (double)canvas->grid_width / (x_max - x_min);
+   canvas->y_scale = (double)canvas->grid_height / (y_max - y_min);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_extent
+ *
+ * Description : Turns the statistics of one axis into a range that
+ *               asciip_canvas_set_range accepts. An infinite end is
+ *               replaced by the other end, a single value is widened
+ *               by 0.5, or a little more where 0.5 is lost to
+ *               rounding, and a span too wide for a double is cut down
+ *               around its midpoint.
+ ************************************************************************/
+static void asciip_canvas_extent(const Asciip_Axis_Stats *axis,
+                                 double                  *low,
+                                 double                  *high)
+{
+   double pad;
+   double mid;
+
+   *low = isfinite(axis->min) ? axis->min : axis->max;
+   *high = isfinite(axis->max) ? axis->max : axis->min;
+
+   if ((axis->count == 0) || !isfinite(*low) || !isfinite(*high))
+   {
+      *low = 0.0;
+      *high = 1.0;
+      return;
+   }
+
+   if (!(*high > *low))
+   {
+      pad = fabs(*low) * 0x1p-20;
+      pad = (pad > 0.5) ? pad : 0.5;
+      *low = (*low - pad > -DBL_MAX) ? *low - pad : -DBL_MAX;
+      *high = (*high + pad < DBL_MAX) ? *high + pad : DBL_MAX;
+   }
+
+   /* Ends of opposite sign near the limits, keep a span of 2^1023 */
+   if (!isfinite(*high - *low))
+   {
+      mid = *low * 0.5 + *high * 0.5;
+      *low = mid - 0x1p1022;
+      *high = mid + 0x1p1022;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_fit
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Sets the range to the finite extents in bounds.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_fit(Asciip_Canvas       *canvas,
+                         const Asciip_Bounds *bounds,
+                         Asciip_Error        *error)
+{
+   double low[2];
+   double high[2];
+
+   if ((canvas == NULL) || (bounds == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_fit: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_canvas_extent(&bounds->x, &low[0], &high[0]);
+   asciip_canvas_extent(&bounds->y, &low[1], &high[1]);
+
+   return asciip_canvas_set_range(canvas, low[0], high[0], low[1], high[1], error);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_plot
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Rasterizes count points from x and y arrays in one
+ *               pass, in chunks on the shared scheduler when there are
+ *               many.
+ ************************************************************************/
+void asciip_canvas_plot(Asciip_Canvas *canvas,
+                        const double  *xs,
+                        const double  *ys,
+                        size_t         count,
+                        uint8_t        style,
+                        char           mark)
+{
+   Asciip_Canvas_Job job;
+
+   if (count < 2 * ASCIIP_CANVAS_CHUNK)
+   {
+      asciip_canvas_points(canvas, xs, ys, count, style, mark);
+      return;
+   }
+
+   job.canvas = canvas;
+   job.xs = xs;
+   job.ys = ys;
+   job.style = style;
+   job.mark = mark;
+   asciip_sched_parallel_for(0, count, ASCIIP_CANVAS_CHUNK, asciip_canvas_chunk, &job, NULL);
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_series
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Rasterizes every point of a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_draw_series(Asciip_Canvas       *canvas,
+                                 const Asciip_Series *series,
+                                 uint8_t              style,
+                                 char                 mark,
+                                 Asciip_Error        *error)
+{
+   if ((canvas == NULL) || (series == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_draw_series: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_canvas_plot(canvas, series->x, series->y, series->size, style, mark);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_list
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Rasterizes every point of a list in batches. Each batch
+ *               after the first starts with the last point of the one
+ *               before, so lines join across batches.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_draw_list(Asciip_Canvas     *canvas,
+                               const Asciip_List *list,
+                               uint8_t            style,
+                               char               mark,
+                               Asciip_Error      *error)
+{
+   Asciip_List_Iter iter;
+   double xs[ASCIIP_CANVAS_LIST_BATCH + 1];
+   double ys[ASCIIP_CANVAS_LIST_BATCH + 1];
+   size_t carried = 0;
+   size_t read;
+
+   if ((canvas == NULL) || (list == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_draw_list: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_list_iter_begin(list, &iter);
+   while ((read = asciip_list_iter_read(&iter, xs + carried, ys + carried, ASCIIP_CANVAS_LIST_BATCH)) > 0)
+   {
+      asciip_canvas_plot(canvas, xs, ys, carried + read, style, mark);
+
+      xs[0] = xs[carried + read - 1];
+      ys[0] = ys[carried + read - 1];
+      carried = 1;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_draw_ring
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Rasterizes both runs of a ring, with the last point of
+ *               the first run and the first of the second drawn between
+ *               them so that lines join across the wrap.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_draw_ring(Asciip_Canvas     *canvas,
+                               const Asciip_Ring *ring,
+                               uint8_t            style,
+                               char               mark,
+                               Asciip_Error      *error)
+{
+   Asciip_Series_View runs[2];
+   double xs[2];
+   double ys[2];
+
+   if ((canvas == NULL) || (ring == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_draw_ring: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_ring_runs(ring, runs);
+   asciip_canvas_plot(canvas, runs[0].x, runs[0].y, runs[0].size, style, mark);
+   if (runs[1].size > 0)
+   {
+      xs[0] = runs[0].x[runs[0].size - 1];
+      ys[0] = runs[0].y[runs[0].size - 1];
+      xs[1] = runs[1].x[0];
+      ys[1] = runs[1].y[0];
+      asciip_canvas_plot(canvas, xs, ys, 2, style, mark);
+      asciip_canvas_plot(canvas, runs[1].x, runs[1].y, runs[1].size, style, mark);
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_set_mode
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Switches between whole-cell characters and braille
+ *               dots, keeping the range.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_set_mode(Asciip_Canvas *canvas,
+                              uint8_t        mode,
+                              Asciip_Error  *error)
+{
+   if (canvas == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_set_mode: Canvas was NULL.");
+      return -1;
+   }
+
+   if (mode == ASCIIP_CANVAS_BRAILLE)
+   {
+      /* Each cell holds a one byte dot mask and encodes to at most 3 bytes */
+      if ((canvas->dots == NULL) &&
+          ((canvas->dots = malloc(canvas->width * canvas->height)) == NULL))
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_canvas_set_mode: Could not malloc dots.");
+         return -1;
+      }
+
+      if ((canvas->frame == NULL) &&
+          ((canvas->frame = malloc((3 * canvas->width + 1) * canvas->height)) == NULL))
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_canvas_set_mode: Could not malloc frame.");
+         return -1;
+      }
+
+      canvas->grid_width = 2 * canvas->width;
+      canvas->grid_height = 4 * canvas->height;
+   }
+   else
+   {
+      mode = ASCIIP_CANVAS_TEXT;
+      canvas->grid_width = canvas->width;
+      canvas->grid_height = canvas->height;
+   }
+
+   canvas->mode = mode;
+   asciip_canvas_clear(canvas);
+   asciip_canvas_set_range(canvas, canvas->x_min, canvas->x_max, canvas->y_min, canvas->y_max, NULL);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_frame
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Returns the printable frame. Braille dot masks are
+ *               encoded to UTF-8 here and nowhere else.
+ ************************************************************************/
+const char *asciip_canvas_frame(Asciip_Canvas *canvas,
+                                size_t        *length)
+{
+   const uint8_t *dots;
+   char *out;
+   uint8_t mask;
+   size_t row;
+   size_t col;
+
+   if (canvas->mode != ASCIIP_CANVAS_BRAILLE)
+   {
+      *length = canvas->stride * canvas->height;
+      return canvas->cells;
+   }
+
+   /* U+2800 + mask is E2, A0 | (mask >> 6), 80 | (mask & 3F) in UTF-8 */
+   out = canvas->frame;
+   dots = canvas->dots;
+   for (row = 0; row < canvas->height; row++)
+   {
+      for (col = 0; col < canvas->width; col++)
+      {
+         if ((mask = *dots++) == 0)
+         {
+            *out++ = ' ';
+            continue;
+         }
+
+         *out++ = (char)0xE2;
+         *out++ = (char)(0xA0 | (mask >> 6));
+         *out++ = (char)(0x80 | (mask & 0x3F));
+      }
+      *out++ = '\n';
+   }
+
+   *length = (size_t)(out - canvas->frame);
+   return canvas->frame;
+}
+
+/************************************************************************
+ * Name        : asciip_canvas_print
+ *
+ * See         : asciip_canvas.h
+ *
+ * Description : Writes every row of the canvas with a single fwrite.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_canvas_print(Asciip_Canvas *canvas,
+                           FILE          *stream,
+                           Asciip_Error  *error)
+{
+   const char *frame;
+   size_t bytes;
+
+   if ((canvas == NULL) || (stream == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_canvas_print: One of the parameters were NULL.");
+      return -1;
+   }
+
+   frame = asciip_canvas_frame(canvas, &bytes);
+   if (fwrite(frame, 1, bytes, stream) != bytes)
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_canvas_print: Could not write canvas.");
+      return -1;
+   }
+
+   return 0;
+}
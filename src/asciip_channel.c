@@ -0,0 +1,227 @@
+/************************************************************************
+ *
+ * File        : asciip_channel.c
+ *
+ * Description : Contains methods to pass buffers between two threads
+ *               through a bounded queue.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_channel.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_channel_init
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Initializes an open, empty channel holding up to
+ *               capacity items.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Channel *asciip_channel_init(size_t            capacity,
+                                    Asciip_Channel  **result,
+                                    Asciip_Error     *error)
+{
+   Asciip_Channel *channel;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_channel_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((capacity == 0) || (capacity > SIZE_MAX / sizeof(void *)))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_channel_init: Bad channel capacity.");
+      return NULL;
+   }
+
+   if ((channel = malloc(sizeof(Asciip_Channel))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_channel_init: Could not malloc channel.");
+      return NULL;
+   }
+
+   if ((channel->items = malloc(capacity * sizeof(void *))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_channel_init: Could not malloc slots.");
+      free(channel);
+      return NULL;
+   }
+
+   channel->capacity = capacity;
+   channel->head = 0;
+   channel->size = 0;
+   channel->closed = 0;
+   pthread_mutex_init(&channel->lock, NULL);
+   pthread_cond_init(&channel->readable, NULL);
+   pthread_cond_init(&channel->writable, NULL);
+
+   *result = channel;
+   return channel;
+}
+
+/************************************************************************
+ * Name        : asciip_channel_destroy
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Releases the channel.
+ ************************************************************************/
+void asciip_channel_destroy(Asciip_Channel *channel)
+{
+   if (channel == NULL)
+   {
+      return;
+   }
+
+   pthread_mutex_destroy(&channel->lock);
+   pthread_cond_destroy(&channel->readable);
+   pthread_cond_destroy(&channel->writable);
+   free(channel->items);
+   free(channel);
+}
+
+/************************************************************************
+ * Name        : asciip_channel_push
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Adds an item, waiting while the channel is full.
+ ************************************************************************/
+int8_t asciip_channel_push(Asciip_Channel *channel,
+                           void           *item)
+{
+   size_t tail;
+
+   pthread_mutex_lock(&channel->lock);
+   while ((channel->size == channel->capacity) && !channel->closed)
+   {
+      pthread_cond_wait(&channel->writable, &channel->lock);
+   }
+
+   if (channel->closed)
+   {
+      pthread_mutex_unlock(&channel->lock);
+      return -1;
+   }
+
+   tail = channel->head + channel->size;
+   channel->items[(tail < channel->capacity) ? tail : tail - channel->capacity] = item;
+   channel->size++;
+   pthread_cond_signal(&channel->readable);
+   pthread_mutex_unlock(&channel->lock);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_channel_take
+ *
+ * Description : Removes the oldest item of a locked, non-empty channel.
+ ************************************************************************/
+static void *asciip_channel_take(Asciip_Channel *channel)
+{
+   void *item = channel->items[channel->head];
+
+   channel->head = (channel->head + 1 < channel->capacity) ? channel->head + 1 : 0;
+   channel->size--;
+   pthread_cond_signal(&channel->writable);
+
+   return item;
+}
+
+/************************************************************************
+ * Name        : asciip_channel_pop
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Removes the oldest item, waiting while the channel is
+ *               empty and open.
+ ************************************************************************/
+void *asciip_channel_pop(Asciip_Channel *channel)
+{
+   void *item = NULL;
+
+   pthread_mutex_lock(&channel->lock);
+   while ((channel->size == 0) && !channel->closed)
+   {
+      pthread_cond_wait(&channel->readable, &channel->lock);
+   }
+
+   if (channel->size > 0)
+   {
+      item = asciip_channel_take(channel);
+   }
+   pthread_mutex_unlock(&channel->lock);
+
+   return item;
+}
+
+/************************************************************************
+ * Name        : asciip_channel_try_pop
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Removes the oldest item if there is one, without
+ *               waiting.
+ ************************************************************************/
+void *asciip_channel_try_pop(Asciip_Channel *channel)
+{
+   void *item = NULL;
+
+   pthread_mutex_lock(&channel->lock);
+   if (channel->size > 0)
+   {
+      item = asciip_channel_take(channel);
+   }
+   pthread_mutex_unlock(&channel->lock);
+
+   return item;
+}
+
+/************************************************************************
+ * Name        : asciip_channel_close
+ *
+ * See         : asciip_channel.h
+ *
+ * Description : Marks that no more items will be pushed and wakes every
+ *               waiting thread.
+ ************************************************************************/
+void asciip_channel_close(Asciip_Channel *channel)
+{
+   pthread_mutex_lock(&channel->lock);
+   channel->closed = 1;
+   pthread_cond_broadcast(&channel->readable);
+   pthread_cond_broadcast(&channel->writable);
+   pthread_mutex_unlock(&channel->lock);
+}
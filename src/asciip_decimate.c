@@ -0,0 +1,555 @@
+/************************************************************************
+ *
+ * File        : asciip_decimate.c
+ *
+ * Description : Contains methods to reduce a series to a few points per
+ *               column before it is rendered.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_decimate.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_decimate_same
+ *
+ * Description : Checks if two points are the same point.
+ ************************************************************************/
+static inline uint8_t asciip_decimate_same(double x0,
+                                           double y0,
+                                           double x1,
+                                           double y1)
+{
+   return !(x0 < x1) && !(x1 < x0) && !(y0 < y1) && !(y1 < y0);
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_emit
+ *
+ * Description : Appends one point to the output, skipping a repeat of
+ *               the point appended before it.
+ ************************************************************************/
+static int8_t asciip_decimate_emit(Asciip_Series *result,
+                                   size_t         start,
+                                   double         x,
+                                   double         y,
+                                   Asciip_Error  *error)
+{
+   if ((result->size > start) &&
+       asciip_decimate_same(result->x[result->size - 1], result->y[result->size - 1], x, y))
+   {
+      return 0;
+   }
+
+   return asciip_series_add(result, x, y, error);
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_flush
+ *
+ * Description : Merges a run of points into its bucket and empties the
+ *               run.
+ ************************************************************************/
+static void asciip_decimate_flush(Asciip_Decimate        *decimate,
+                                  size_t                  pos,
+                                  Asciip_Decimate_Bucket *run)
+{
+   Asciip_Decimate_Bucket *bucket;
+
+   if (run->count == 0)
+   {
+      return;
+   }
+
+   bucket = &decimate->bucket[pos];
+   if ((bucket->count == 0) || (run->min_y < bucket->min_y))
+   {
+      bucket->min_x = run->min_x;
+      bucket->min_y = run->min_y;
+   }
+   if ((bucket->count == 0) || (run->max_y > bucket->max_y))
+   {
+      bucket->max_x = run->max_x;
+      bucket->max_y = run->max_y;
+   }
+   bucket->sum_x += run->sum_x;
+   bucket->sum_y += run->sum_y;
+   bucket->count += run->count;
+   decimate->count += run->count;
+   run->count = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_minmax
+ *
+ * Description : Appends both extremes of every bucket, in x order.
+ ************************************************************************/
+static int8_t asciip_decimate_minmax(const Asciip_Decimate *decimate,
+                                     Asciip_Series         *result,
+                                     size_t                 start,
+                                     Asciip_Error          *error)
+{
+   const Asciip_Decimate_Bucket *bucket;
+   size_t ind;
+   int8_t status = 0;
+
+   for (ind = 0; (ind < decimate->buckets) && (status == 0); ind++)
+   {
+      bucket = &decimate->bucket[ind];
+      if (bucket->count == 0)
+      {
+         continue;
+      }
+
+      if (bucket->min_x < bucket->max_x)
+      {
+         status = asciip_decimate_emit(result, start, bucket->min_x, bucket->min_y, error);
+         status = (status == 0) ? asciip_decimate_emit(result, start, bucket->max_x, bucket->max_y, error) : status;
+      }
+      else
+      {
+         status = asciip_decimate_emit(result, start, bucket->max_x, bucket->max_y, error);
+         status = (status == 0) ? asciip_decimate_emit(result, start, bucket->min_x, bucket->min_y, error) : status;
+      }
+   }
+
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_lttb
+ *
+ * Description : Appends the leftmost point, one extreme per bucket and
+ *               the rightmost point. Each bucket keeps whichever of its
+ *               extremes makes the larger triangle with the point kept
+ *               before it and the mean of the next non-empty bucket.
+ ************************************************************************/
+static int8_t asciip_decimate_lttb(const Asciip_Decimate *decimate,
+                                   Asciip_Series         *result,
+                                   size_t                 start,
+                                   Asciip_Error          *error)
+{
+   const Asciip_Decimate_Bucket *bucket;
+   const Asciip_Decimate_Bucket *next;
+   double ax = decimate->first[0];
+   double ay = decimate->first[1];
+   double cx;
+   double cy;
+   double low;
+   double high;
+   size_t ind;
+   size_t look = 0;
+
+   if (asciip_decimate_emit(result, start, ax, ay, error) != 0)
+   {
+      return -1;
+   }
+
+   for (ind = 0; ind < decimate->buckets; ind++)
+   {
+      bucket = &decimate->bucket[ind];
+      if (bucket->count == 0)
+      {
+         continue;
+      }
+
+      /* The third corner is the mean of the next bucket, or the end */
+      look = (look > ind) ? look : ind + 1;
+      while ((look < decimate->buckets) && (decimate->bucket[look].count == 0))
+      {
+         look++;
+      }
+      if (look < decimate->buckets)
+      {
+         next = &decimate->bucket[look];
+         cx = next->sum_x / (double)next->count;
+         cy = next->sum_y / (double)next->count;
+      }
+      else
+      {
+         cx = decimate->last[0];
+         cy = decimate->last[1];
+      }
+
+      low = fabs((bucket->min_x - ax) * (cy - ay) - (cx - ax) * (bucket->min_y - ay));
+      high = fabs((bucket->max_x - ax) * (cy - ay) - (cx - ax) * (bucket->max_y - ay));
+      if (low > high)
+      {
+         ax = bucket->min_x;
+         ay = bucket->min_y;
+      }
+      else
+      {
+         ax = bucket->max_x;
+         ay = bucket->max_y;
+      }
+
+      if (asciip_decimate_emit(result, start, ax, ay, error) != 0)
+      {
+         return -1;
+      }
+   }
+
+   return asciip_decimate_emit(result, start, decimate->last[0], decimate->last[1], error);
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_init
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Initializes an empty decimator.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Decimate *asciip_decimate_init(size_t            buckets,
+                                      uint8_t           method,
+                                      Asciip_Decimate **result,
+                                      Asciip_Error     *error)
+{
+   Asciip_Decimate *decimate;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_decimate_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((buckets == 0) || (buckets > SIZE_MAX / sizeof(Asciip_Decimate_Bucket)))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_decimate_init: Bad bucket count.");
+      return NULL;
+   }
+
+   if ((decimate = malloc(sizeof(Asciip_Decimate))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_decimate_init: Could not malloc decimator.");
+      return NULL;
+   }
+
+   decimate->method = method;
+   decimate->buckets = buckets;
+   if ((decimate->bucket = malloc(buckets * sizeof(Asciip_Decimate_Bucket))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_decimate_init: Could not malloc buckets.");
+      free(decimate);
+      return NULL;
+   }
+
+   asciip_decimate_set_range(decimate, 0.0, 1.0, NULL);
+
+   *result = decimate;
+   return decimate;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_destroy
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Releases the decimator and its buckets.
+ ************************************************************************/
+void asciip_decimate_destroy(Asciip_Decimate *decimate)
+{
+   if (decimate == NULL)
+   {
+      return;
+   }
+
+   free(decimate->bucket);
+   free(decimate);
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_clear
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Empties every bucket.
+ ************************************************************************/
+void asciip_decimate_clear(Asciip_Decimate *decimate)
+{
+   memset(decimate->bucket, 0, decimate->buckets * sizeof(Asciip_Decimate_Bucket));
+   decimate->count = 0;
+   decimate->before = 0;
+   decimate->after = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_set_range
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Sets the x values at the edges of the buckets.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_decimate_set_range(Asciip_Decimate *decimate,
+                                 double           x_min,
+                                 double           x_max,
+                                 Asciip_Error    *error)
+{
+   if (decimate == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_decimate_set_range: Decimator was NULL.");
+      return -1;
+   }
+
+   if (!isfinite(x_max - x_min) || !(x_max > x_min))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_decimate_set_range: Range was empty.");
+      return -1;
+   }
+
+   decimate->x_min = x_min;
+   decimate->x_max = x_max;
+   decimate->x_scale = (double)decimate->buckets / (x_max - x_min);
+   asciip_decimate_clear(decimate);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_add
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Streams points into the buckets in one pass. Points
+ *               falling in the same bucket as the one before are
+ *               gathered into a run held in registers, so a sorted
+ *               series touches each bucket once per run.
+ ************************************************************************/
+void asciip_decimate_add(Asciip_Decimate *decimate,
+                         const double    *xs,
+                         const double    *ys,
+                         size_t           count)
+{
+   Asciip_Decimate_Bucket run;
+   double x_min = decimate->x_min;
+   double x_max = decimate->x_max;
+   double x_scale = decimate->x_scale;
+   double first = (decimate->count > 0) ? decimate->first[0] : INFINITY;
+   double last = (decimate->count > 0) ? decimate->last[0] : -INFINITY;
+   double x;
+   double y;
+   size_t ind;
+   size_t pos = decimate->buckets;
+   size_t at;
+
+   run.count = 0;
+   for (ind = 0; ind < count; ind++)
+   {
+      x = xs[ind];
+      y = ys[ind];
+      if (!isfinite(x) || !isfinite(y))
+      {
+         continue;
+      }
+
+      if (x < x_min)
+      {
+         if (!decimate->before || (x > decimate->prev[0]))
+         {
+            decimate->before = 1;
+            decimate->prev[0] = x;
+            decimate->prev[1] = y;
+         }
+         continue;
+      }
+
+      if (x > x_max)
+      {
+         if (!decimate->after || (x < decimate->next[0]))
+         {
+            decimate->after = 1;
+            decimate->next[0] = x;
+            decimate->next[1] = y;
+         }
+         continue;
+      }
+
+      /* The right edge belongs to the last bucket */
+      at = (size_t)((x - x_min) * x_scale);
+      at = (at < decimate->buckets) ? at : decimate->buckets - 1;
+
+      if (at != pos)
+      {
+         asciip_decimate_flush(decimate, pos, &run);
+         pos = at;
+         run.min_x = x;
+         run.min_y = y;
+         run.max_x = x;
+         run.max_y = y;
+         run.sum_x = x;
+         run.sum_y = y;
+         run.count = 1;
+      }
+      else
+      {
+         if (y < run.min_y)
+         {
+            run.min_x = x;
+            run.min_y = y;
+         }
+         else if (y > run.max_y)
+         {
+            run.max_x = x;
+            run.max_y = y;
+         }
+         run.sum_x += x;
+         run.sum_y += y;
+         run.count++;
+      }
+
+      if (x < first)
+      {
+         first = x;
+         decimate->first[0] = x;
+         decimate->first[1] = y;
+      }
+      if (x > last)
+      {
+         last = x;
+         decimate->last[0] = x;
+         decimate->last[1] = y;
+      }
+   }
+
+   asciip_decimate_flush(decimate, pos, &run);
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_add_series
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Streams every point of a series into the buckets.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_decimate_add_series(Asciip_Decimate     *decimate,
+                                  const Asciip_Series *series,
+                                  Asciip_Error        *error)
+{
+   if ((decimate == NULL) || (series == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_decimate_add_series: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_decimate_add(decimate, series->x, series->y, series->size);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_add_list
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Streams every point of a list into the buckets in
+ *               batches.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_decimate_add_list(Asciip_Decimate   *decimate,
+                                const Asciip_List *list,
+                                Asciip_Error      *error)
+{
+   Asciip_List_Iter iter;
+   double xs[ASCIIP_DECIMATE_LIST_BATCH];
+   double ys[ASCIIP_DECIMATE_LIST_BATCH];
+   size_t read;
+
+   if ((decimate == NULL) || (list == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_decimate_add_list: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_list_iter_begin(list, &iter);
+   while ((read = asciip_list_iter_read(&iter, xs, ys, ASCIIP_DECIMATE_LIST_BATCH)) > 0)
+   {
+      asciip_decimate_add(decimate, xs, ys, read);
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_decimate_output
+ *
+ * See         : asciip_decimate.h
+ *
+ * Description : Appends the reduced points to a series in increasing
+ *               x order.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_decimate_output(const Asciip_Decimate *decimate,
+                              Asciip_Series         *result,
+                              Asciip_Error          *error)
+{
+   size_t start;
+   int8_t status = 0;
+
+   if ((decimate == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_decimate_output: One of the parameters were NULL.");
+      return -1;
+   }
+
+   start = result->size;
+   if (decimate->before)
+   {
+      status = asciip_series_add(result, decimate->prev[0], decimate->prev[1], error);
+   }
+
+   if ((status == 0) && (decimate->count > 0))
+   {
+      if (decimate->method == ASCIIP_DECIMATE_LTTB)
+      {
+         status = asciip_decimate_lttb(decimate, result, start, error);
+      }
+      else
+      {
+         status = asciip_decimate_minmax(decimate, result, start, error);
+      }
+   }
+
+   if ((status == 0) && decimate->after)
+   {
+      status = asciip_series_add(result, decimate->next[0], decimate->next[1], error);
+   }
+
+   return status;
+}
@@ -0,0 +1,265 @@
+/************************************************************************
+ *
+ * File        : asciip_file.c
+ *
+ * Description : Contains methods to save a series to a binary file and
+ *               to load one back without copying it.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_file.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_file_axis_pack
+ *
+ * Description : Copies axis statistics into their header layout.
+ ************************************************************************/
+static void asciip_file_axis_pack(const Asciip_Axis_Stats *stats,
+                                  Asciip_File_Axis        *axis)
+{
+   axis->min = stats->min;
+   axis->max = stats->max;
+   axis->sum = stats->sum;
+   axis->count = stats->count;
+   axis->nans = stats->nans;
+}
+
+/************************************************************************
+ * Name        : asciip_file_axis_unpack
+ *
+ * Description : Copies axis statistics out of their header layout.
+ ************************************************************************/
+static void asciip_file_axis_unpack(const Asciip_File_Axis *axis,
+                                    Asciip_Axis_Stats      *stats)
+{
+   stats->min = axis->min;
+   stats->max = axis->max;
+   stats->sum = axis->sum;
+   stats->count = (size_t)axis->count;
+   stats->nans = (size_t)axis->nans;
+}
+
+/************************************************************************
+ * Name        : asciip_file_column_fits
+ *
+ * Description : Checks that a column of count doubles at offset is
+ *               aligned and inside a file of length bytes.
+ ************************************************************************/
+static uint8_t asciip_file_column_fits(uint64_t offset,
+                                       uint64_t count,
+                                       size_t   length)
+{
+   return (offset >= sizeof(Asciip_File_Header)) &&
+          (offset % sizeof(double) == 0) &&
+          (offset <= length) &&
+          (count <= (length - offset) / sizeof(double));
+}
+
+/************************************************************************
+ * Name        : asciip_file_write
+ *
+ * See         : asciip_file.h
+ *
+ * Description : Saves a series to path in the series file format.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_file_write(const char          *path,
+                         const Asciip_Series *series,
+                         Asciip_Error        *error)
+{
+   Asciip_File_Header header;
+   Asciip_Bounds bounds;
+   FILE *stream;
+   size_t ind;
+   int8_t status = 0;
+
+   if ((path == NULL) || (series == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_file_write: Path or series was NULL.");
+      return -1;
+   }
+
+   if (asciip_stats_series(series, &bounds, error) != 0)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, ASCIIP_FILE_MAGIC, sizeof(ASCIIP_FILE_MAGIC));
+   header.version = ASCIIP_FILE_VERSION;
+   header.byte_order = ASCIIP_FILE_BYTE_ORDER;
+   header.count = series->size;
+   header.x_offset = sizeof(Asciip_File_Header);
+   header.y_offset = header.x_offset + series->size * sizeof(double);
+   asciip_file_axis_pack(&bounds.x, &header.x);
+   asciip_file_axis_pack(&bounds.y, &header.y);
+
+   /* Sorted as the pyramid and range searches need it: no NaN, and
+    * never decreasing */
+   header.flags = (bounds.x.nans == 0) ? ASCIIP_FILE_SORTED : 0;
+   for (ind = 1; (ind < series->size) && header.flags; ind++)
+   {
+      if (series->x[ind] < series->x[ind - 1])
+      {
+         header.flags = 0;
+      }
+   }
+
+   if ((stream = fopen(path, "wb")) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_file_write: Could not open file.");
+      return -1;
+   }
+
+   if ((fwrite(&header, sizeof(header), 1, stream) != 1) ||
+       (fwrite(series->x, sizeof(double), series->size, stream) != series->size) ||
+       (fwrite(series->y, sizeof(double), series->size, stream) != series->size))
+   {
+      status = -1;
+   }
+
+   if ((fclose(stream) != 0) || (status != 0))
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_file_write: Could not write file.");
+      return -1;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_file_init
+ *
+ * See         : asciip_file.h
+ *
+ * Description : Maps a series file read-only, exposing its columns as
+ *               a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_File *asciip_file_init(const char    *path,
+                              Asciip_File  **result,
+                              Asciip_Error  *error)
+{
+   const Asciip_File_Header *header;
+   Asciip_File *file;
+   struct stat info;
+   void *map;
+   int fd;
+
+   if ((path == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_file_init: Path or result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((fd = open(path, O_RDONLY)) < 0)
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_file_init: Could not open file.");
+      return NULL;
+   }
+
+   if ((fstat(fd, &info) != 0) || (info.st_size < (off_t)sizeof(Asciip_File_Header)) ||
+       ((uint64_t)info.st_size > SIZE_MAX))
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_file_init: File too short for a header.");
+      close(fd);
+      return NULL;
+   }
+
+   /* The mapping holds its own reference to the file */
+   map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (map == MAP_FAILED)
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_file_init: Could not map file.");
+      return NULL;
+   }
+
+   header = (const Asciip_File_Header *)map;
+   if ((memcmp(header->magic, ASCIIP_FILE_MAGIC, sizeof(ASCIIP_FILE_MAGIC)) != 0) ||
+       (header->version != ASCIIP_FILE_VERSION) ||
+       (header->byte_order != ASCIIP_FILE_BYTE_ORDER) ||
+       !asciip_file_column_fits(header->x_offset, header->count, (size_t)info.st_size) ||
+       !asciip_file_column_fits(header->y_offset, header->count, (size_t)info.st_size))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_file_init: Not a series file.");
+      munmap(map, (size_t)info.st_size);
+      return NULL;
+   }
+
+   if ((file = malloc(sizeof(Asciip_File))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_file_init: Could not malloc file.");
+      munmap(map, (size_t)info.st_size);
+      return NULL;
+   }
+
+   file->map = map;
+   file->length = (size_t)info.st_size;
+   file->series.size = (size_t)header->count;
+   file->series.capacity = (size_t)header->count;
+   file->series.x = (double *)((char *)map + header->x_offset);
+   file->series.y = (double *)((char *)map + header->y_offset);
+   file->sorted = (header->flags & ASCIIP_FILE_SORTED) ? 1 : 0;
+   asciip_file_axis_unpack(&header->x, &file->bounds.x);
+   asciip_file_axis_unpack(&header->y, &file->bounds.y);
+
+   *result = file;
+   return file;
+}
+
+/************************************************************************
+ * Name        : asciip_file_destroy
+ *
+ * See         : asciip_file.h
+ *
+ * Description : Unmaps a loaded file.
+ ************************************************************************/
+void asciip_file_destroy(Asciip_File *file)
+{
+   if (file == NULL)
+   {
+      return;
+   }
+
+   munmap((void *)file->map, file->length);
+   free(file);
+}
@@ -25,22 +25,43 @@
  * Other Header Includes
  ************************************************************************/
  #include "asciip_lists.h"
+ #include "asciip_pool.h"
+ #include "asciip_sort.h"
+ #include "asciip_summary.h"
 
 /************************************************************************
  * Macro Definitions
  ************************************************************************/
 
+/* Lists at least this long are sorted through the radix engine */
+#define ASCIIP_LIST_RADIX_MIN 1024
+
 /************************************************************************
  * Type and Struct Definitions
  ************************************************************************/
-typedef enum _asciip_err_e
+
+/* Chunks hold at most ASCIIP_LIST_INDEX_CHUNK consecutive nodes. Removes
+ * shrink a chunk in place and a Fenwick tree over the chunk counts maps
+ * an index to its chunk in O(log chunks). */
+typedef struct _asciip_list_index_t
+{
+   size_t        chunks;     /* Number of chunks in use */
+   size_t        empty;      /* Chunks in use that removes left empty */
+   size_t        capacity;   /* Number of chunk slots allocated */
+   Asciip_Node **first;      /* First node of each chunk */
+   size_t       *counts;     /* Nodes in each chunk */
+   size_t       *tree;       /* Fenwick tree over counts, 1-based */
+   
+} Asciip_List_Index;
+
+
+/* Heap entry of the k-way merge: the key of a run's head node */
+typedef struct _asciip_list_merge_run_t
 {
-   ASCIIP_ERR_NULL_PTR = 0x0,
-   ASCIIP_ERR_MEM      = 0x1,
-   ASCIIP_ERR_INDEX    = 0x2,
-   ASCIIP_ERR_MAX_NUM  = 0x3
+   uint64_t key;   /* asciip_sort_key of the head x */
+   size_t   run;   /* Run the head belongs to, 0 is the target list */
    
-} asciip_err_e;
+} Asciip_List_Merge_Run;
 
 /************************************************************************
  * Constant Definitions
@@ -50,11 +71,23 @@ typedef enum _asciip_err_e
  * Functions
  ************************************************************************/ 
  
+/* Non-zero to echo reported errors on stderr */
+static uint8_t asciip_error_echo = 1;
+
+/* TODO This needs to be moved to a better area */
+void report_error_echo(uint8_t echo)
+{
+   asciip_error_echo = echo;
+}
+
 /* TODO This needs to be moved to a better area */
 void report_error(Asciip_Error *error, uint8_t error_code, const char *error_message)
 {
    /* TODO change this to a logging framework */
-   printf("[ERROR] Code: 0x%x, Message: %s\n", error_code, error_message);
+   if (asciip_error_echo)
+   {
+      fprintf(stderr, "[ERROR] Code: 0x%x, Message: %s\n", error_code, error_message);
+   }
    
    /* If the user doesn't want to track errors, return */
    if (error == NULL)
@@ -70,378 +103,1946 @@ void report_error(Asciip_Error *error, uint8_t error_code, const char *error_mes
 }
 
 /************************************************************************
- * Name        : asciip_list_init
- * 
- * See         : asciip_lists.h
+ * Name        : asciip_list_new_node
  * 
- * Description : Initializes a new Ascii_List struct with the given point
- *               being stored in the first Asciip_Node in the list.
- * 
- *               If the Asciip_Point is NULL the list is initialized 
- *               without a first point (i.e. sizewill be equal to 0).
- * 
- *               If error is NULL, the errors will not be tracked.
+ * Description : Allocates an unlinked node from the list pool, or from
+ *               the heap when the list is not pooled.
  ************************************************************************/ 
-Asciip_List *asciip_list_init(Asciip_Point  *init_point, 
-                              Asciip_List  **result,
-                              Asciip_Error  *error)
+static Asciip_Node *asciip_list_new_node(Asciip_List  *list,
+                                         Asciip_Error *error)
 {
-   Asciip_List *point_list;
    Asciip_Node *nodep;
    
-   /* Make sure result pointer is not NULL */
-   if (result == NULL)
+   if (list->pool != NULL)
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_init: Result pointer was NULL, cannot store result.\n");
-      return NULL;
+      nodep = asciip_pool_alloc(list->pool, error);
    }
-   
-   /* Malloc the list and set the initial size */
-   if ((point_list = malloc(sizeof(Asciip_List))) == NULL)
+   else
    {
-      report_error(error, ASCIIP_ERR_MEM, "asciip_list_init: Could not malloc point list pointer.");
-      return NULL;
+      nodep = malloc(sizeof(Asciip_Node));
    }
    
-   /* Set the default values */
-   point_list->size = 0;
-   point_list->head = NULL;
-   point_list->tail = NULL;
-   
-   /* Add the initial point if its not NULL */
-   if (init_point != NULL)
+   if (nodep == NULL)
    {
-      point_list->size++;
-      
-      /* Create node for point to go into */
-      if ((nodep = malloc(sizeof(Asciip_Node))) == NULL)
-      {
-         report_error(error, ASCIIP_ERR_MEM, "asciip_list_init: Could not allocate memory to new node.\n");
-         return NULL;
-      }
-      
-      /* Save data and set list parameters */
-      nodep->data = init_point;
-      point_list->head = nodep;
-      point_list->tail = nodep;
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_new_node: Could not allocate node.");
+      return NULL;
    }
    
-   *result = point_list;
-   return point_list;
+   nodep->data = NULL;
+   nodep->next = NULL;
+   return nodep;
 }
 
 /************************************************************************
- * Name        : asciip_list_destroy
+ * Name        : asciip_list_free_node
  * 
- * See         : asciip_lists.h
- * 
- * Description : Releases memory contents held by list. Destroys all
- *               nodes and points in the list as well.
- * 
- *               If error is NULL, the errors will not be tracked.
- ************************************************************************/                              
-int8_t asciip_list_destroy(Asciip_List  *list,
-                           Asciip_Error *error)
+ * Description : Releases a node and, if release_point is set, its point
+ *               back to wherever the list allocates them from.
+ ************************************************************************/ 
+static void asciip_list_free_node(Asciip_List *list,
+                                  Asciip_Node *nodep,
+                                  uint8_t      release_point)
 {
-   Asciip_Point *pointp;
-   uint8_t ind;
-   
-   /* If the list is already NULL we don't need to free anything */
-   if (list == NULL)
+   if (list->pool != NULL)
    {
-      return 0;
+      if (release_point)
+      {
+         asciip_pool_release(list->pool, nodep->data);
+      }
+      asciip_pool_release(list->pool, nodep);
    }
-   
-   /* Loop through all the points that were created and release their memory 
-    * Starting from the front */
-   for (ind = 0; ind >= list->size - 1; ind++)
+   else
    {
-      if (asciip_list_get(list, ind, pointp, error) == NULL)
+      if (release_point)
       {
-         report_error(error, ASCIIP_ERR_MEM, "asciip_list_destroy: Could not destroy point passed");
-         return -1;
+         asciip_point_destroy(nodep->data);
       }
-      
-      asciip_point_destroy(pointp);
+      free(nodep);
    }
-   
-   /* Now free the list struct */
-   free(list);
-   
-   return 0;
 }
 
 /************************************************************************
- * Name        : asciip_list_add
- * 
- * See         : ascii_lists.h
+ * Name        : asciip_list_new_point_node
  * 
- * Description : Adds point to new node and appends it to the back
- *               of the list.
- * 
- *               If error is NULL, the errors will not be tracked.
- ************************************************************************/                              
-int8_t asciip_list_add(Asciip_List  *list,
-                       Asciip_Point *point,
-                       Asciip_Error *error)
+ * Description : Creates the point (x, y) and an unlinked node holding
+ *               it, carving both from the pool when the list has one.
+ ************************************************************************/ 
+static Asciip_Node *asciip_list_new_point_node(Asciip_List  *list,
+                                               double        x,
+                                               double        y,
+                                               Asciip_Error *error)
 {
    Asciip_Node *nodep;
+   Asciip_Point *point;
    
-   /* Check values and list are not NULL */
-   if ((list == NULL) || (point == NULL))
+   if (list->pool != NULL)
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_add: One of the parameters were NULL.");
-      return -1;
+      point = asciip_pool_alloc(list->pool, error);
+   }
+   else
+   {
+      point = asciip_point_init(x, y, &point, error);
    }
    
-   /* Create node and set data */
-   if ((nodep = malloc(sizeof(Asciip_Node))) == NULL)
+   if (point == NULL)
    {
-      report_error(error, ASCIIP_ERR_MEM, "asciip_list_add: Could not create new node for list.");
-      return -1;
+      return NULL;
    }
    
-   nodep->data = point;
+   point->x = x;
+   point->y = y;
    
-   /* Add to the end of the list */
-   list->size++;
-   list->tail->next = nodep;
-   list->tail = nodep;
+   if ((nodep = asciip_list_new_node(list, error)) == NULL)
+   {
+      if (list->pool != NULL)
+      {
+         asciip_pool_release(list->pool, point);
+      }
+      else
+      {
+         asciip_point_destroy(point);
+      }
+      return NULL;
+   }
    
-   return 0;
+   nodep->data = point;
+   return nodep;
 }
 
 /************************************************************************
- * Name        : asciip_list_remove
- * 
- * See         : ascii_lists.h
+ * Name        : asciip_list_index_drop
  * 
- * Description : Removes point node at the index passed by the user from
- *               the list. Releases Node memory but not the point. 
- *               Returns the point that was removed.
+ * Description : Releases the random access index, it is rebuilt on the
+ *               next indexed access.
+ ************************************************************************/ 
+static void asciip_list_index_drop(Asciip_List *list)
+{
+   if (list->index == NULL)
+   {
+      return;
+   }
+   
+   free(list->index->first);
+   free(list->index->counts);
+   free(list->index->tree);
+   free(list->index);
+   list->index = NULL;
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_prefix
  * 
- *               If error is NULL, the errors will not be tracked.
- ************************************************************************/                              
-Asciip_Point *asciip_list_remove(Asciip_List  *list,
-                                 uint16_t      index,
-                                 Asciip_Error *error)
+ * Description : Returns the number of nodes held by the first chunks
+ *               chunks of the index.
+ ************************************************************************/ 
+static size_t asciip_list_index_prefix(const Asciip_List_Index *indexp,
+                                       size_t                   chunks)
 {
-   Asciip_Node *nodep;
-   Asciip_Node *prev_nodep;
-   Asciip_Point *point;
-   uint16_t ind;
+   size_t sum = 0;
    
-   /* Make sure list is not NULL before continuing */
-   if (list == NULL)
+   for (; chunks > 0; chunks &= chunks - 1)
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_remove: list was NULL, cannot operate on NULL list.");
-      return NULL;
+      sum += indexp->tree[chunks];
    }
+   
+   return sum;
+}
 
-   /* Check index is valid */
-   if (index > list->size - 1)
+/************************************************************************
+ * Name        : asciip_list_index_adjust
+ * 
+ * Description : Changes the node count of a chunk by delta.
+ ************************************************************************/ 
+static void asciip_list_index_adjust(Asciip_List_Index *indexp,
+                                     size_t             chunk,
+                                     int8_t             delta)
+{
+   size_t pos;
+   
+   indexp->counts[chunk] += delta;
+   for (pos = chunk + 1; pos <= indexp->chunks; pos += pos & (~pos + 1))
    {
-      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_remove: Index was not in the bounds of the list.");
-      return NULL;
+      indexp->tree[pos] += delta;
    }
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_grow
+ * 
+ * Description : Makes room for at least one more chunk.
+ ************************************************************************/ 
+static int8_t asciip_list_index_grow(Asciip_List_Index *indexp)
+{
+   Asciip_Node **new_first;
+   size_t       *new_counts;
+   size_t       *new_tree;
+   size_t        new_capacity;
    
-   /* Find the Node user is looking for */
-   nodep = list->head;
-   for (ind = 1; ind < index; ind++)
+   if (indexp->chunks < indexp->capacity)
    {
-      prev_nodep = nodep;
-      nodep = prev_nodep->next;
+      return 0;
    }
    
-   /* Remove the Node and decrease the size */
-   list->size--;
-   if (index == 0)
+   new_capacity = (indexp->capacity == 0) ? 16 : indexp->capacity * 2;
+   
+   if ((new_first = realloc(indexp->first, new_capacity * sizeof(Asciip_Node *))) == NULL)
    {
-      /* If the HEAD needs to be removed it is a special case */
-      list->head = nodep->next;
+      return -1;
    }
-   else 
+   indexp->first = new_first;
+   
+   if ((new_counts = realloc(indexp->counts, new_capacity * sizeof(size_t))) == NULL)
    {
-      /* Otherwise remove node and set previous node to point to node after one removed */
-      prev_nodep->next = nodep->next;
+      return -1;
    }
+   indexp->counts = new_counts;
    
-   nodep->next = NULL;
-   point = nodep->data;
+   if ((new_tree = realloc(indexp->tree, (new_capacity + 1) * sizeof(size_t))) == NULL)
+   {
+      return -1;
+   }
+   indexp->tree = new_tree;
+   indexp->capacity = new_capacity;
    
-   /* Release memory held by Node and return data */
-   free(nodep);
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_rebuild_tree
+ * 
+ * Description : Rebuilds the Fenwick tree from the chunk counts in
+ *               O(chunks).
+ ************************************************************************/ 
+static void asciip_list_index_rebuild_tree(Asciip_List_Index *indexp)
+{
+   size_t pos;
+   size_t parent;
    
-   return point;
+   for (pos = 1; pos <= indexp->chunks; pos++)
+   {
+      indexp->tree[pos] = indexp->counts[pos - 1];
+   }
+   for (pos = 1; pos <= indexp->chunks; pos++)
+   {
+      parent = pos + (pos & (~pos + 1));
+      if (parent <= indexp->chunks)
+      {
+         indexp->tree[parent] += indexp->tree[pos];
+      }
+   }
 }
 
-static Asciip_Node *asciip_list_get_node(Asciip_Node  *nodep,
-                                         uint16_t      index,
-                                         Asciip_Node **result,
-                                         Asciip_Error *error)
+/************************************************************************
+ * Name        : asciip_list_index_compact
+ * 
+ * Description : Drops the chunks removes left empty once they are more
+ *               than half of all chunks, so a list used as a sliding
+ *               window keeps an index the size of its contents. Costs
+ *               O(chunks) at most once per chunks / 2 emptied chunks.
+ ************************************************************************/ 
+static void asciip_list_index_compact(Asciip_List_Index *indexp)
 {
-   uint16_t ind;
+   size_t kept = 0;
+   size_t chunk;
    
-   /* Make sure list is not NULL */
-   if (nodep == NULL)
+   if (indexp->empty * 2 <= indexp->chunks)
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_get_node: list was NULL, cannot operate on NULL list.");
-      return NULL;
+      return;
    }
    
-   /* Find the Node user is looking for */
-   for (ind = 1; ind < index; ind++)
+   for (chunk = 0; chunk < indexp->chunks; chunk++)
    {
-      if (nodep == NULL)
+      if (indexp->counts[chunk] > 0)
       {
-         report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_get_node: Found end of list unexpectedly.\n");
-         return NULL;
+         indexp->first[kept] = indexp->first[chunk];
+         indexp->counts[kept] = indexp->counts[chunk];
+         kept++;
       }
-      nodep = nodep->next;
    }
    
-   *result = nodep;
-   return nodep;
+   indexp->chunks = kept;
+   indexp->empty = 0;
+   asciip_list_index_rebuild_tree(indexp);
 }
 
 /************************************************************************
- * Name        : asciip_list_get
+ * Name        : asciip_list_index_push
  * 
- * See         : asciip_lists.h
- * 
- * Description : Retrieves the point at the index passed from the user
- *               and returns the point found.
- * 
- *               If error is NULL, the errors will not be tracked.
- ************************************************************************/                              
-Asciip_Point *asciip_list_get(Asciip_List  *list,
-                              uint16_t      index,
-                              Asciip_Point *result,
-                              Asciip_Error *error)
+ * Description : Adds a new chunk holding nodep to the end of the index.
+ ************************************************************************/ 
+static int8_t asciip_list_index_push(Asciip_List_Index *indexp,
+                                     Asciip_Node       *nodep)
 {
-   Asciip_Node *nodep;
+   size_t pos;
    
-   /* Make sure list is not NULL */
-   if (list == NULL)
+   if (asciip_list_index_grow(indexp) != 0)
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_get: List was NULL, cannot find index.\n");
-      return NULL;
+      return -1;
    }
+   
+   /* Tree slot pos covers chunks (pos - lowbit(pos), pos] */
+   pos = ++indexp->chunks;
+   indexp->first[pos - 1] = nodep;
+   indexp->counts[pos - 1] = 1;
+   indexp->tree[pos] = 1 + asciip_list_index_prefix(indexp, pos - 1)
+                         - asciip_list_index_prefix(indexp, pos - (pos & (~pos + 1)));
+   
+   return 0;
+}
 
-   /* Check index is valid */
-   if (index > list->size - 1)
+/************************************************************************
+ * Name        : asciip_list_index_append
+ * 
+ * Description : Records a node appended to the back of the list. The
+ *               index is dropped if it cannot grow.
+ ************************************************************************/ 
+static void asciip_list_index_append(Asciip_List *list,
+                                     Asciip_Node *nodep)
+{
+   Asciip_List_Index *indexp = list->index;
+   size_t last;
+   
+   if (indexp == NULL)
    {
-      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_get: Index was not in the bounds of the list.");
-      return NULL;
+      return;
    }
-
-   if (asciip_list_get_node(list->head, index, &nodep, error) == NULL)
+   
+   last = indexp->chunks - 1;
+   if ((indexp->chunks == 0) || (indexp->counts[last] >= ASCIIP_LIST_INDEX_CHUNK))
    {
-      /* Error reporting was done in method below */
-      return NULL;
+      if (asciip_list_index_push(indexp, nodep) != 0)
+      {
+         asciip_list_index_drop(list);
+      }
+      return;
    }
    
-   result = nodep->data;
-   return result;
+   /* A chunk emptied by removes restarts at the appended node */
+   if (indexp->counts[last] == 0)
+   {
+      indexp->first[last] = nodep;
+      indexp->empty--;
+   }
+   asciip_list_index_adjust(indexp, last, 1);
 }
 
 /************************************************************************
- * Name        : asciip_merge_list
- *
+ * Name        : asciip_list_index_build
+ * 
+ * Description : Builds the random access index with one walk of the 
+ *               list.
+ ************************************************************************/ 
+static int8_t asciip_list_index_build(Asciip_List  *list,
+                                      Asciip_Error *error)
+{
+   Asciip_List_Index *indexp;
+   Asciip_Node *nodep;
+   size_t ind;
+   size_t pos;
+   
+   if ((indexp = calloc(1, sizeof(Asciip_List_Index))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_index_build: Could not allocate index.");
+      return -1;
+   }
+   list->index = indexp;
+   
+   /* Push a chunk every ASCIIP_LIST_INDEX_CHUNK nodes, counts are fixed up below */
+   nodep = list->head;
+   for (ind = 0; ind < list->size; ind += ASCIIP_LIST_INDEX_CHUNK)
+   {
+      if (asciip_list_index_push(indexp, nodep) != 0)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_index_build: Could not grow index.");
+         asciip_list_index_drop(list);
+         return -1;
+      }
+      indexp->counts[indexp->chunks - 1] = ((list->size - ind) < ASCIIP_LIST_INDEX_CHUNK) ? 
+                                           (list->size - ind) : ASCIIP_LIST_INDEX_CHUNK;
+      
+      for (pos = 0; (pos < ASCIIP_LIST_INDEX_CHUNK) && (nodep != NULL); pos++)
+      {
+         nodep = nodep->next;
+      }
+   }
+   
+   asciip_list_index_rebuild_tree(indexp);
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_find
+ * 
+ * Description : Returns the chunk holding the node at index and stores
+ *               the node's position within that chunk in offset.
+ *               Empty chunks are never returned.
+ ************************************************************************/ 
+static size_t asciip_list_index_find(const Asciip_List_Index *indexp,
+                                     size_t                   index,
+                                     size_t                  *offset)
+{
+   size_t pos = 0;
+   size_t step = 1;
+   
+   while ((step << 1) <= indexp->chunks)
+   {
+      step <<= 1;
+   }
+   
+   /* Descend to the last chunk whose prefix count is still <= index */
+   for (; step > 0; step >>= 1)
+   {
+      if ((pos + step <= indexp->chunks) && (indexp->tree[pos + step] <= index))
+      {
+         pos += step;
+         index -= indexp->tree[pos];
+      }
+   }
+   
+   *offset = index;
+   return pos;
+}
+
+/************************************************************************
+ * Name        : asciip_list_node_at
+ * 
+ * Description : Returns the node at a valid index through the chunk
+ *               index, building it first if needed. Falls back to a
+ *               walk from the head if the index cannot be built.
+ ************************************************************************/ 
+static Asciip_Node *asciip_list_node_at(Asciip_List  *list,
+                                        size_t        index,
+                                        Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   size_t chunk;
+   size_t offset;
+   
+   /* The tail needs no lookup */
+   if (index == list->size - 1)
+   {
+      return list->tail;
+   }
+   
+   if ((list->index == NULL) && (asciip_list_index_build(list, error) != 0))
+   {
+      offset = index;
+      nodep = list->head;
+   }
+   else
+   {
+      chunk = asciip_list_index_find(list->index, index, &offset);
+      nodep = list->index->first[chunk];
+   }
+   
+   for (; offset > 0; offset--)
+   {
+      nodep = nodep->next;
+   }
+   
+   return nodep;
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_split
+ * 
+ * Description : Splits a chunk that has grown past twice the chunk size
+ *               in half, so walks inside a chunk stay short. Drops the
+ *               index if it cannot grow.
+ ************************************************************************/ 
+static void asciip_list_index_split(Asciip_List *list,
+                                    size_t       chunk)
+{
+   Asciip_List_Index *indexp = list->index;
+   Asciip_Node *nodep;
+   size_t half;
+   size_t ind;
+   
+   if (asciip_list_index_grow(indexp) != 0)
+   {
+      asciip_list_index_drop(list);
+      return;
+   }
+   
+   half = indexp->counts[chunk] / 2;
+   nodep = indexp->first[chunk];
+   for (ind = 0; ind < half; ind++)
+   {
+      nodep = nodep->next;
+   }
+   
+   /* Shift the later chunks up one slot, the tree is rebuilt after */
+   memmove(&indexp->first[chunk + 2], &indexp->first[chunk + 1], (indexp->chunks - chunk - 1) * sizeof(Asciip_Node *));
+   memmove(&indexp->counts[chunk + 2], &indexp->counts[chunk + 1], (indexp->chunks - chunk - 1) * sizeof(size_t));
+   indexp->first[chunk + 1] = nodep;
+   indexp->counts[chunk + 1] = indexp->counts[chunk] - half;
+   indexp->counts[chunk] = half;
+   indexp->chunks++;
+   
+   asciip_list_index_rebuild_tree(indexp);
+}
+
+/************************************************************************
+ * Name        : asciip_list_append_node
+ * 
+ * Description : Links an unlinked node to the back of the list.
+ ************************************************************************/ 
+static void asciip_list_append_node(Asciip_List *list,
+                                    Asciip_Node *nodep)
+{
+   /* An empty list has no tail to link from */
+   list->size++;
+   if (list->tail == NULL)
+   {
+      list->head = nodep;
+   }
+   else
+   {
+      list->tail->next = nodep;
+   }
+   list->tail = nodep;
+   
+   asciip_list_index_append(list, nodep);
+}
+
+/************************************************************************
+ * Name        : asciip_list_insert_node
+ * 
+ * Description : Links an unlinked node into the list. Lists in keep
+ *               sorted mode place it after the last node with x less
+ *               than or equal to its x, found by binary search; other
+ *               lists append it.
+ ************************************************************************/ 
+static void asciip_list_insert_node(Asciip_List  *list,
+                                    Asciip_Node  *nodep,
+                                    Asciip_Error *error)
+{
+   Asciip_Node *prev_nodep = NULL;
+   double x = nodep->data->x;
+   size_t low = 0;
+   size_t high;
+   size_t mid;
+   size_t chunk;
+   size_t offset;
+   
+   asciip_summary_add(list->summary, x, nodep->data->y);
+   
+   /* In order arrivals, the common case, go on the back in O(1) */
+   if (!list->keep_sorted || (list->size == 0) || !(x < list->tail->data->x))
+   {
+      asciip_list_append_node(list, nodep);
+      return;
+   }
+   
+   /* Find the first node with a larger x, the tail is already known to be larger */
+   high = list->size - 1;
+   while (low < high)
+   {
+      mid = low + (high - low) / 2;
+      if (x < asciip_list_node_at(list, mid, error)->data->x)
+      {
+         high = mid;
+      }
+      else
+      {
+         low = mid + 1;
+      }
+   }
+   
+   /* Insert in front of the node at low */
+   if (low == 0)
+   {
+      nodep->next = list->head;
+      list->head = nodep;
+   }
+   else
+   {
+      prev_nodep = asciip_list_node_at(list, low - 1, error);
+      nodep->next = prev_nodep->next;
+      prev_nodep->next = nodep;
+   }
+   
+   /* The node joins the chunk of the node it was placed in front of */
+   if (list->index != NULL)
+   {
+      chunk = asciip_list_index_find(list->index, low, &offset);
+      if (offset == 0)
+      {
+         list->index->first[chunk] = nodep;
+      }
+      asciip_list_index_adjust(list->index, chunk, 1);
+      
+      if (list->index->counts[chunk] > 2 * ASCIIP_LIST_INDEX_CHUNK)
+      {
+         asciip_list_index_split(list, chunk);
+      }
+   }
+   
+   list->size++;
+}
+
+/************************************************************************
+ * Name        : asciip_list_init
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Initializes a new Ascii_List struct with the given point
+ *               being stored in the first Asciip_Node in the list.
+ * 
+ *               If the Asciip_Point is NULL the list is initialized 
+ *               without a first point (i.e. sizewill be equal to 0).
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/ 
+Asciip_List *asciip_list_init(Asciip_Point  *init_point, 
+                              Asciip_List  **result,
+                              Asciip_Error  *error)
+{
+   Asciip_List *point_list;
+   Asciip_Node *nodep;
+   
+   /* Make sure result pointer is not NULL */
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_init: Result pointer was NULL, cannot store result.\n");
+      return NULL;
+   }
+   
+   /* Malloc the list and set the initial size */
+   if ((point_list = malloc(sizeof(Asciip_List))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_init: Could not malloc point list pointer.");
+      return NULL;
+   }
+   
+   /* Set the default values */
+   point_list->size = 0;
+   point_list->head = NULL;
+   point_list->tail = NULL;
+   point_list->pool = NULL;
+   point_list->index = NULL;
+   point_list->keep_sorted = 0;
+   point_list->summary = NULL;
+   
+   /* Add the initial point if its not NULL */
+   if (init_point != NULL)
+   {
+      point_list->size++;
+      
+      /* Create node for point to go into */
+      if ((nodep = malloc(sizeof(Asciip_Node))) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_init: Could not allocate memory to new node.\n");
+         return NULL;
+      }
+      
+      /* Save data and set list parameters */
+      nodep->data = init_point;
+      nodep->next = NULL;
+      point_list->head = nodep;
+      point_list->tail = nodep;
+   }
+   
+   *result = point_list;
+   return point_list;
+}
+
+/************************************************************************
+ * Name        : asciip_list_init_pooled
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Initializes a new empty Ascii_List that owns a pool
+ *               that every node and point is carved from.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/ 
+Asciip_List *asciip_list_init_pooled(size_t         block_points,
+                                     Asciip_List  **result,
+                                     Asciip_Error  *error)
+{
+   Asciip_List *point_list;
+   size_t       object_size;
+   
+   if (asciip_list_init(NULL, &point_list, error) == NULL)
+   {
+      /* Error reporting done in function */
+      return NULL;
+   }
+   
+   /* Nodes and points share the pool, one node and one point per list point */
+   object_size = (sizeof(Asciip_Node) > sizeof(Asciip_Point)) ? sizeof(Asciip_Node) : sizeof(Asciip_Point);
+   if (asciip_pool_init(object_size, 2 * block_points, &point_list->pool, error) == NULL)
+   {
+      free(point_list);
+      return NULL;
+   }
+   
+   *result = point_list;
+   return point_list;
+}
+
+/************************************************************************
+ * Name        : asciip_list_destroy
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Releases memory contents held by list. Destroys all
+ *               nodes and points in the list as well.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_destroy(Asciip_List  *list,
+                           Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   Asciip_Node *next_nodep;
+   size_t ind;
+   
+   /* If the list is already NULL we don't need to free anything */
+   if (list == NULL)
+   {
+      return 0;
+   }
+   
+   asciip_list_index_drop(list);
+   asciip_summary_destroy(list->summary);
+   
+   /* Pooled nodes and points go with their blocks, no walk needed
+    * unless another list still shares the pool */
+   if ((list->pool != NULL) && (list->pool->refs == 1))
+   {
+      asciip_pool_destroy(list->pool);
+      free(list);
+      return 0;
+   }
+   
+   /* Walk the nodes once from the front, releasing each point and node */
+   nodep = list->head;
+   for (ind = 0; ind < list->size; ind++)
+   {
+      if (nodep == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_destroy: Found end of list unexpectedly.");
+         return -1;
+      }
+      
+      next_nodep = nodep->next;
+      asciip_list_free_node(list, nodep, 1);
+      nodep = next_nodep;
+   }
+   
+   /* Now free the list struct */
+   asciip_pool_destroy(list->pool);
+   free(list);
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_add
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Adds point to new node and appends it to the back
+ *               of the list.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_add(Asciip_List  *list,
+                       Asciip_Point *point,
+                       Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   Asciip_Point *pooled_point;
+   
+   /* Check values and list are not NULL */
+   if ((list == NULL) || (point == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_add: One of the parameters were NULL.");
+      return -1;
+   }
+   
+   /* Create node first, the caller keeps the point if anything fails */
+   if ((nodep = asciip_list_new_node(list, error)) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_add: Could not create new node for list.");
+      return -1;
+   }
+   
+   /* Pooled lists keep their own copy of the point so every point lives in the pool */
+   if (list->pool != NULL)
+   {
+      if ((pooled_point = asciip_pool_alloc(list->pool, error)) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_add: Could not create point in pool.");
+         asciip_pool_release(list->pool, nodep);
+         return -1;
+      }
+      
+      *pooled_point = *point;
+      asciip_point_destroy(point);
+      point = pooled_point;
+   }
+   
+   nodep->data = point;
+   asciip_list_insert_node(list, nodep, error);
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_add_xy
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Creates the point (x, y) and appends it to the back of
+ *               the list.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_add_xy(Asciip_List  *list,
+                          double        x,
+                          double        y,
+                          Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_add_xy: List was NULL.");
+      return -1;
+   }
+   
+   if ((nodep = asciip_list_new_point_node(list, x, y, error)) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_add_xy: Could not create point.");
+      return -1;
+   }
+   
+   asciip_list_insert_node(list, nodep, error);
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_add_many
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Creates a point for each (xs[i], ys[i]) pair and adds
+ *               them to the list in order.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_add_many(Asciip_List  *list,
+                            const double *xs,
+                            const double *ys,
+                            size_t        count,
+                            Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   size_t ind;
+   
+   if ((list == NULL) || (((xs == NULL) || (ys == NULL)) && (count > 0)))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_add_many: One of the parameters were NULL.");
+      return -1;
+   }
+   
+   for (ind = 0; ind < count; ind++)
+   {
+      if ((nodep = asciip_list_new_point_node(list, xs[ind], ys[ind], error)) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_add_many: Could not create point.");
+         return -1;
+      }
+      
+      asciip_list_insert_node(list, nodep, error);
+   }
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_remove
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Removes point node at the index passed by the user from
+ *               the list. Releases Node memory but not the point. 
+ *               Returns the point that was removed.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+Asciip_Point *asciip_list_remove(Asciip_List  *list,
+                                 size_t        index,
+                                 Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   Asciip_Node *prev_nodep = NULL;
+   Asciip_Point *point;
+   size_t chunk = 0;
+   size_t offset;
+   
+   /* Make sure list is not NULL before continuing */
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_remove: list was NULL, cannot operate on NULL list.");
+      return NULL;
+   }
+
+   /* Check index is valid */
+   if (index >= list->size)
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_remove: Index was not in the bounds of the list.");
+      return NULL;
+   }
+   
+   /* Find the Node user is looking for through its predecessor */
+   if (index == 0)
+   {
+      nodep = list->head;
+   }
+   else
+   {
+      prev_nodep = asciip_list_node_at(list, index - 1, error);
+      nodep = prev_nodep->next;
+   }
+   
+   /* Pooled points are handed back as a heap copy so the caller owns them
+    * as usual, made before anything changes so a failure leaves the list */
+   point = nodep->data;
+   if ((list->pool != NULL) && (asciip_point_init(point->x, point->y, &point, error) == NULL))
+   {
+      /* Error reporting done in function */
+      return NULL;
+   }
+   
+   /* Shrink the chunk holding the node, moving its start past the node */
+   if (list->index != NULL)
+   {
+      chunk = asciip_list_index_find(list->index, index, &offset);
+      if (list->index->first[chunk] == nodep)
+      {
+         list->index->first[chunk] = nodep->next;
+      }
+      asciip_list_index_adjust(list->index, chunk, -1);
+      if (list->index->counts[chunk] == 0)
+      {
+         list->index->empty++;
+         asciip_list_index_compact(list->index);
+      }
+   }
+   
+   /* Remove the Node and decrease the size */
+   list->size--;
+   if (index == 0)
+   {
+      /* If the HEAD needs to be removed it is a special case */
+      list->head = nodep->next;
+   }
+   else 
+   {
+      /* Otherwise remove node and set previous node to point to node after one removed */
+      prev_nodep->next = nodep->next;
+   }
+   
+   /* Removing the TAIL moves it back to the previous node (NULL when now empty) */
+   if (nodep == list->tail)
+   {
+      list->tail = prev_nodep;
+   }
+   
+   nodep->next = NULL;
+   asciip_summary_remove(list->summary, point->x, point->y);
+   
+   /* Release memory held by Node and return data */
+   asciip_list_free_node(list, nodep, (list->pool != NULL));
+   
+   return point;
+}
+
+/************************************************************************
+ * Name        : asciip_list_take_next
+ * 
+ * Description : Unlinks the node after prev_nodep (the head when NULL)
+ *               and moves its point to removed, or releases it when
+ *               removed is NULL. Leaves the node linked if removed 
+ *               cannot take the point. The caller fixes the tail and
+ *               drops the index.
+ ************************************************************************/ 
+static int8_t asciip_list_take_next(Asciip_List  *list,
+                                    Asciip_Node  *prev_nodep,
+                                    Asciip_List  *removed,
+                                    Asciip_Error *error)
+{
+   Asciip_Node *nodep = (prev_nodep == NULL) ? list->head : prev_nodep->next;
+   uint8_t move_node = (removed != NULL) && (list->pool == NULL) && (removed->pool == NULL);
+   
+   /* Points that cannot move with their node are copied before unlinking */
+   if ((removed != NULL) && !move_node &&
+       (asciip_list_add_xy(removed, nodep->data->x, nodep->data->y, error) != 0))
+   {
+      return -1;
+   }
+   
+   if (prev_nodep == NULL)
+   {
+      list->head = nodep->next;
+   }
+   else
+   {
+      prev_nodep->next = nodep->next;
+   }
+   list->size--;
+   nodep->next = NULL;
+   asciip_summary_remove(list->summary, nodep->data->x, nodep->data->y);
+   
+   if (move_node)
+   {
+      asciip_list_insert_node(removed, nodep, error);
+   }
+   else
+   {
+      asciip_list_free_node(list, nodep, 1);
+   }
+   
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_fix_tail
+ * 
+ * Description : Points the tail at last_nodep if a batch removal left
+ *               it at the end of the list.
+ ************************************************************************/ 
+static void asciip_list_fix_tail(Asciip_List *list,
+                                 Asciip_Node *last_nodep)
+{
+   if (list->head == NULL)
+   {
+      list->tail = NULL;
+   }
+   else if ((last_nodep != NULL) && (last_nodep->next == NULL))
+   {
+      list->tail = last_nodep;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_list_outside
+ * 
+ * Description : Predicate selecting points with x outside [lo, hi),
+ *               context holds lo and hi.
+ ************************************************************************/ 
+static uint8_t asciip_list_outside(double  x,
+                                   double  y,
+                                   void   *context)
+{
+   const double *bounds = context;
+   
+   (void)y;
+   return !((x >= bounds[0]) && (x < bounds[1]));
+}
+
+/************************************************************************
+ * Name        : asciip_list_remove_range
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Removes count points starting at index in one pass.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_remove_range(Asciip_List  *list,
+                                size_t        index,
+                                size_t        count,
+                                Asciip_List  *removed,
+                                Asciip_Error *error)
+{
+   Asciip_Node *prev_nodep = NULL;
+   int8_t status = 0;
+   
+   if ((list == NULL) || (list == removed))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_remove_range: Bad list.");
+      return -1;
+   }
+   
+   if ((index > list->size) || (count > list->size - index))
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_remove_range: Range out of bounds.");
+      return -1;
+   }
+   
+   if (count == 0)
+   {
+      return 0;
+   }
+   
+   if (index > 0)
+   {
+      prev_nodep = asciip_list_node_at(list, index - 1, error);
+   }
+   
+   /* The index is rebuilt on the next indexed access */
+   asciip_list_index_drop(list);
+   
+   for (; count > 0; count--)
+   {
+      if ((status = asciip_list_take_next(list, prev_nodep, removed, error)) != 0)
+      {
+         break;
+      }
+   }
+   
+   asciip_list_fix_tail(list, prev_nodep);
+   
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_list_remove_outside
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Removes every point with x outside [lo, hi).
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_remove_outside(Asciip_List  *list,
+                                  double        lo,
+                                  double        hi,
+                                  Asciip_List  *removed,
+                                  Asciip_Error *error)
+{
+   double bounds[2];
+   
+   bounds[0] = lo;
+   bounds[1] = hi;
+   
+   return asciip_list_remove_if(list, asciip_list_outside, bounds, removed, error);
+}
+
+/************************************************************************
+ * Name        : asciip_list_remove_if
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Removes every point pred selects in one pass.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_remove_if(Asciip_List       *list,
+                             Asciip_Point_Pred  pred,
+                             void              *context,
+                             Asciip_List       *removed,
+                             Asciip_Error      *error)
+{
+   Asciip_Node *prev_nodep = NULL;
+   Asciip_Node *nodep;
+   int8_t status = 0;
+   
+   if ((list == NULL) || (pred == NULL) || (list == removed))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_remove_if: Bad list or predicate.");
+      return -1;
+   }
+   
+   asciip_list_index_drop(list);
+   
+   /* prev_nodep trails as the last kept node */
+   for (nodep = list->head; nodep != NULL; )
+   {
+      if (!pred(nodep->data->x, nodep->data->y, context))
+      {
+         prev_nodep = nodep;
+         nodep = nodep->next;
+         continue;
+      }
+      
+      if ((status = asciip_list_take_next(list, prev_nodep, removed, error)) != 0)
+      {
+         break;
+      }
+      nodep = (prev_nodep == NULL) ? list->head : prev_nodep->next;
+   }
+   
+   asciip_list_fix_tail(list, prev_nodep);
+   
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_list_get
+ * 
+ * See         : asciip_lists.h
+ * 
  * Description : Retrieves the point at the index passed from the user
  *               and returns the point found.
- *
+ * 
  *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+Asciip_Point *asciip_list_get(Asciip_List  *list,
+                              size_t        index,
+                              Asciip_Point *result,
+                              Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   
+   /* Make sure list is not NULL */
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_get: List was NULL, cannot find index.\n");
+      return NULL;
+   }
+
+   /* Check index is valid */
+   if (index >= list->size)
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_get: Index was not in the bounds of the list.");
+      return NULL;
+   }
+
+   nodep = asciip_list_node_at(list, index, error);
+   
+   result = nodep->data;
+   return result;
+}
+
+/************************************************************************
+ * Name        : asciip_list_index_chunks
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Returns the number of chunks in the random access 
+ *               index, 0 when it is not built.
+ ************************************************************************/                              
+size_t asciip_list_index_chunks(const Asciip_List *list)
+{
+   return ((list == NULL) || (list->index == NULL)) ? 0 : list->index->chunks;
+}
+
+/************************************************************************
+ * Name        : asciip_merge_list
  *
- * Parameters  : list   - List to find point in.
- *               index  - Index in list to get point from.
- *               result - Point retrieved from list.
- *               error  - Error tracker to hold errors that occur
- *                        in the method call.
+ * Description : Merges two x-sorted node chains into one. On equal x
+ *               nodes from list1 come first, so the merge is stable.
  *
- * Returns     : NULL        - There was an error getting index from
- *                             list.
- *               Ascii_Point - Point retrieved from list.
+ * Parameters  : list1 - Chain holding the earlier nodes.
+ *               list2 - Chain holding the later nodes.
+ *
+ * Returns     : Head of the merged chain.
  *
  ************************************************************************/
 static Asciip_Node* asciip_merge_list(Asciip_Node *list1,
                                       Asciip_Node *list2)
 {
-    Asciip_Node  dummy_head;
-    Asciip_Node *tail = &dummy_head;
-    Asciip_Node **min;
-    Asciip_Node *next;
+    Asciip_Node  dummy_head;
+    Asciip_Node *tail = &dummy_head;
+    Asciip_Node **min;
+    Asciip_Node *next;
+
+    while ((list1 != NULL) && (list2 != NULL))
+    {
+        min = (list2->data->x < list1->data->x) ? &list2 : &list1;
+        next = (*min)->next;
+        tail = tail->next = *min;
+        *min = next;
+    }
+
+    tail->next = list1 ? list1 : list2;
+    return dummy_head.next;
+}
+
+/************************************************************************
+ * Name        : asciip_merge_sort
+ *
+ * Description : Stable bottom-up merge sort of a node chain. Bin i holds
+ *               a sorted run of 2^i nodes; each node is carried up 
+ *               through the bins, so no midpoint walks are needed.
+ ************************************************************************/
+static Asciip_Node *asciip_merge_sort(Asciip_Node *head)
+{
+   Asciip_Node *bins[64] = { NULL };
+   Asciip_Node *run;
+   Asciip_Node *result = NULL;
+   uint8_t      bin;
+
+   while (head != NULL)
+   {
+      run = head;
+      head = head->next;
+      run->next = NULL;
+
+      /* Earlier nodes sit in the bins, so they go first in each merge */
+      for (bin = 0; (bin < 63) && (bins[bin] != NULL); bin++)
+      {
+         run = asciip_merge_list(bins[bin], run);
+         bins[bin] = NULL;
+      }
+      bins[bin] = (bins[bin] == NULL) ? run : asciip_merge_list(bins[bin], run);
+   }
+
+   /* Higher bins hold earlier nodes */
+   for (bin = 0; bin < 64; bin++)
+   {
+      if (bins[bin] != NULL)
+      {
+         result = asciip_merge_list(bins[bin], result);
+      }
+   }
+
+   return result;
+}
+
+/************************************************************************
+ * Name        : asciip_radix_sort
+ *
+ * Description : Sorts the nodes of a list by gathering (key, node) pairs
+ *               into arrays, sorting them with the radix engine and
+ *               relinking the nodes in the sorted order.
+ ************************************************************************/
+static int8_t asciip_radix_sort(Asciip_List  *list,
+                                Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   uint64_t *keys;
+   uint64_t *nodes;
+   size_t ind;
+
+   keys = malloc(list->size * sizeof(uint64_t));
+   nodes = malloc(list->size * sizeof(uint64_t));
+   if ((keys == NULL) || (nodes == NULL))
+   {
+      free(keys);
+      free(nodes);
+      return -1;
+   }
+
+   nodep = list->head;
+   for (ind = 0; ind < list->size; ind++)
+   {
+      keys[ind] = asciip_sort_key(nodep->data->x);
+      nodes[ind] = (uint64_t)(uintptr_t)nodep;
+      nodep = nodep->next;
+   }
+
+   if (asciip_sort_radix(keys, nodes, list->size, 0, error) != 0)
+   {
+      free(keys);
+      free(nodes);
+      return -1;
+   }
+
+   for (ind = 0; ind + 1 < list->size; ind++)
+   {
+      ((Asciip_Node *)(uintptr_t)nodes[ind])->next = (Asciip_Node *)(uintptr_t)nodes[ind + 1];
+   }
+   list->head = (Asciip_Node *)(uintptr_t)nodes[0];
+   list->tail = (Asciip_Node *)(uintptr_t)nodes[list->size - 1];
+   list->tail->next = NULL;
+
+   free(keys);
+   free(nodes);
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_sort
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Sorts the list of points based on the x value of the 
+ *               point from lowest to highest.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_sort(Asciip_List  *list,
+                        Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+
+   /* Can't sort NULL list */
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_sort: List was NULL, cannot sort.\n");
+      return -1;
+   }
+
+   if (list->size < 2)
+   {
+      return 0;
+   }
+
+   /* The index no longer matches the order */
+   asciip_list_index_drop(list);
+
+   /* Large lists go through the radix engine, small ones or a failed
+    * scratch allocation fall back to merging the nodes in place */
+   if ((list->size >= ASCIIP_LIST_RADIX_MIN) && (asciip_radix_sort(list, error) == 0))
+   {
+      return 0;
+   }
+
+   /* Set the new head and tail of the list */
+   nodep = asciip_merge_sort(list->head);
+   list->head = nodep;
+   while (nodep->next != NULL)
+   {
+      nodep = nodep->next;
+   }
+   list->tail = nodep;
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_keep_sorted
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Turns keep sorted mode on or off. Turning it on sorts
+ *               the list once.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_keep_sorted(Asciip_List  *list,
+                               uint8_t       enable,
+                               Asciip_Error *error)
+{
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_keep_sorted: List was NULL.");
+      return -1;
+   }
+   
+   if (enable && !list->keep_sorted && (asciip_list_sort(list, error) != 0))
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+   
+   list->keep_sorted = (enable != 0);
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_list_in_order
+ * 
+ * Description : Returns 1 if the list is ordered by x as the merge
+ *               expects, in one walk that stops at the first point out
+ *               of place.
+ ************************************************************************/ 
+static uint8_t asciip_list_in_order(const Asciip_List *list)
+{
+   Asciip_Node *nodep;
+   
+   if (list->keep_sorted)
+   {
+      return 1;
+   }
+   
+   for (nodep = list->head; (nodep != NULL) && (nodep->next != NULL); nodep = nodep->next)
+   {
+      if (asciip_sort_key(nodep->next->data->x) < asciip_sort_key(nodep->data->x))
+      {
+         return 0;
+      }
+   }
+   
+   return 1;
+}
+
+/************************************************************************
+ * Name        : asciip_list_pop_head
+ * 
+ * Description : Unlinks and returns the head node of a non-empty list.
+ *               The caller drops the index first.
+ ************************************************************************/ 
+static Asciip_Node *asciip_list_pop_head(Asciip_List *list)
+{
+   Asciip_Node *nodep = list->head;
+   
+   list->head = nodep->next;
+   if (list->head == NULL)
+   {
+      list->tail = NULL;
+   }
+   list->size--;
+   nodep->next = NULL;
+   
+   return nodep;
+}
 
-    while ((list1 != NULL) && (list2 != NULL))
-    {
-        min = (list1->data->x < list2->data->x) ? &list1 : &list2;
-        next = (*min)->next;
-        tail = tail->next = *min;
-        *min = next;
-    }
+/************************************************************************
+ * Name        : asciip_list_claim_head
+ * 
+ * Description : Takes the head node of other for use in list. The node
+ *               itself moves when both lists share storage, otherwise
+ *               its point is copied into list's storage and the node 
+ *               released. Other is unchanged if the copy fails.
+ ************************************************************************/ 
+static Asciip_Node *asciip_list_claim_head(Asciip_List  *list,
+                                           Asciip_List  *other,
+                                           Asciip_Error *error)
+{
+   Asciip_Node *nodep;
+   
+   if (list->pool == other->pool)
+   {
+      return asciip_list_pop_head(other);
+   }
+   
+   if ((nodep = asciip_list_new_point_node(list, other->head->data->x, other->head->data->y, error)) == NULL)
+   {
+      return NULL;
+   }
+   
+   asciip_list_free_node(other, asciip_list_pop_head(other), 1);
+   return nodep;
+}
 
-    tail->next = list1 ? list1 : list2;
-    return dummy_head.next;
+/************************************************************************
+ * Name        : asciip_list_merge_less
+ * 
+ * Description : Heap order for the merge: smaller head key first, the
+ *               earlier run on ties so the merge is stable.
+ ************************************************************************/ 
+static uint8_t asciip_list_merge_less(const Asciip_List_Merge_Run *a,
+                                      const Asciip_List_Merge_Run *b)
+{
+   return (a->key < b->key) || ((a->key == b->key) && (a->run < b->run));
 }
 
-static Asciip_Node *asciip_merge_sort(Asciip_Node *head,
-                                      uint16_t list_size,
-                                      Asciip_Error *error)
+/************************************************************************
+ * Name        : asciip_list_merge_sift
+ * 
+ * Description : Restores the heap order below pos after its key grew.
+ ************************************************************************/ 
+static void asciip_list_merge_sift(Asciip_List_Merge_Run *heap,
+                                   size_t                 size,
+                                   size_t                 pos)
 {
-   Asciip_Node *list1 = head;
-   Asciip_Node *list2;
-   Asciip_Node *middlep;
-   uint16_t     new_list_size;
+   Asciip_List_Merge_Run entry = heap[pos];
+   size_t child;
+   
+   while ((child = 2 * pos + 1) < size)
+   {
+      if ((child + 1 < size) && asciip_list_merge_less(&heap[child + 1], &heap[child]))
+      {
+         child++;
+      }
+      
+      if (!asciip_list_merge_less(&heap[child], &entry))
+      {
+         break;
+      }
+      
+      heap[pos] = heap[child];
+      pos = child;
+   }
+   
+   heap[pos] = entry;
+}
 
-   if ((list1 == NULL) || (list1->next == NULL))
+/************************************************************************
+ * Name        : asciip_list_splice
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Moves every point of other into list in front of the
+ *               point at index, leaving other empty.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_splice(Asciip_List  *list,
+                          size_t        index,
+                          Asciip_List  *other,
+                          Asciip_Error *error)
+{
+   Asciip_Node *prev_nodep = NULL;
+   Asciip_Node *next_nodep;
+   Asciip_Node *nodep;
+   
+   if ((list == NULL) || (other == NULL) || (list == other))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_splice: Bad list.");
+      return -1;
+   }
+   
+   if (index > list->size)
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_splice: Index out of bounds.");
+      return -1;
+   }
+   
+   if (other->size == 0)
+   {
+      return 0;
+   }
+   
+   /* The merge needs other in order too, which splice does not ask of it */
+   if (list->keep_sorted)
+   {
+      if (!asciip_list_in_order(other) && (asciip_list_sort(other, error) != 0))
+      {
+         return -1;
+      }
+      return asciip_list_merge(list, &other, 1, error);
+   }
+   
+   if (index > 0)
+   {
+      prev_nodep = asciip_list_node_at(list, index - 1, error);
+   }
+   asciip_list_index_drop(list);
+   asciip_list_index_drop(other);
+   asciip_summary_invalidate(list->summary);
+   asciip_summary_invalidate(other->summary);
+   
+   /* Shared storage relinks the whole run at once */
+   if (list->pool == other->pool)
+   {
+      next_nodep = (prev_nodep == NULL) ? list->head : prev_nodep->next;
+      other->tail->next = next_nodep;
+      if (prev_nodep == NULL)
+      {
+         list->head = other->head;
+      }
+      else
+      {
+         prev_nodep->next = other->head;
+      }
+      
+      if (next_nodep == NULL)
+      {
+         list->tail = other->tail;
+      }
+      
+      list->size += other->size;
+      other->head = NULL;
+      other->tail = NULL;
+      other->size = 0;
+      return 0;
+   }
+   
+   while (other->head != NULL)
    {
-       return list1;
+      if ((nodep = asciip_list_claim_head(list, other, error)) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_splice: Could not copy point.");
+         return -1;
+      }
+      
+      next_nodep = (prev_nodep == NULL) ? list->head : prev_nodep->next;
+      nodep->next = next_nodep;
+      if (prev_nodep == NULL)
+      {
+         list->head = nodep;
+      }
+      else
+      {
+         prev_nodep->next = nodep;
+      }
+      
+      if (next_nodep == NULL)
+      {
+         list->tail = nodep;
+      }
+      
+      list->size++;
+      prev_nodep = nodep;
    }
+   
+   return 0;
+}
 
-   new_list_size = list_size / 2;
+/************************************************************************
+ * Name        : asciip_list_concat
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Moves every point of other to the back of list.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+int8_t asciip_list_concat(Asciip_List  *list,
+                          Asciip_List  *other,
+                          Asciip_Error *error)
+{
+   return asciip_list_splice(list, (list == NULL) ? 0 : list->size, other, error);
+}
 
-   /* Split the list in the middle */
-   middlep = asciip_list_get_node(head, new_list_size, &middlep, error);
-   list2 = middlep->next;
-   middlep->next = NULL;
+/************************************************************************
+ * Name        : asciip_list_split
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Moves the points from index to the end of list into a
+ *               new list sharing list's storage.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+Asciip_List *asciip_list_split(Asciip_List   *list,
+                               size_t         index,
+                               Asciip_List  **result,
+                               Asciip_Error  *error)
+{
+   Asciip_List *split_list;
+   Asciip_Node *prev_nodep = NULL;
+   
+   if ((list == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_split: One of the parameters were NULL.");
+      return NULL;
+   }
+   
+   if (index > list->size)
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_list_split: Index out of bounds.");
+      return NULL;
+   }
+   
+   if (asciip_list_init(NULL, &split_list, error) == NULL)
+   {
+      /* Error reporting done in function */
+      return NULL;
+   }
+   split_list->pool = asciip_pool_retain(list->pool);
+   split_list->keep_sorted = list->keep_sorted;
+   
+   if (index == list->size)
+   {
+      *result = split_list;
+      return split_list;
+   }
+   
+   if (index > 0)
+   {
+      prev_nodep = asciip_list_node_at(list, index - 1, error);
+   }
+   asciip_list_index_drop(list);
+   asciip_summary_invalidate(list->summary);
+   
+   split_list->head = (prev_nodep == NULL) ? list->head : prev_nodep->next;
+   split_list->tail = list->tail;
+   split_list->size = list->size - index;
+   
+   if (prev_nodep == NULL)
+   {
+      list->head = NULL;
+   }
+   else
+   {
+      prev_nodep->next = NULL;
+   }
+   list->tail = prev_nodep;
+   list->size = index;
+   
+   *result = split_list;
+   return split_list;
+}
 
-   return asciip_merge_list(asciip_merge_sort(list1, new_list_size, error),
-                            asciip_merge_sort(list2, new_list_size, error));
+/************************************************************************
+ * Name        : asciip_list_split_x
+ * 
+ * See         : ascii_lists.h
+ * 
+ * Description : Splits a list sorted by x in front of the first point
+ *               with x greater than or equal to x.
+ * 
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/                              
+Asciip_List *asciip_list_split_x(Asciip_List   *list,
+                                 double         x,
+                                 Asciip_List  **result,
+                                 Asciip_Error  *error)
+{
+   size_t low = 0;
+   size_t high;
+   size_t mid;
+   
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_split_x: List was NULL.");
+      return NULL;
+   }
+   
+   high = list->size;
+   while (low < high)
+   {
+      mid = low + (high - low) / 2;
+      if (asciip_list_node_at(list, mid, error)->data->x < x)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   
+   return asciip_list_split(list, low, result, error);
 }
 
 /************************************************************************
- * Name        : asciip_list_sort
+ * Name        : asciip_list_merge
  * 
- * See         : asciip_lists.h
+ * See         : ascii_lists.h
  * 
- * Description : Sorts the list of points based on the x value of the 
- *               point from lowest to highest.
+ * Description : Merges count lists sorted by x into list, leaving the
+ *               others empty.
  * 
  *               If error is NULL, the errors will not be tracked.
  ************************************************************************/                              
-int8_t asciip_list_sort(Asciip_List  *list,
-                        Asciip_Error *error)
+int8_t asciip_list_merge(Asciip_List   *list,
+                         Asciip_List  **others,
+                         size_t         count,
+                         Asciip_Error  *error)
 {
+   Asciip_List own;
+   Asciip_List **runs;
+   Asciip_List_Merge_Run *heap;
+   Asciip_List *run;
    Asciip_Node *nodep;
-
-   /* Can't sort NULL list */
-   if (list == NULL)
+   size_t heap_size = 0;
+   size_t pos;
+   size_t ind;
+   int8_t status = 0;
+   
+   if ((list == NULL) || ((others == NULL) && (count > 0)))
    {
-      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_sort: List was NULL, cannot sort.\n");
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_merge: One of the parameters were NULL.");
       return -1;
    }
-
-   if ((nodep = asciip_merge_sort(list->head, list->size, error)) == NULL)
+   
+   for (ind = 0; ind < count; ind++)
    {
-      /* Error reporting done in function */
+      if ((others[ind] == NULL) || (others[ind] == list))
+      {
+         report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_list_merge: Bad list to merge.");
+         return -1;
+      }
+   }
+   
+   runs = malloc((count + 1) * sizeof(Asciip_List *));
+   heap = malloc((count + 1) * sizeof(Asciip_List_Merge_Run));
+   if ((runs == NULL) || (heap == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_list_merge: Could not allocate heap.");
+      free(runs);
+      free(heap);
       return -1;
    }
+   
+   /* The list's own nodes become run 0 and the list is rebuilt from empty */
+   asciip_list_index_drop(list);
+   asciip_summary_invalidate(list->summary);
+   own = *list;
+   list->head = NULL;
+   list->tail = NULL;
+   list->size = 0;
+   
+   runs[0] = &own;
+   for (ind = 0; ind < count; ind++)
+   {
+      asciip_list_index_drop(others[ind]);
+      asciip_summary_invalidate(others[ind]->summary);
+      runs[ind + 1] = others[ind];
+   }
+   
+   /* Seed the heap with every non-empty run, sifting each entry up */
+   for (ind = 0; ind <= count; ind++)
+   {
+      if (runs[ind]->head == NULL)
+      {
+         continue;
+      }
+      
+      pos = heap_size++;
+      heap[pos].key = asciip_sort_key(runs[ind]->head->data->x);
+      heap[pos].run = ind;
+      while ((pos > 0) && asciip_list_merge_less(&heap[pos], &heap[(pos - 1) / 2]))
+      {
+         Asciip_List_Merge_Run swap = heap[pos];
+         
+         heap[pos] = heap[(pos - 1) / 2];
+         heap[(pos - 1) / 2] = swap;
+         pos = (pos - 1) / 2;
+      }
+   }
+   
+   while (heap_size > 0)
+   {
+      run = runs[heap[0].run];
+      if ((nodep = asciip_list_claim_head(list, run, error)) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_list_merge: Could not copy point.");
+         status = -1;
+         break;
+      }
+      asciip_list_append_node(list, nodep);
+      
+      if (run->head != NULL)
+      {
+         heap[0].key = asciip_sort_key(run->head->data->x);
+      }
+      else
+      {
+         heap[0] = heap[--heap_size];
+      }
+      asciip_list_merge_sift(heap, heap_size, 0);
+   }
+   
+   /* After a failure the rest of the list's own nodes go back on the end */
+   if (own.head != NULL)
+   {
+      if (list->tail == NULL)
+      {
+         list->head = own.head;
+      }
+      else
+      {
+         list->tail->next = own.head;
+      }
+      list->tail = own.tail;
+      list->size += own.size;
+   }
+   
+   free(runs);
+   free(heap);
+   
+   return status;
+}
 
-   /* Set the new head of the list */
-   list->head = nodep;
-
-   return 0;
+/************************************************************************
+ * Name        : asciip_list_iter_read
+ * 
+ * See         : asciip_lists.h
+ * 
+ * Description : Copies up to max points from the iterator into the
+ *               caller's x and y buffers and advances past them.
+ ************************************************************************/                              
+size_t asciip_list_iter_read(Asciip_List_Iter *iter,
+                             double           *xs,
+                             double           *ys,
+                             size_t            max)
+{
+   Asciip_Node *nodep = iter->node;
+   size_t count;
+   
+   for (count = 0; (count < max) && (nodep != NULL); count++)
+   {
+      xs[count] = nodep->data->x;
+      ys[count] = nodep->data->y;
+      nodep = nodep->next;
+   }
    
+   iter->node = nodep;
+   return count;
 }
 
 /************************************************************************
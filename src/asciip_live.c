@@ -0,0 +1,314 @@
+/************************************************************************
+ *
+ * File        : asciip_live.c
+ *
+ * Description : Contains methods to tail a stream of points on screen,
+ *               redrawing at a fixed frame rate.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_live.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+#define ASCIIP_LIVE_NS_PER_SEC 1000000000ULL
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_live_now
+ *
+ * Description : Reads the monotonic clock in nanoseconds.
+ ************************************************************************/
+static uint64_t asciip_live_now(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (uint64_t)now.tv_sec * ASCIIP_LIVE_NS_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+/************************************************************************
+ * Name        : asciip_live_bounds
+ *
+ * Description : Gets the extents of both runs of the ring.
+ ************************************************************************/
+static void asciip_live_bounds(const Asciip_Ring *ring,
+                               Asciip_Bounds     *bounds)
+{
+   Asciip_Series_View runs[2];
+   Asciip_Bounds other;
+   uint8_t isa = asciip_stats_isa();
+
+   asciip_ring_runs(ring, runs);
+   asciip_stats_column(runs[0].x, runs[0].size, isa, &bounds->x);
+   asciip_stats_column(runs[0].y, runs[0].size, isa, &bounds->y);
+   asciip_stats_column(runs[1].x, runs[1].size, isa, &other.x);
+   asciip_stats_column(runs[1].y, runs[1].size, isa, &other.y);
+   asciip_stats_merge(&bounds->x, &other.x);
+   asciip_stats_merge(&bounds->y, &other.y);
+}
+
+/************************************************************************
+ * Name        : asciip_live_init
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Initializes a live plot.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Live *asciip_live_init(size_t         capacity,
+                              size_t         width,
+                              size_t         height,
+                              uint32_t       fps,
+                              FILE          *stream,
+                              Asciip_Live  **result,
+                              Asciip_Error  *error)
+{
+   pthread_condattr_t attr;
+   Asciip_Live *live;
+
+   if ((stream == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_live_init: One of the parameters were NULL.");
+      return NULL;
+   }
+
+   if (fps == 0)
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_live_init: Frame rate was 0.");
+      return NULL;
+   }
+
+   if ((live = calloc(1, sizeof(Asciip_Live))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_live_init: Could not malloc live plot.");
+      return NULL;
+   }
+
+   fflush(stream);
+   if ((asciip_ring_init(capacity, &live->ring, error) == NULL) ||
+       (asciip_canvas_init(width, height, &live->canvas, error) == NULL) ||
+       (asciip_term_init(fileno(stream), width, height, &live->term, error) == NULL))
+   {
+      /* Error reporting done in function */
+      asciip_ring_destroy(live->ring);
+      asciip_canvas_destroy(live->canvas);
+      free(live);
+      return NULL;
+   }
+
+   live->fps = fps;
+   live->style = ASCIIP_CANVAS_LINES;
+   live->mark = '*';
+   live->running = 1;
+
+   /* Deadlines are on the monotonic clock, so wall clock steps do not
+    * stall or rush the loop */
+   pthread_mutex_init(&live->lock, NULL);
+   pthread_condattr_init(&attr);
+   pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+   pthread_cond_init(&live->wake, &attr);
+   pthread_condattr_destroy(&attr);
+
+   *result = live;
+   return live;
+}
+
+/************************************************************************
+ * Name        : asciip_live_destroy
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Releases the live plot, its ring and its canvas.
+ ************************************************************************/
+void asciip_live_destroy(Asciip_Live *live)
+{
+   if (live == NULL)
+   {
+      return;
+   }
+
+   pthread_mutex_destroy(&live->lock);
+   pthread_cond_destroy(&live->wake);
+   asciip_ring_destroy(live->ring);
+   asciip_canvas_destroy(live->canvas);
+   asciip_term_destroy(live->term);
+   free(live);
+}
+
+/************************************************************************
+ * Name        : asciip_live_push
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Adds points as the newest under the lock.
+ ************************************************************************/
+void asciip_live_push(Asciip_Live  *live,
+                      const double *xs,
+                      const double *ys,
+                      size_t        count)
+{
+   pthread_mutex_lock(&live->lock);
+   asciip_ring_push_many(live->ring, xs, ys, count);
+   pthread_mutex_unlock(&live->lock);
+}
+
+/************************************************************************
+ * Name        : asciip_live_frame
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Draws one frame under the lock, then sends it once
+ *               the lock is released.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_live_frame(Asciip_Live  *live,
+                         Asciip_Error *error)
+{
+   Asciip_Ring *ring;
+   Asciip_Bounds bounds;
+   size_t newest;
+
+   if (live == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_live_frame: Live plot was NULL.");
+      return -1;
+   }
+
+   pthread_mutex_lock(&live->lock);
+   ring = live->ring;
+   if ((live->window > 0.0) && (ring->size > 0))
+   {
+      newest = ring->head + ring->size - 1;
+      newest = (newest < ring->capacity) ? newest : newest - ring->capacity;
+      asciip_ring_evict_before(ring, ring->x[newest] - live->window);
+   }
+
+   /* Extents that cannot be mapped keep the last frame's range */
+   asciip_live_bounds(ring, &bounds);
+   asciip_canvas_fit(live->canvas, &bounds, NULL);
+   asciip_canvas_clear(live->canvas);
+   asciip_canvas_draw_ring(live->canvas, ring, live->style, live->mark, NULL);
+   pthread_mutex_unlock(&live->lock);
+
+   if (asciip_term_draw(live->term, live->canvas, error) != 0)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   live->frames++;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_live_run
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Writes a frame on every deadline until stopped.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_live_run(Asciip_Live  *live,
+                       uint64_t      frames,
+                       Asciip_Error *error)
+{
+   struct timespec deadline;
+   uint64_t period;
+   uint64_t next;
+   uint64_t now;
+   uint64_t skipped;
+   uint64_t written = 0;
+   uint8_t stopped;
+
+   if (live == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_live_run: Live plot was NULL.");
+      return -1;
+   }
+
+   period = ASCIIP_LIVE_NS_PER_SEC / live->fps;
+   next = asciip_live_now();
+
+   pthread_mutex_lock(&live->lock);
+   while (live->running && ((frames == 0) || (written < frames)))
+   {
+      pthread_mutex_unlock(&live->lock);
+      if (asciip_live_frame(live, error) != 0)
+      {
+         return -1;
+      }
+      written++;
+
+      /* Deadlines a slow frame ran past are dropped, not caught up */
+      next += period;
+      now = asciip_live_now();
+      if (now >= next)
+      {
+         skipped = (now - next) / period + 1;
+         next += skipped * period;
+         live->missed += skipped;
+      }
+      deadline.tv_sec = (time_t)(next / ASCIIP_LIVE_NS_PER_SEC);
+      deadline.tv_nsec = (long)(next % ASCIIP_LIVE_NS_PER_SEC);
+
+      pthread_mutex_lock(&live->lock);
+      while (live->running)
+      {
+         if (pthread_cond_timedwait(&live->wake, &live->lock, &deadline) == ETIMEDOUT)
+         {
+            break;
+         }
+      }
+   }
+   stopped = !live->running;
+   pthread_mutex_unlock(&live->lock);
+
+   return stopped ? asciip_live_frame(live, error) : 0;
+}
+
+/************************************************************************
+ * Name        : asciip_live_stop
+ *
+ * See         : asciip_live.h
+ *
+ * Description : Stops the loop and wakes it.
+ ************************************************************************/
+void asciip_live_stop(Asciip_Live *live)
+{
+   pthread_mutex_lock(&live->lock);
+   live->running = 0;
+   pthread_cond_broadcast(&live->wake);
+   pthread_mutex_unlock(&live->lock);
+}
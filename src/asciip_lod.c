@@ -0,0 +1,645 @@
+/************************************************************************
+ *
+ * File        : asciip_lod.c
+ *
+ * Description : Contains methods to keep a level of detail pyramid
+ *               over a series sorted by x.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_lod.h"
+#include "asciip_sched.h"
+#include "asciip_sort.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_lod_start
+ *
+ * Description : Empties a bucket, ready to accumulate.
+ ************************************************************************/
+static inline void asciip_lod_start(Asciip_Lod_Bucket *bucket)
+{
+   bucket->min = NAN;
+   bucket->max = NAN;
+   bucket->min_at = 0;
+   bucket->max_at = 0;
+   bucket->count = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_merge
+ *
+ * Description : Accumulates one bucket into another. Ties go to the
+ *               earlier point, whatever order buckets are merged in.
+ ************************************************************************/
+static inline void asciip_lod_merge(Asciip_Lod_Bucket       *bucket,
+                                    const Asciip_Lod_Bucket *other)
+{
+   if (other->count == 0)
+   {
+      return;
+   }
+
+   if ((bucket->count == 0) || (other->min < bucket->min) ||
+       (!(bucket->min < other->min) && (other->min_at < bucket->min_at)))
+   {
+      bucket->min = other->min;
+      bucket->min_at = other->min_at;
+   }
+   if ((bucket->count == 0) || (other->max > bucket->max) ||
+       (!(bucket->max > other->max) && (other->max_at < bucket->max_at)))
+   {
+      bucket->max = other->max;
+      bucket->max_at = other->max_at;
+   }
+   bucket->count += other->count;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_scan
+ *
+ * Description : Accumulates the points in [lo, hi) into a bucket.
+ ************************************************************************/
+static void asciip_lod_scan(const double      *ys,
+                            size_t             lo,
+                            size_t             hi,
+                            Asciip_Lod_Bucket *bucket)
+{
+   double y;
+
+   for (; lo < hi; lo++)
+   {
+      y = ys[lo];
+      if (!isfinite(y))
+      {
+         continue;
+      }
+
+      if ((bucket->count == 0) || (y < bucket->min))
+      {
+         bucket->min = y;
+         bucket->min_at = lo;
+      }
+      if ((bucket->count == 0) || (y > bucket->max))
+      {
+         bucket->max = y;
+         bucket->max_at = lo;
+      }
+      bucket->count++;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_lod_leaf
+ *
+ * Description : Builds one level 0 bucket. The extremes are found with
+ *               branch free selects, then located with a second pass
+ *               over the same, cached, points.
+ ************************************************************************/
+static void asciip_lod_leaf(const double      *ys,
+                            Asciip_Lod_Bucket *bucket)
+{
+   double min = INFINITY;
+   double max = -INFINITY;
+   double y;
+   size_t count = 0;
+   size_t ind;
+
+   for (ind = 0; ind < ASCIIP_LOD_LEAF; ind++)
+   {
+      y = ys[ind];
+      y = (fabs(y) < INFINITY) ? y : NAN;
+      min = (y < min) ? y : min;
+      max = (y > max) ? y : max;
+      count += (y < INFINITY);
+   }
+
+   asciip_lod_start(bucket);
+   if (count == 0)
+   {
+      return;
+   }
+
+   bucket->min = min;
+   bucket->max = max;
+   bucket->count = count;
+
+   /* Both extremes are present, so neither search runs off the leaf */
+   ind = 0;
+   while ((ys[ind] < min) || (ys[ind] > min) || isnan(ys[ind]))
+   {
+      ind++;
+   }
+   bucket->min_at = ind;
+
+   ind = 0;
+   while ((ys[ind] < max) || (ys[ind] > max) || isnan(ys[ind]))
+   {
+      ind++;
+   }
+   bucket->max_at = ind;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_leaves
+ *
+ * Description : Scheduler body, builds level 0 buckets [begin, end).
+ ************************************************************************/
+static void asciip_lod_leaves(size_t  begin,
+                              size_t  end,
+                              void   *context)
+{
+   Asciip_Lod *lod = context;
+   Asciip_Lod_Bucket *buckets = lod->level[0].buckets;
+   const double *ys = lod->series->y;
+   size_t ind;
+
+   for (ind = begin; ind < end; ind++)
+   {
+      asciip_lod_leaf(ys + ind * ASCIIP_LOD_LEAF, &buckets[ind]);
+      buckets[ind].min_at += ind * ASCIIP_LOD_LEAF;
+      buckets[ind].max_at += ind * ASCIIP_LOD_LEAF;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_lod_build_leaves
+ *
+ * Description : Builds level 0 buckets [begin, end), cut into one chunk
+ *               per build thread on the shared scheduler.
+ ************************************************************************/
+static void asciip_lod_build_leaves(Asciip_Lod *lod,
+                                    size_t      begin,
+                                    size_t      end)
+{
+   size_t count = end - begin;
+   uint32_t threads = lod->threads;
+
+   if (threads == 0)
+   {
+      threads = asciip_sort_threads(count * ASCIIP_LOD_LEAF);
+   }
+
+   asciip_sched_parallel_for(begin, end, (count + threads - 1) / threads, asciip_lod_leaves, lod, NULL);
+}
+
+/************************************************************************
+ * Name        : asciip_lod_grow
+ *
+ * Description : Adds the buckets completed by the points of the series
+ *               not yet summarized. Memory for every level is reserved
+ *               before any bucket is written, so a failure leaves the
+ *               pyramid as it was.
+ ************************************************************************/
+static int8_t asciip_lod_grow(Asciip_Lod *lod)
+{
+   Asciip_Lod_Level *level;
+   Asciip_Lod_Bucket *buckets;
+   size_t want[ASCIIP_LOD_MAX_LEVELS];
+   size_t capacity;
+   size_t ind;
+   uint8_t depth;
+
+   want[0] = lod->series->size / ASCIIP_LOD_LEAF;
+   for (depth = 1; depth < ASCIIP_LOD_MAX_LEVELS; depth++)
+   {
+      want[depth] = want[depth - 1] / 2;
+   }
+
+   for (depth = 0; (depth < ASCIIP_LOD_MAX_LEVELS) && (want[depth] > 0); depth++)
+   {
+      level = &lod->level[depth];
+      if (want[depth] <= level->capacity)
+      {
+         continue;
+      }
+
+      capacity = (2 * level->capacity > want[depth]) ? 2 * level->capacity : want[depth];
+      if ((buckets = realloc(level->buckets, capacity * sizeof(Asciip_Lod_Bucket))) == NULL)
+      {
+         return -1;
+      }
+      level->buckets = buckets;
+      level->capacity = capacity;
+   }
+
+   if (want[0] > lod->level[0].size)
+   {
+      asciip_lod_build_leaves(lod, lod->level[0].size, want[0]);
+      lod->level[0].size = want[0];
+   }
+
+   for (depth = 1; (depth < ASCIIP_LOD_MAX_LEVELS) && (want[depth] > 0); depth++)
+   {
+      level = &lod->level[depth];
+      buckets = lod->level[depth - 1].buckets;
+      for (ind = level->size; ind < want[depth]; ind++)
+      {
+         level->buckets[ind] = buckets[2 * ind];
+         asciip_lod_merge(&level->buckets[ind], &buckets[2 * ind + 1]);
+      }
+      level->size = want[depth];
+   }
+
+   lod->size = lod->series->size;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_range
+ *
+ * Description : Accumulates the points in [lo, hi) into a bucket from
+ *               the fewest aligned buckets that cover them, reading the
+ *               points outside complete level 0 buckets directly.
+ ************************************************************************/
+static void asciip_lod_range(const Asciip_Lod  *lod,
+                             size_t             lo,
+                             size_t             hi,
+                             Asciip_Lod_Bucket *bucket)
+{
+   const double *ys = lod->series->y;
+   size_t full_end;
+   size_t stop;
+   size_t b0;
+   size_t b1;
+   uint8_t depth;
+
+   stop = (lo + ASCIIP_LOD_LEAF - 1) & ~(size_t)(ASCIIP_LOD_LEAF - 1);
+   stop = (stop < hi) ? stop : hi;
+   asciip_lod_scan(ys, lo, stop, bucket);
+   lo = stop;
+
+   full_end = hi & ~(size_t)(ASCIIP_LOD_LEAF - 1);
+   full_end = (full_end < lod->level[0].size * ASCIIP_LOD_LEAF) ? full_end : lod->level[0].size * ASCIIP_LOD_LEAF;
+   if (lo >= full_end)
+   {
+      asciip_lod_scan(ys, lo, hi, bucket);
+      return;
+   }
+   asciip_lod_scan(ys, full_end, hi, bucket);
+
+   /* Climb while peeling unpaired buckets off either end */
+   b0 = lo / ASCIIP_LOD_LEAF;
+   b1 = full_end / ASCIIP_LOD_LEAF;
+   for (depth = 0; b0 < b1; depth++)
+   {
+      if (depth + 1 == ASCIIP_LOD_MAX_LEVELS)
+      {
+         for (; b0 < b1; b0++)
+         {
+            asciip_lod_merge(bucket, &lod->level[depth].buckets[b0]);
+         }
+         break;
+      }
+
+      if (b0 & 1)
+      {
+         asciip_lod_merge(bucket, &lod->level[depth].buckets[b0++]);
+      }
+      if (b1 & 1)
+      {
+         asciip_lod_merge(bucket, &lod->level[depth].buckets[--b1]);
+      }
+      b0 >>= 1;
+      b1 >>= 1;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_lod_column_start
+ *
+ * Description : Finds the first index in [lo, hi) whose point lies in
+ *               column at or after the given one.
+ ************************************************************************/
+static size_t asciip_lod_column_start(const double *xs,
+                                      size_t        lo,
+                                      size_t        hi,
+                                      double        x_min,
+                                      double        x_scale,
+                                      size_t        column)
+{
+   size_t mid;
+
+   while (lo < hi)
+   {
+      mid = lo + (hi - lo) / 2;
+      if ((xs[mid] - x_min) * x_scale < (double)column)
+      {
+         lo = mid + 1;
+      }
+      else
+      {
+         hi = mid;
+      }
+   }
+
+   return lo;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_view
+ *
+ * Description : Finds the index range of the points with x in
+ *               [x_min, x_max].
+ ************************************************************************/
+static void asciip_lod_view(const Asciip_Lod *lod,
+                            double            x_min,
+                            double            x_max,
+                            size_t           *lo,
+                            size_t           *hi)
+{
+   const double *xs = lod->series->x;
+   size_t low = 0;
+   size_t high = lod->size;
+   size_t mid;
+
+   while (low < high)
+   {
+      mid = low + (high - low) / 2;
+      if (xs[mid] < x_min)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   *lo = low;
+
+   high = lod->size;
+   while (low < high)
+   {
+      mid = low + (high - low) / 2;
+      if (xs[mid] > x_max)
+      {
+         high = mid;
+      }
+      else
+      {
+         low = mid + 1;
+      }
+   }
+   *hi = low;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_init
+ *
+ * See         : asciip_lod.h
+ *
+ * Description : Builds a pyramid over every point of a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Lod *asciip_lod_init(const Asciip_Series  *series,
+                            uint32_t              threads,
+                            Asciip_Lod          **result,
+                            Asciip_Error         *error)
+{
+   Asciip_Lod *lod;
+
+   if ((series == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_lod_init: One of the parameters were NULL.");
+      return NULL;
+   }
+
+   if ((lod = calloc(1, sizeof(Asciip_Lod))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_lod_init: Could not malloc pyramid.");
+      return NULL;
+   }
+
+   lod->series = series;
+   lod->threads = threads;
+   if (asciip_lod_grow(lod) != 0)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_lod_init: Could not malloc buckets.");
+      asciip_lod_destroy(lod);
+      return NULL;
+   }
+
+   *result = lod;
+   return lod;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_destroy
+ *
+ * See         : asciip_lod.h
+ *
+ * Description : Releases the pyramid.
+ ************************************************************************/
+void asciip_lod_destroy(Asciip_Lod *lod)
+{
+   uint8_t depth;
+
+   if (lod == NULL)
+   {
+      return;
+   }
+
+   for (depth = 0; depth < ASCIIP_LOD_MAX_LEVELS; depth++)
+   {
+      free(lod->level[depth].buckets);
+   }
+   free(lod);
+}
+
+/************************************************************************
+ * Name        : asciip_lod_update
+ *
+ * See         : asciip_lod.h
+ *
+ * Description : Catches the pyramid up with points appended to the
+ *               series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_lod_update(Asciip_Lod   *lod,
+                         Asciip_Error *error)
+{
+   uint8_t depth;
+
+   if (lod == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_lod_update: Pyramid was NULL.");
+      return -1;
+   }
+
+   /* Removed points may have moved any bucket, start over */
+   if (lod->series->size < lod->size)
+   {
+      for (depth = 0; depth < ASCIIP_LOD_MAX_LEVELS; depth++)
+      {
+         lod->level[depth].size = 0;
+      }
+      lod->size = 0;
+   }
+
+   if (asciip_lod_grow(lod) != 0)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_lod_update: Could not malloc buckets.");
+      return -1;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_query
+ *
+ * See         : asciip_lod.h
+ *
+ * Description : Reduces the points in an x range to one bucket per
+ *               column.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_lod_query(const Asciip_Lod  *lod,
+                        double             x_min,
+                        double             x_max,
+                        size_t             columns,
+                        Asciip_Lod_Bucket *result,
+                        Asciip_Error      *error)
+{
+   double x_scale;
+   size_t column;
+   size_t lo;
+   size_t hi;
+   size_t end;
+
+   if ((lod == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_lod_query: One of the parameters were NULL.");
+      return -1;
+   }
+
+   if ((columns == 0) || !isfinite(x_max - x_min) || !(x_max > x_min))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_lod_query: Range was empty.");
+      return -1;
+   }
+
+   x_scale = (double)columns / (x_max - x_min);
+   asciip_lod_view(lod, x_min, x_max, &lo, &hi);
+   for (column = 0; column < columns; column++)
+   {
+      end = (column + 1 == columns) ? hi : asciip_lod_column_start(lod->series->x, lo, hi, x_min, x_scale, column + 1);
+      asciip_lod_start(&result[column]);
+      asciip_lod_range(lod, lo, end, &result[column]);
+      lo = end;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_lod_output
+ *
+ * See         : asciip_lod.h
+ *
+ * Description : Appends the points a view needs to a series, in x
+ *               order.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_lod_output(const Asciip_Lod *lod,
+                         double            x_min,
+                         double            x_max,
+                         size_t            columns,
+                         Asciip_Series    *result,
+                         Asciip_Error     *error)
+{
+   Asciip_Lod_Bucket bucket;
+   const double *xs;
+   const double *ys;
+   double x_scale;
+   size_t column;
+   size_t first;
+   size_t second;
+   size_t lo;
+   size_t hi;
+   size_t end;
+   int8_t status = 0;
+
+   if ((lod == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_lod_output: One of the parameters were NULL.");
+      return -1;
+   }
+
+   if ((columns == 0) || !isfinite(x_max - x_min) || !(x_max > x_min))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_lod_output: Range was empty.");
+      return -1;
+   }
+
+   xs = lod->series->x;
+   ys = lod->series->y;
+   x_scale = (double)columns / (x_max - x_min);
+   asciip_lod_view(lod, x_min, x_max, &lo, &hi);
+
+   if (lo > 0)
+   {
+      status = asciip_series_add(result, xs[lo - 1], ys[lo - 1], error);
+   }
+
+   for (column = 0; (column < columns) && (status == 0); column++)
+   {
+      end = (column + 1 == columns) ? hi : asciip_lod_column_start(xs, lo, hi, x_min, x_scale, column + 1);
+      asciip_lod_start(&bucket);
+      asciip_lod_range(lod, lo, end, &bucket);
+      lo = end;
+
+      if (bucket.count == 0)
+      {
+         continue;
+      }
+
+      first = (bucket.min_at < bucket.max_at) ? bucket.min_at : bucket.max_at;
+      second = (bucket.min_at < bucket.max_at) ? bucket.max_at : bucket.min_at;
+      status = asciip_series_add(result, xs[first], ys[first], error);
+      if ((status == 0) && (second != first))
+      {
+         status = asciip_series_add(result, xs[second], ys[second], error);
+      }
+   }
+
+   if ((status == 0) && (hi < lod->size))
+   {
+      status = asciip_series_add(result, xs[hi], ys[hi], error);
+   }
+
+   return status;
+}
@@ -0,0 +1,717 @@
+/************************************************************************
+ *
+ * File        : asciip_parse.c
+ *
+ * Description : Contains methods to parse text of x/y pairs into
+ *               points.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_parse.h"
+#include "asciip_sched.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Mantissas are gathered while below this, so one more digit fits */
+#define ASCIIP_PARSE_MANTISSA_MAX 1000000000000000000ull
+
+/* Largest mantissa a double holds exactly */
+#define ASCIIP_PARSE_EXACT_MAX (1ull << 53)
+
+/* Largest characters copied for strtod */
+#define ASCIIP_PARSE_FALLBACK 128
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_parse_worker_t
+{
+   const char         *text;     /* Chunk of whole lines */
+   size_t              length;   /* Bytes of the chunk */
+   Asciip_Series      *series;   /* Series the chunk is appended to */
+   Asciip_Parse_Stats  stats;    /* Lines and points of the chunk */
+   int8_t              status;   /* -1 if the series could not grow */
+
+} Asciip_Parse_Worker;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/* Powers of ten that are exact as doubles */
+static const double asciip_parse_pow10[] =
+{
+   1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_parse_blank
+ *
+ * Description : Checks for a space or tab.
+ ************************************************************************/
+static inline uint8_t asciip_parse_blank(char c)
+{
+   return (c == ' ') || (c == '\t');
+}
+
+/************************************************************************
+ * Name        : asciip_parse_fallback
+ *
+ * Description : Parses a number at text with strtod, through a copy so
+ *               that nothing past end is read.
+ ************************************************************************/
+static const char *asciip_parse_fallback(const char *text,
+                                         const char *end,
+                                         double     *result)
+{
+   char copy[ASCIIP_PARSE_FALLBACK];
+   size_t length = (size_t)(end - text);
+   char *stop;
+
+   if (length > ASCIIP_PARSE_FALLBACK - 1)
+   {
+      length = ASCIIP_PARSE_FALLBACK - 1;
+   }
+
+   memcpy(copy, text, length);
+   copy[length] = '\0';
+   *result = strtod(copy, &stop);
+
+   return (stop == copy) ? NULL : text + (stop - copy);
+}
+
+/************************************************************************
+ * Name        : asciip_parse_number
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Parses one number at the start of text, reading no
+ *               further than end.
+ ************************************************************************/
+const char *asciip_parse_number(const char *text,
+                                const char *end,
+                                double     *result)
+{
+   const char *pos = text;
+   const char *mark;
+   uint64_t mantissa = 0;
+   int32_t scale = 0;
+   int32_t power = 0;
+   uint8_t digits = 0;
+   uint8_t exact = 1;
+   uint8_t negative = 0;
+   uint8_t below;
+   unsigned digit;
+
+   if ((pos < end) && ((*pos == '-') || (*pos == '+')))
+   {
+      negative = (*pos == '-');
+      pos++;
+   }
+
+   for (; (pos < end) && ((digit = (unsigned)(*pos - '0')) < 10); pos++)
+   {
+      digits = 1;
+      if (mantissa < ASCIIP_PARSE_MANTISSA_MAX)
+      {
+         mantissa = 10 * mantissa + digit;
+      }
+      else
+      {
+         exact = 0;
+      }
+   }
+
+   if ((pos < end) && (*pos == '.'))
+   {
+      for (pos++; (pos < end) && ((digit = (unsigned)(*pos - '0')) < 10); pos++)
+      {
+         digits = 1;
+         if (mantissa < ASCIIP_PARSE_MANTISSA_MAX)
+         {
+            mantissa = 10 * mantissa + digit;
+            scale--;
+         }
+      }
+   }
+
+   /* inf, nan and the like */
+   if (!digits)
+   {
+      if ((pos < end) && (((*pos | 0x20) == 'i') || ((*pos | 0x20) == 'n')))
+      {
+         return asciip_parse_fallback(text, end, result);
+      }
+      return NULL;
+   }
+
+   /* An e without exponent digits is not part of the number */
+   if ((pos < end) && ((*pos | 0x20) == 'e'))
+   {
+      mark = pos + 1;
+      below = 0;
+      if ((mark < end) && ((*mark == '-') || (*mark == '+')))
+      {
+         below = (*mark == '-');
+         mark++;
+      }
+
+      if ((mark < end) && ((unsigned)(*mark - '0') < 10))
+      {
+         for (; (mark < end) && ((digit = (unsigned)(*mark - '0')) < 10); mark++)
+         {
+            if (power < 100000)
+            {
+               power = 10 * power + (int32_t)digit;
+            }
+         }
+         scale += below ? -power : power;
+         pos = mark;
+      }
+   }
+
+   if (!exact || (mantissa > ASCIIP_PARSE_EXACT_MAX) || (scale < -22) || (scale > 22))
+   {
+      return asciip_parse_fallback(text, end, result);
+   }
+
+   /* Both operands are exact, so the one rounding is correct */
+   *result = (scale < 0) ? (double)mantissa / asciip_parse_pow10[-scale] : (double)mantissa * asciip_parse_pow10[scale];
+   if (negative)
+   {
+      *result = -*result;
+   }
+
+   return pos;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_line
+ *
+ * Description : Parses the line [pos, end) without its newline.
+ *               Returns 1 for a point, 0 for a blank line and -1 for
+ *               anything else.
+ ************************************************************************/
+static int8_t asciip_parse_line(const char *pos,
+                                const char *end,
+                                double     *x,
+                                double     *y)
+{
+   const char *field;
+
+   while ((pos < end) && asciip_parse_blank(*pos))
+   {
+      pos++;
+   }
+
+   if ((pos == end) || ((*pos == '\r') && (pos + 1 == end)))
+   {
+      return 0;
+   }
+
+   if ((pos = asciip_parse_number(pos, end, x)) == NULL)
+   {
+      return -1;
+   }
+
+   /* Blanks, a comma, or both */
+   field = pos;
+   while ((pos < end) && asciip_parse_blank(*pos))
+   {
+      pos++;
+   }
+   if ((pos < end) && (*pos == ','))
+   {
+      pos++;
+      while ((pos < end) && asciip_parse_blank(*pos))
+      {
+         pos++;
+      }
+   }
+   if ((pos == field) || ((pos = asciip_parse_number(pos, end, y)) == NULL))
+   {
+      return -1;
+   }
+
+   return ((pos == end) || asciip_parse_blank(*pos) || (*pos == ',') || (*pos == '\r')) ? 1 : -1;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_lines
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Parses whole lines of text into points until the text
+ *               or the room for points runs out.
+ ************************************************************************/
+size_t asciip_parse_lines(const char         *text,
+                          size_t              length,
+                          uint8_t             final,
+                          double             *xs,
+                          double             *ys,
+                          size_t              capacity,
+                          size_t             *consumed,
+                          Asciip_Parse_Stats *stats)
+{
+   const char *pos = text;
+   const char *stop = text + length;
+   const char *eol;
+   const char *next;
+   uint64_t lines = 0;
+   uint64_t skipped = 0;
+   size_t count = 0;
+   int8_t status;
+
+   while ((count < capacity) && (pos < stop))
+   {
+      if ((eol = memchr(pos, '\n', (size_t)(stop - pos))) != NULL)
+      {
+         next = eol + 1;
+      }
+      else if (final)
+      {
+         eol = stop;
+         next = stop;
+      }
+      else
+      {
+         break;
+      }
+
+      status = asciip_parse_line(pos, eol, &xs[count], &ys[count]);
+      count += (status > 0);
+      skipped += (status < 0);
+      lines++;
+      pos = next;
+   }
+
+   *consumed = (size_t)(pos - text);
+   if (stats != NULL)
+   {
+      stats->lines += lines;
+      stats->points += count;
+      stats->skipped += skipped;
+   }
+
+   return count;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_fd
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Reads a file descriptor to its end and adds every point
+ *               parsed to a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_parse_fd(int                 fd,
+                       Asciip_Series      *series,
+                       Asciip_Parse_Stats *stats,
+                       Asciip_Error       *error)
+{
+   Asciip_Parse_Stats local = { 0, 0, 0, 0 };
+   char *buffer;
+   double *xs;
+   double *ys;
+   const char *eol;
+   size_t used = 0;
+   size_t offset;
+   size_t consumed;
+   size_t count;
+   ssize_t got;
+   uint8_t eof = 0;
+   uint8_t overlong = 0;
+   int8_t status = 0;
+
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_parse_fd: Series was NULL.");
+      return -1;
+   }
+
+   buffer = malloc(ASCIIP_PARSE_BUFFER);
+   xs = malloc(2 * ASCIIP_PARSE_BATCH * sizeof(double));
+   ys = xs + ASCIIP_PARSE_BATCH;
+   if ((buffer == NULL) || (xs == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_parse_fd: Could not malloc buffers.");
+      free(buffer);
+      free(xs);
+      return -1;
+   }
+
+   while (!eof)
+   {
+      if ((got = read(fd, buffer + used, ASCIIP_PARSE_BUFFER - used)) < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+
+         report_error(error, ASCIIP_ERR_IO, "asciip_parse_fd: Could not read stream.");
+         status = -1;
+         break;
+      }
+
+      eof = (got == 0);
+      used += (size_t)got;
+      local.bytes += (uint64_t)got;
+
+      /* Drop the rest of a line too long for the buffer */
+      if (overlong)
+      {
+         if ((eol = memchr(buffer, '\n', used)) == NULL)
+         {
+            used = 0;
+            continue;
+         }
+
+         offset = (size_t)(eol + 1 - buffer);
+         memmove(buffer, buffer + offset, used - offset);
+         used -= offset;
+         overlong = 0;
+      }
+
+      offset = 0;
+      do
+      {
+         count = asciip_parse_lines(buffer + offset, used - offset, eof, xs, ys, ASCIIP_PARSE_BATCH, &consumed, &local);
+         offset += consumed;
+         if ((count > 0) && (asciip_series_add_many(series, xs, ys, count, error) != 0))
+         {
+            /* Error reporting done in function */
+            status = -1;
+            break;
+         }
+      } while (count == ASCIIP_PARSE_BATCH);
+
+      if (status != 0)
+      {
+         break;
+      }
+
+      /* Keep the partial last line for the next read */
+      memmove(buffer, buffer + offset, used - offset);
+      used -= offset;
+      if (used == ASCIIP_PARSE_BUFFER)
+      {
+         local.lines++;
+         local.skipped++;
+         used = 0;
+         overlong = 1;
+      }
+   }
+
+   if (stats != NULL)
+   {
+      stats->bytes += local.bytes;
+      stats->lines += local.lines;
+      stats->points += local.points;
+      stats->skipped += local.skipped;
+   }
+
+   free(buffer);
+   free(xs);
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_threads
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Returns the number of threads used for length bytes of
+ *               text.
+ ************************************************************************/
+uint32_t asciip_parse_threads(size_t length)
+{
+   size_t threads = length / ASCIIP_PARSE_CHUNK;
+   uint32_t workers = asciip_sched_workers();
+
+   if (threads > workers)
+   {
+      threads = workers;
+   }
+
+   if (threads > ASCIIP_PARSE_MAX_THREADS)
+   {
+      threads = ASCIIP_PARSE_MAX_THREADS;
+   }
+
+   return (threads == 0) ? 1 : (uint32_t)threads;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_worker
+ *
+ * Description : Parses a chunk straight into the free columns of its
+ *               series, doubling them whenever they fill up.
+ ************************************************************************/
+static void asciip_parse_worker(Asciip_Parse_Worker *worker)
+{
+   Asciip_Series *series = worker->series;
+   size_t offset = 0;
+   size_t consumed;
+   size_t capacity;
+
+   while (offset < worker->length)
+   {
+      if (series->size == series->capacity)
+      {
+         /* A first guess of one point per 16 bytes of text */
+         capacity = (series->capacity > 0) ? 2 * series->capacity : worker->length / 16 + ASCIIP_SERIES_MIN_CAPACITY;
+         if (asciip_series_reserve(series, capacity, NULL) != 0)
+         {
+            worker->status = -1;
+            break;
+         }
+      }
+
+      series->size += asciip_parse_lines(worker->text + offset, worker->length - offset, 1,
+                                         series->x + series->size, series->y + series->size,
+                                         series->capacity - series->size, &consumed, &worker->stats);
+      offset += consumed;
+   }
+
+}
+
+/************************************************************************
+ * Name        : asciip_parse_workers
+ *
+ * Description : Scheduler body, parses chunks [begin, end).
+ ************************************************************************/
+static void asciip_parse_workers(size_t  begin,
+                                 size_t  end,
+                                 void   *context)
+{
+   Asciip_Parse_Worker *workers = context;
+
+   for (; begin < end; begin++)
+   {
+      asciip_parse_worker(&workers[begin]);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_parse_text
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Parses every line of text and appends the points to a
+ *               series in input order.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_parse_text(const char         *text,
+                         size_t              length,
+                         uint32_t            threads,
+                         Asciip_Series      *series,
+                         Asciip_Parse_Stats *stats,
+                         Asciip_Error       *error)
+{
+   Asciip_Parse_Worker workers[ASCIIP_PARSE_MAX_THREADS];
+   Asciip_Series *chunk;
+   const char *start = text;
+   const char *cut;
+   size_t original;
+   size_t total;
+   uint32_t thread;
+   int8_t status = 0;
+
+   if ((text == NULL) || (series == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_parse_text: Text or series was NULL.");
+      return -1;
+   }
+
+   threads = (threads == 0) ? asciip_parse_threads(length) : threads;
+   threads = (threads > ASCIIP_PARSE_MAX_THREADS) ? ASCIIP_PARSE_MAX_THREADS : threads;
+
+   /* Chunks end after the first newline past an even split; a chunk can
+    * be empty when lines are longer than chunks */
+   memset(workers, 0, threads * sizeof(Asciip_Parse_Worker));
+   for (thread = 0; thread < threads; thread++)
+   {
+      cut = text + length * (thread + 1) / threads;
+      if (thread + 1 == threads)
+      {
+         cut = text + length;
+      }
+      else if (cut <= start)
+      {
+         cut = start;
+      }
+      else
+      {
+         cut = memchr(cut - 1, '\n', (size_t)(text + length - cut + 1));
+         cut = (cut == NULL) ? text + length : cut + 1;
+      }
+
+      workers[thread].text = start;
+      workers[thread].length = (size_t)(cut - start);
+      start = cut;
+   }
+
+   /* The first chunk goes straight into the result */
+   original = series->size;
+   workers[0].series = series;
+   for (thread = 1; thread < threads; thread++)
+   {
+      if (asciip_series_init(0, &workers[thread].series, NULL) == NULL)
+      {
+         threads = thread;
+         status = -1;
+         break;
+      }
+   }
+
+   if (status == 0)
+   {
+      asciip_sched_parallel_for(0, threads, 1, asciip_parse_workers, workers, NULL);
+   }
+
+   total = series->size;
+   for (thread = 0; thread < threads; thread++)
+   {
+      status |= workers[thread].status;
+      total += (thread > 0) ? workers[thread].series->size : 0;
+   }
+
+   if ((status == 0) && (asciip_series_reserve(series, total, NULL) == 0))
+   {
+      for (thread = 1; thread < threads; thread++)
+      {
+         chunk = workers[thread].series;
+         if (chunk->size == 0)
+         {
+            continue;
+         }
+         memcpy(series->x + series->size, chunk->x, chunk->size * sizeof(double));
+         memcpy(series->y + series->size, chunk->y, chunk->size * sizeof(double));
+         series->size += chunk->size;
+      }
+
+      if (stats != NULL)
+      {
+         stats->bytes += length;
+         for (thread = 0; thread < threads; thread++)
+         {
+            stats->lines += workers[thread].stats.lines;
+            stats->points += workers[thread].stats.points;
+            stats->skipped += workers[thread].stats.skipped;
+         }
+      }
+   }
+   else
+   {
+      status = -1;
+      series->size = original;
+      report_error(error, ASCIIP_ERR_MEM, "asciip_parse_text: Could not grow series.");
+   }
+
+   for (thread = 1; thread < threads; thread++)
+   {
+      asciip_series_destroy(workers[thread].series);
+   }
+
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_parse_file
+ *
+ * See         : asciip_parse.h
+ *
+ * Description : Maps a regular file and parses it as
+ *               asciip_parse_text, a segment at a time.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_parse_file(const char         *path,
+                         uint32_t            threads,
+                         Asciip_Series      *series,
+                         Asciip_Parse_Stats *stats,
+                         Asciip_Error       *error)
+{
+   struct stat info;
+   const char *map;
+   const char *end;
+   const char *cut;
+   size_t length;
+   size_t offset;
+   size_t segment;
+   int8_t status = 0;
+   int fd;
+
+   if ((path == NULL) || (series == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_parse_file: Path or series was NULL.");
+      return -1;
+   }
+
+   if ((fd = open(path, O_RDONLY)) < 0)
+   {
+      report_error(error, ASCIIP_ERR_IO, "asciip_parse_file: Could not open file.");
+      return -1;
+   }
+
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) || (info.st_size == 0) ||
+       ((uint64_t)info.st_size > SIZE_MAX) ||
+       ((map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED))
+   {
+      status = asciip_parse_fd(fd, series, stats, error);
+      close(fd);
+      return status;
+   }
+   close(fd);
+
+   length = (size_t)info.st_size;
+   madvise((void *)map, length, MADV_SEQUENTIAL);
+
+   /* Segments end at a newline too, so chunks never split a line */
+   threads = (threads == 0) ? asciip_parse_threads(length) : threads;
+   segment = (size_t)threads * ASCIIP_PARSE_SEGMENT;
+   for (offset = 0; (offset < length) && (status == 0); offset = (size_t)(cut - map))
+   {
+      end = map + ((length - offset > segment) ? offset + segment : length);
+      cut = (end == map + length) ? end : memchr(end - 1, '\n', (size_t)(map + length - end + 1));
+      cut = (cut == NULL) ? map + length : cut + (cut != map + length);
+
+      if (asciip_parse_text(map + offset, (size_t)(cut - map) - offset, threads, series, stats, error) != 0)
+      {
+         /* Error reporting done in function */
+         status = -1;
+      }
+   }
+
+   munmap((void *)map, length);
+   return status;
+}
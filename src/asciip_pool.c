@@ -0,0 +1,221 @@
+/************************************************************************
+ *
+ * File        : asciip_pool.c
+ *
+ * Description : Contains methods to handle a slab pool of fixed-size
+ *               objects.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdlib.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_pool.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Objects start after the block header, kept 16 byte aligned */
+#define ASCIIP_POOL_HEADER_SIZE ((sizeof(Asciip_Pool_Block) + 15) & ~(size_t)15)
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_pool_init
+ *
+ * See         : asciip_pool.h
+ *
+ * Description : Initializes a new empty pool handing out objects of
+ *               object_size bytes.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Pool *asciip_pool_init(size_t         object_size,
+                              size_t         block_objects,
+                              Asciip_Pool  **result,
+                              Asciip_Error  *error)
+{
+   Asciip_Pool *pool;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_pool_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if (block_objects == 0)
+   {
+      block_objects = ASCIIP_POOL_DEFAULT_BLOCK_OBJECTS;
+   }
+
+   /* Released objects hold the free list link, so they must fit a pointer */
+   if (object_size < sizeof(void *))
+   {
+      object_size = sizeof(void *);
+   }
+   object_size = (object_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+   if (block_objects > (SIZE_MAX - ASCIIP_POOL_HEADER_SIZE) / object_size)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_pool_init: Block size too large.");
+      return NULL;
+   }
+
+   if ((pool = malloc(sizeof(Asciip_Pool))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_pool_init: Could not malloc pool.");
+      return NULL;
+   }
+
+   pool->object_size = object_size;
+   pool->block_objects = block_objects;
+   pool->blocks = NULL;
+   pool->carved = 0;
+   pool->free_list = NULL;
+   pool->mallocs = 0;
+   pool->allocs = 0;
+   pool->refs = 1;
+
+   *result = pool;
+   return pool;
+}
+
+/************************************************************************
+ * Name        : asciip_pool_retain
+ *
+ * See         : asciip_pool.h
+ *
+ * Description : Adds an owner to the pool.
+ ************************************************************************/
+Asciip_Pool *asciip_pool_retain(Asciip_Pool *pool)
+{
+   if (pool != NULL)
+   {
+      pool->refs++;
+   }
+
+   return pool;
+}
+
+/************************************************************************
+ * Name        : asciip_pool_destroy
+ *
+ * See         : asciip_pool.h
+ *
+ * Description : Drops one owner of the pool, releasing every block,
+ *               and with them every object ever handed out, once the
+ *               last owner is gone.
+ ************************************************************************/
+void asciip_pool_destroy(Asciip_Pool *pool)
+{
+   Asciip_Pool_Block *blockp;
+   Asciip_Pool_Block *next_blockp;
+
+   if ((pool == NULL) || (--pool->refs > 0))
+   {
+      return;
+   }
+
+   for (blockp = pool->blocks; blockp != NULL; blockp = next_blockp)
+   {
+      next_blockp = blockp->next;
+      free(blockp);
+   }
+
+   free(pool);
+}
+
+/************************************************************************
+ * Name        : asciip_pool_alloc
+ *
+ * See         : asciip_pool.h
+ *
+ * Description : Hands out one object, reusing a released object if
+ *               there is one and allocating a new block only when the
+ *               current block is exhausted.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+void *asciip_pool_alloc(Asciip_Pool  *pool,
+                        Asciip_Error *error)
+{
+   Asciip_Pool_Block *blockp;
+   void *object;
+
+   if (pool == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_pool_alloc: Pool was NULL.");
+      return NULL;
+   }
+
+   /* Reuse released objects first */
+   if (pool->free_list != NULL)
+   {
+      object = pool->free_list;
+      pool->free_list = *(void **)object;
+      pool->allocs++;
+      return object;
+   }
+
+   /* Start a new block when the current one is used up */
+   if ((pool->blocks == NULL) || (pool->carved == pool->block_objects))
+   {
+      if ((blockp = malloc(ASCIIP_POOL_HEADER_SIZE + pool->block_objects * pool->object_size)) == NULL)
+      {
+         report_error(error, ASCIIP_ERR_MEM, "asciip_pool_alloc: Could not malloc pool block.");
+         return NULL;
+      }
+
+      blockp->next = pool->blocks;
+      pool->blocks = blockp;
+      pool->carved = 0;
+      pool->mallocs++;
+   }
+
+   object = (char *)pool->blocks + ASCIIP_POOL_HEADER_SIZE + pool->carved * pool->object_size;
+   pool->carved++;
+   pool->allocs++;
+
+   return object;
+}
+
+/************************************************************************
+ * Name        : asciip_pool_release
+ *
+ * See         : asciip_pool.h
+ *
+ * Description : Returns an object taken from the pool so that it can
+ *               be handed out again.
+ ************************************************************************/
+void asciip_pool_release(Asciip_Pool *pool,
+                         void        *object)
+{
+   if ((pool == NULL) || (object == NULL))
+   {
+      return;
+   }
+
+   *(void **)object = pool->free_list;
+   pool->free_list = object;
+}
@@ -0,0 +1,369 @@
+/************************************************************************
+ *
+ * File        : asciip_queue.c
+ *
+ * Description : Contains methods to collect points from many producer
+ *               threads and hand them to one consumer in batches,
+ *               without locks.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_queue.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_queue_init
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Initializes a queue of lanes for up to producers
+ *               threads, each holding capacity points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Queue *asciip_queue_init(size_t          producers,
+                                size_t          capacity,
+                                Asciip_Queue  **result,
+                                Asciip_Error   *error)
+{
+   Asciip_Queue *queue;
+   size_t slots = 1;
+   size_t ind;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_queue_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((producers == 0) || (capacity == 0) || (capacity > SIZE_MAX / 2 / sizeof(double)))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_queue_init: Bad queue size.");
+      return NULL;
+   }
+
+   while (slots < capacity)
+   {
+      slots <<= 1;
+   }
+
+   if ((producers > SIZE_MAX / sizeof(Asciip_Queue_Lane)) || (slots > SIZE_MAX / sizeof(double) / producers))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_queue_init: Bad queue size.");
+      return NULL;
+   }
+
+   if ((queue = malloc(sizeof(Asciip_Queue))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_queue_init: Could not malloc queue.");
+      return NULL;
+   }
+
+   queue->count = producers;
+   queue->claimed = 0;
+   queue->next = 0;
+   queue->lanes = aligned_alloc(ASCIIP_QUEUE_LINE, producers * sizeof(Asciip_Queue_Lane));
+   if (queue->lanes == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_queue_init: Could not malloc lanes.");
+      free(queue);
+      return NULL;
+   }
+
+   /* One block per column, each lane owning a slice of it */
+   memset(queue->lanes, 0, producers * sizeof(Asciip_Queue_Lane));
+   queue->lanes[0].x = malloc(producers * slots * sizeof(double));
+   queue->lanes[0].y = malloc(producers * slots * sizeof(double));
+   if ((queue->lanes[0].x == NULL) || (queue->lanes[0].y == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_queue_init: Could not malloc columns.");
+      asciip_queue_destroy(queue);
+      return NULL;
+   }
+
+   for (ind = 0; ind < producers; ind++)
+   {
+      queue->lanes[ind].mask = slots - 1;
+      queue->lanes[ind].x = queue->lanes[0].x + ind * slots;
+      queue->lanes[ind].y = queue->lanes[0].y + ind * slots;
+   }
+
+   *result = queue;
+   return queue;
+}
+
+/************************************************************************
+ * Name        : asciip_queue_destroy
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Releases the queue and its lanes.
+ ************************************************************************/
+void asciip_queue_destroy(Asciip_Queue *queue)
+{
+   if (queue == NULL)
+   {
+      return;
+   }
+
+   free(queue->lanes[0].x);
+   free(queue->lanes[0].y);
+   free(queue->lanes);
+   free(queue);
+}
+
+/************************************************************************
+ * Name        : asciip_queue_lane
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Claims a lane for the calling producer thread.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Queue_Lane *asciip_queue_lane(Asciip_Queue *queue,
+                                     Asciip_Error *error)
+{
+   size_t claimed;
+
+   if (queue == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_queue_lane: Queue was NULL.");
+      return NULL;
+   }
+
+   claimed = __atomic_load_n(&queue->claimed, __ATOMIC_RELAXED);
+   do
+   {
+      if (claimed == queue->count)
+      {
+         report_error(error, ASCIIP_ERR_INDEX, "asciip_queue_lane: Every lane was claimed.");
+         return NULL;
+      }
+   } while (!__atomic_compare_exchange_n(&queue->claimed, &claimed, claimed + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+   return &queue->lanes[claimed];
+}
+
+/************************************************************************
+ * Name        : asciip_queue_push
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Adds a point to a lane if it has room.
+ ************************************************************************/
+uint8_t asciip_queue_push(Asciip_Queue_Lane *lane,
+                          double             x,
+                          double             y)
+{
+   size_t tail = lane->tail;
+
+   if (tail - lane->head_cache > lane->mask)
+   {
+      lane->head_cache = __atomic_load_n(&lane->head, __ATOMIC_ACQUIRE);
+      if (tail - lane->head_cache > lane->mask)
+      {
+         return 0;
+      }
+   }
+
+   lane->x[tail & lane->mask] = x;
+   lane->y[tail & lane->mask] = y;
+   __atomic_store_n(&lane->tail, tail + 1, __ATOMIC_RELEASE);
+
+   return 1;
+}
+
+/************************************************************************
+ * Name        : asciip_queue_push_many
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Adds as many of count points to a lane as it has room
+ *               for, published with one store.
+ ************************************************************************/
+size_t asciip_queue_push_many(Asciip_Queue_Lane *lane,
+                              const double      *xs,
+                              const double      *ys,
+                              size_t             count)
+{
+   size_t tail = lane->tail;
+   size_t room = lane->mask + 1 - (tail - lane->head_cache);
+   size_t start;
+   size_t first;
+
+   if (room < count)
+   {
+      lane->head_cache = __atomic_load_n(&lane->head, __ATOMIC_ACQUIRE);
+      room = lane->mask + 1 - (tail - lane->head_cache);
+      if (room < count)
+      {
+         count = room;
+      }
+   }
+
+   if (count == 0)
+   {
+      return 0;
+   }
+
+   /* At most two copies, the second after the wrap */
+   start = tail & lane->mask;
+   first = (count < lane->mask + 1 - start) ? count : lane->mask + 1 - start;
+   memcpy(lane->x + start, xs, first * sizeof(double));
+   memcpy(lane->y + start, ys, first * sizeof(double));
+   memcpy(lane->x, xs + first, (count - first) * sizeof(double));
+   memcpy(lane->y, ys + first, (count - first) * sizeof(double));
+   __atomic_store_n(&lane->tail, tail + count, __ATOMIC_RELEASE);
+
+   return count;
+}
+
+/************************************************************************
+ * Name        : asciip_queue_drain
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Hands every point published so far to a sink, lane by
+ *               lane.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_queue_drain(Asciip_Queue      *queue,
+                          Asciip_Queue_Sink  sink,
+                          void              *context,
+                          size_t            *drained,
+                          Asciip_Error      *error)
+{
+   Asciip_Queue_Lane *lane;
+   size_t claimed;
+   size_t total = 0;
+   size_t step;
+   size_t head;
+   size_t tail;
+   size_t start;
+   size_t run;
+
+   if (drained != NULL)
+   {
+      *drained = 0;
+   }
+
+   if ((queue == NULL) || (sink == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_queue_drain: Queue or sink was NULL.");
+      return -1;
+   }
+
+   /* Unclaimed lanes are empty, claiming one publishes nothing */
+   claimed = __atomic_load_n(&queue->claimed, __ATOMIC_RELAXED);
+   for (step = 0; step < claimed; step++)
+   {
+      lane = &queue->lanes[(queue->next + step) % claimed];
+      head = lane->head;
+      tail = __atomic_load_n(&lane->tail, __ATOMIC_ACQUIRE);
+
+      /* The published points are at most two runs, split at the wrap */
+      while (head != tail)
+      {
+         start = head & lane->mask;
+         run = (tail - head < lane->mask + 1 - start) ? tail - head : lane->mask + 1 - start;
+
+         if (sink(lane->x + start, lane->y + start, run, context) != 0)
+         {
+            report_error(error, ASCIIP_ERR_MEM, "asciip_queue_drain: Sink refused points.");
+            if (drained != NULL)
+            {
+               *drained = total;
+            }
+            return -1;
+         }
+
+         head += run;
+         total += run;
+         __atomic_store_n(&lane->head, head, __ATOMIC_RELEASE);
+      }
+   }
+
+   if (claimed > 0)
+   {
+      queue->next = (queue->next + 1) % claimed;
+   }
+
+   if (drained != NULL)
+   {
+      *drained = total;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_queue_series_sink
+ *
+ * Description : Appends a drained run to the series in context.
+ ************************************************************************/
+static int8_t asciip_queue_series_sink(const double *xs,
+                                       const double *ys,
+                                       size_t        count,
+                                       void         *context)
+{
+   return asciip_series_add_many((Asciip_Series *)context, xs, ys, count, NULL);
+}
+
+/************************************************************************
+ * Name        : asciip_queue_drain_series
+ *
+ * See         : asciip_queue.h
+ *
+ * Description : Appends every point published so far to a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_queue_drain_series(Asciip_Queue  *queue,
+                                 Asciip_Series *series,
+                                 size_t        *drained,
+                                 Asciip_Error  *error)
+{
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_queue_drain_series: Series was NULL.");
+      return -1;
+   }
+
+   if (asciip_queue_drain(queue, asciip_queue_series_sink, series, drained, error) != 0)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   return 0;
+}
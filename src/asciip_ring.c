@@ -0,0 +1,228 @@
+/************************************************************************
+ *
+ * File        : asciip_ring.c
+ *
+ * Description : Contains methods to keep the most recent points of a
+ *               stream in a fixed-capacity ring buffer.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_ring.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_ring_init
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Initializes an empty ring holding up to capacity
+ *               points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Ring *asciip_ring_init(size_t         capacity,
+                              Asciip_Ring  **result,
+                              Asciip_Error  *error)
+{
+   Asciip_Ring *ring;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_ring_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((capacity == 0) || (capacity > SIZE_MAX / sizeof(double)))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_ring_init: Bad ring capacity.");
+      return NULL;
+   }
+
+   if ((ring = malloc(sizeof(Asciip_Ring))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_ring_init: Could not malloc ring.");
+      return NULL;
+   }
+
+   ring->capacity = capacity;
+   ring->head = 0;
+   ring->size = 0;
+   ring->x = malloc(capacity * sizeof(double));
+   ring->y = malloc(capacity * sizeof(double));
+   if ((ring->x == NULL) || (ring->y == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_ring_init: Could not malloc columns.");
+      asciip_ring_destroy(ring);
+      return NULL;
+   }
+
+   *result = ring;
+   return ring;
+}
+
+/************************************************************************
+ * Name        : asciip_ring_destroy
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Releases the ring and its columns.
+ ************************************************************************/
+void asciip_ring_destroy(Asciip_Ring *ring)
+{
+   if (ring == NULL)
+   {
+      return;
+   }
+
+   free(ring->x);
+   free(ring->y);
+   free(ring);
+}
+
+/************************************************************************
+ * Name        : asciip_ring_clear
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Drops every point.
+ ************************************************************************/
+void asciip_ring_clear(Asciip_Ring *ring)
+{
+   ring->head = 0;
+   ring->size = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_ring_push_many
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Adds points oldest first, copying each column in at
+ *               most two pieces.
+ ************************************************************************/
+void asciip_ring_push_many(Asciip_Ring  *ring,
+                           const double *xs,
+                           const double *ys,
+                           size_t        count)
+{
+   size_t slot;
+   size_t piece;
+   size_t overflow;
+
+   /* Points that would be overwritten in this call are never copied */
+   if (count > ring->capacity)
+   {
+      xs += count - ring->capacity;
+      ys += count - ring->capacity;
+      count = ring->capacity;
+   }
+
+   slot = ring->head + ring->size;
+   slot = (slot < ring->capacity) ? slot : slot - ring->capacity;
+   piece = (count < ring->capacity - slot) ? count : ring->capacity - slot;
+
+   memcpy(ring->x + slot, xs, piece * sizeof(double));
+   memcpy(ring->y + slot, ys, piece * sizeof(double));
+   memcpy(ring->x, xs + piece, (count - piece) * sizeof(double));
+   memcpy(ring->y, ys + piece, (count - piece) * sizeof(double));
+
+   overflow = (ring->size + count > ring->capacity) ? ring->size + count - ring->capacity : 0;
+   ring->size += count - overflow;
+   ring->head += overflow;
+   ring->head = (ring->head < ring->capacity) ? ring->head : ring->head - ring->capacity;
+}
+
+/************************************************************************
+ * Name        : asciip_ring_evict
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Drops up to count of the oldest points.
+ ************************************************************************/
+size_t asciip_ring_evict(Asciip_Ring *ring,
+                         size_t       count)
+{
+   count = (count < ring->size) ? count : ring->size;
+
+   ring->head += count;
+   ring->head = (ring->head < ring->capacity) ? ring->head : ring->head - ring->capacity;
+   ring->size -= count;
+
+   return count;
+}
+
+/************************************************************************
+ * Name        : asciip_ring_evict_before
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Drops the oldest points while their x is below a
+ *               cutoff.
+ ************************************************************************/
+size_t asciip_ring_evict_before(Asciip_Ring *ring,
+                                double       x)
+{
+   size_t dropped = 0;
+
+   while ((ring->size > 0) && (ring->x[ring->head] < x))
+   {
+      ring->head = (ring->head + 1 < ring->capacity) ? ring->head + 1 : 0;
+      ring->size--;
+      dropped++;
+   }
+
+   return dropped;
+}
+
+/************************************************************************
+ * Name        : asciip_ring_runs
+ *
+ * See         : asciip_ring.h
+ *
+ * Description : Sets views on the points of the ring, oldest first.
+ ************************************************************************/
+uint8_t asciip_ring_runs(const Asciip_Ring  *ring,
+                         Asciip_Series_View  runs[2])
+{
+   size_t first = (ring->size < ring->capacity - ring->head) ? ring->size : ring->capacity - ring->head;
+
+   runs[0].x = ring->x + ring->head;
+   runs[0].y = ring->y + ring->head;
+   runs[0].size = first;
+   runs[0].offset = 0;
+
+   runs[1].x = ring->x;
+   runs[1].y = ring->y;
+   runs[1].size = ring->size - first;
+   runs[1].offset = first;
+
+   return (uint8_t)((first > 0) + (runs[1].size > 0));
+}
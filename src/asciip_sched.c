@@ -0,0 +1,539 @@
+/************************************************************************
+ *
+ * File        : asciip_sched.c
+ *
+ * Description : Contains the task scheduler shared by every parallel
+ *               kernel of the library.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_sched.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Deques of different workers never share a cache line */
+#define ASCIIP_SCHED_LINE 64
+
+/* Task taken from an empty deque. A task holds at least one chunk, so
+ * it never packs to 0 */
+#define ASCIIP_SCHED_NONE 0
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_sched_deque_t
+{
+   int64_t  top;                         /* Next task a thief takes */
+   int64_t  bottom;                      /* Next free slot, moved by the owner only */
+   uint64_t tasks[ASCIIP_SCHED_DEQUE];   /* Chunk ranges, first << 32 | end */
+
+} __attribute__((aligned(ASCIIP_SCHED_LINE))) Asciip_Sched_Deque;
+
+
+typedef struct _asciip_sched_job_t
+{
+   Asciip_Sched_Body  body;        /* Function run on each chunk */
+   void              *context;     /* Passed to body */
+   size_t             begin;       /* First index */
+   size_t             end;         /* One past the last index */
+   size_t             grain;       /* Indices per chunk */
+   uint32_t           workers;     /* Deques taking part */
+   uint64_t           remaining;   /* Chunks not yet run */
+
+} Asciip_Sched_Job;
+
+
+typedef struct _asciip_sched_t
+{
+   pthread_mutex_t     lock;                                 /* Guards everything but the deques */
+   pthread_mutex_t     submit;                               /* Held while a job runs or workers change */
+   pthread_cond_t      wake;                                 /* Signalled when a job starts or workers stop */
+   pthread_cond_t      idle;                                 /* Signalled when the last worker leaves a job */
+   uint32_t            workers;                              /* Workers, calling thread included, 0 until set */
+   uint32_t            started;                              /* Worker threads running */
+   uint32_t            active;                               /* Worker threads inside the job */
+   uint64_t            generation;                           /* Jobs started */
+   uint64_t            epoch;                                /* Jobs started before the workers were */
+   uint8_t             stop;                                 /* Sends the worker threads home */
+   Asciip_Sched_Job   *job;                                  /* Job running, NULL between jobs */
+   pthread_t           tids[ASCIIP_SCHED_MAX_WORKERS];       /* Worker threads, from 1 */
+   Asciip_Sched_Deque  deques[ASCIIP_SCHED_MAX_WORKERS];     /* Deque per worker, 0 for the calling thread */
+
+} Asciip_Sched;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+static Asciip_Sched asciip_sched =
+{
+   .lock   = PTHREAD_MUTEX_INITIALIZER,
+   .submit = PTHREAD_MUTEX_INITIALIZER,
+   .wake   = PTHREAD_COND_INITIALIZER,
+   .idle   = PTHREAD_COND_INITIALIZER
+};
+
+/* Set on threads running a job, whose own jobs then run inline */
+static __thread uint8_t asciip_sched_inside;
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_sched_push
+ *
+ * Description : Puts a task at the bottom of the owner's deque. Returns
+ *               0 if the deque is full.
+ ************************************************************************/
+static uint8_t asciip_sched_push(Asciip_Sched_Deque *deque,
+                                 uint64_t            task)
+{
+   int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+   int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+   if (bottom - top >= ASCIIP_SCHED_DEQUE)
+   {
+      return 0;
+   }
+
+   __atomic_store_n(&deque->tasks[bottom & (ASCIIP_SCHED_DEQUE - 1)], task, __ATOMIC_RELAXED);
+   __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+
+   return 1;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_pop
+ *
+ * Description : Takes the newest task from the bottom of the owner's
+ *               deque. Only the last task can be raced for, and the
+ *               race is settled on top, as with a thief.
+ ************************************************************************/
+static uint64_t asciip_sched_pop(Asciip_Sched_Deque *deque)
+{
+   int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+   int64_t top;
+   uint64_t task;
+
+   /* Sequentially consistent, so a thief sees either the new bottom or
+    * the top this takes */
+   __atomic_store_n(&deque->bottom, bottom, __ATOMIC_SEQ_CST);
+   top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+
+   if (top > bottom)
+   {
+      __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+      return ASCIIP_SCHED_NONE;
+   }
+
+   task = __atomic_load_n(&deque->tasks[bottom & (ASCIIP_SCHED_DEQUE - 1)], __ATOMIC_RELAXED);
+   if (top == bottom)
+   {
+      if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+      {
+         task = ASCIIP_SCHED_NONE;
+      }
+      __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+   }
+
+   return task;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_steal
+ *
+ * Description : Takes the oldest, and so largest, task from the top of
+ *               another worker's deque. Losing the race to the owner or
+ *               another thief takes nothing.
+ ************************************************************************/
+static uint64_t asciip_sched_steal(Asciip_Sched_Deque *deque)
+{
+   int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+   int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+   uint64_t task;
+
+   if (top >= bottom)
+   {
+      return ASCIIP_SCHED_NONE;
+   }
+
+   task = __atomic_load_n(&deque->tasks[top & (ASCIIP_SCHED_DEQUE - 1)], __ATOMIC_RELAXED);
+   if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+   {
+      return ASCIIP_SCHED_NONE;
+   }
+
+   return task;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_run
+ *
+ * Description : Calls the body of a job on chunks [first, last) in
+ *               order.
+ ************************************************************************/
+static void asciip_sched_run(const Asciip_Sched_Job *job,
+                             uint64_t                first,
+                             uint64_t                last)
+{
+   size_t begin;
+   size_t end;
+
+   for (; first < last; first++)
+   {
+      begin = job->begin + (size_t)first * job->grain;
+      end = (job->end - begin > job->grain) ? begin + job->grain : job->end;
+      job->body(begin, end, job->context);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_sched_work
+ *
+ * Description : Runs tasks of a job until none is left: the task given,
+ *               then those on the worker's own deque, then those it can
+ *               steal. A task is halved until one chunk is left, the
+ *               upper halves going on the worker's deque.
+ ************************************************************************/
+static void asciip_sched_work(Asciip_Sched_Job *job,
+                              uint32_t          id,
+                              uint64_t          task)
+{
+   Asciip_Sched_Deque *own = &asciip_sched.deques[id];
+   uint64_t first;
+   uint64_t last;
+   uint64_t middle;
+   uint32_t step;
+
+   while (1)
+   {
+      if (task == ASCIIP_SCHED_NONE)
+      {
+         task = asciip_sched_pop(own);
+      }
+      for (step = 1; (task == ASCIIP_SCHED_NONE) && (step < job->workers); step++)
+      {
+         task = asciip_sched_steal(&asciip_sched.deques[(id + step) % job->workers]);
+      }
+
+      if (task == ASCIIP_SCHED_NONE)
+      {
+         /* Chunks still running elsewhere may yet split */
+         if (__atomic_load_n(&job->remaining, __ATOMIC_ACQUIRE) == 0)
+         {
+            return;
+         }
+         sched_yield();
+         continue;
+      }
+
+      first = task >> 32;
+      last = task & UINT32_MAX;
+      for (middle = first + (last - first) / 2;
+           (last - first > 1) && asciip_sched_push(own, (middle << 32) | last);
+           middle = first + (last - first) / 2)
+      {
+         last = middle;
+      }
+
+      asciip_sched_run(job, first, last);
+      __atomic_sub_fetch(&job->remaining, last - first, __ATOMIC_RELEASE);
+      task = ASCIIP_SCHED_NONE;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_sched_worker
+ *
+ * Description : Worker thread, sleeps until a job starts, helps with it
+ *               and goes back to sleep.
+ ************************************************************************/
+static void *asciip_sched_worker(void *arg)
+{
+   uint32_t id = (uint32_t)(uintptr_t)arg;
+   Asciip_Sched_Job *job;
+   uint64_t seen;
+
+   asciip_sched_inside = 1;
+   pthread_mutex_lock(&asciip_sched.lock);
+   seen = asciip_sched.epoch;
+
+   while (1)
+   {
+      while (!asciip_sched.stop && (asciip_sched.generation == seen))
+      {
+         pthread_cond_wait(&asciip_sched.wake, &asciip_sched.lock);
+      }
+
+      if (asciip_sched.stop)
+      {
+         break;
+      }
+
+      /* A job may already be over by the time the worker wakes */
+      seen = asciip_sched.generation;
+      if ((job = asciip_sched.job) == NULL)
+      {
+         continue;
+      }
+
+      asciip_sched.active++;
+      pthread_mutex_unlock(&asciip_sched.lock);
+      asciip_sched_work(job, id, ASCIIP_SCHED_NONE);
+      pthread_mutex_lock(&asciip_sched.lock);
+
+      if (--asciip_sched.active == 0)
+      {
+         pthread_cond_broadcast(&asciip_sched.idle);
+      }
+   }
+
+   pthread_mutex_unlock(&asciip_sched.lock);
+   return NULL;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_default
+ *
+ * Description : Gets the worker count used when none was set: one per
+ *               online processor.
+ ************************************************************************/
+static uint32_t asciip_sched_default(void)
+{
+   long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+   if (online < 1)
+   {
+      return 1;
+   }
+
+   return (online > ASCIIP_SCHED_MAX_WORKERS) ? ASCIIP_SCHED_MAX_WORKERS : (uint32_t)online;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_start
+ *
+ * Description : Starts any worker threads not yet running. If a thread
+ *               cannot be created, the workers are cut down to those
+ *               running. Returns the worker count. Called with submit
+ *               held.
+ ************************************************************************/
+static uint32_t asciip_sched_start(void)
+{
+   uint32_t workers;
+
+   pthread_mutex_lock(&asciip_sched.lock);
+   if (asciip_sched.workers == 0)
+   {
+      asciip_sched.workers = asciip_sched_default();
+   }
+
+   asciip_sched.epoch = asciip_sched.generation;
+   while (asciip_sched.started + 1 < asciip_sched.workers)
+   {
+      if (pthread_create(&asciip_sched.tids[asciip_sched.started + 1], NULL, asciip_sched_worker,
+                         (void *)(uintptr_t)(asciip_sched.started + 1)) != 0)
+      {
+         asciip_sched.workers = asciip_sched.started + 1;
+         break;
+      }
+      asciip_sched.started++;
+   }
+
+   workers = asciip_sched.workers;
+   pthread_mutex_unlock(&asciip_sched.lock);
+
+   return workers;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_stop
+ *
+ * Description : Sends the worker threads home and waits for them.
+ *               Called with submit held, so no job is running.
+ ************************************************************************/
+static void asciip_sched_stop(void)
+{
+   uint32_t started;
+   uint32_t ind;
+
+   pthread_mutex_lock(&asciip_sched.lock);
+   asciip_sched.stop = 1;
+   started = asciip_sched.started;
+   pthread_cond_broadcast(&asciip_sched.wake);
+   pthread_mutex_unlock(&asciip_sched.lock);
+
+   for (ind = 1; ind <= started; ind++)
+   {
+      pthread_join(asciip_sched.tids[ind], NULL);
+   }
+
+   pthread_mutex_lock(&asciip_sched.lock);
+   asciip_sched.started = 0;
+   asciip_sched.stop = 0;
+   pthread_mutex_unlock(&asciip_sched.lock);
+}
+
+/************************************************************************
+ * Name        : asciip_sched_set_workers
+ *
+ * See         : asciip_sched.h
+ *
+ * Description : Sets the number of workers, stopping the current ones.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_sched_set_workers(uint32_t      workers,
+                                Asciip_Error *error)
+{
+   if (workers > ASCIIP_SCHED_MAX_WORKERS)
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_sched_set_workers: Too many workers.");
+      return -1;
+   }
+
+   pthread_mutex_lock(&asciip_sched.submit);
+   asciip_sched_stop();
+
+   pthread_mutex_lock(&asciip_sched.lock);
+   asciip_sched.workers = (workers == 0) ? asciip_sched_default() : workers;
+   pthread_mutex_unlock(&asciip_sched.lock);
+   pthread_mutex_unlock(&asciip_sched.submit);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_workers
+ *
+ * See         : asciip_sched.h
+ *
+ * Description : Gets the number of workers a job runs on.
+ ************************************************************************/
+uint32_t asciip_sched_workers(void)
+{
+   uint32_t workers;
+
+   pthread_mutex_lock(&asciip_sched.lock);
+   if (asciip_sched.workers == 0)
+   {
+      asciip_sched.workers = asciip_sched_default();
+   }
+   workers = asciip_sched.workers;
+   pthread_mutex_unlock(&asciip_sched.lock);
+
+   return workers;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_parallel_for
+ *
+ * See         : asciip_sched.h
+ *
+ * Description : Runs body on every chunk of [begin, end), on the
+ *               workers when the scheduler is free and on the calling
+ *               thread otherwise.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_sched_parallel_for(size_t             begin,
+                                 size_t             end,
+                                 size_t             grain,
+                                 Asciip_Sched_Body  body,
+                                 void              *context,
+                                 Asciip_Error      *error)
+{
+   Asciip_Sched_Job job;
+   uint64_t chunks;
+
+   if (body == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_sched_parallel_for: Body was NULL.");
+      return -1;
+   }
+
+   if (end <= begin)
+   {
+      return 0;
+   }
+
+   chunks = (grain == 0) ? 0 : (uint64_t)((end - begin - 1) / grain) + 1;
+   if ((chunks == 0) || (chunks > UINT32_MAX))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_sched_parallel_for: Bad grain.");
+      return -1;
+   }
+
+   job.body = body;
+   job.context = context;
+   job.begin = begin;
+   job.end = end;
+   job.grain = grain;
+   job.remaining = chunks;
+
+   /* Nested or concurrent jobs, and single chunks, run inline */
+   if ((chunks == 1) || asciip_sched_inside || (pthread_mutex_trylock(&asciip_sched.submit) != 0))
+   {
+      asciip_sched_run(&job, 0, chunks);
+      return 0;
+   }
+
+   if ((job.workers = asciip_sched_start()) == 1)
+   {
+      asciip_sched_run(&job, 0, chunks);
+      pthread_mutex_unlock(&asciip_sched.submit);
+      return 0;
+   }
+
+   asciip_sched_inside = 1;
+   pthread_mutex_lock(&asciip_sched.lock);
+   asciip_sched.job = &job;
+   asciip_sched.generation++;
+   pthread_cond_broadcast(&asciip_sched.wake);
+   pthread_mutex_unlock(&asciip_sched.lock);
+
+   asciip_sched_work(&job, 0, chunks);
+
+   /* Workers may still be looking at the job or the deques */
+   pthread_mutex_lock(&asciip_sched.lock);
+   while (asciip_sched.active > 0)
+   {
+      pthread_cond_wait(&asciip_sched.idle, &asciip_sched.lock);
+   }
+   asciip_sched.job = NULL;
+   pthread_mutex_unlock(&asciip_sched.lock);
+   asciip_sched_inside = 0;
+
+   pthread_mutex_unlock(&asciip_sched.submit);
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_sched_shutdown
+ *
+ * See         : asciip_sched.h
+ *
+ * Description : Stops the workers until the next job.
+ ************************************************************************/
+void asciip_sched_shutdown(void)
+{
+   pthread_mutex_lock(&asciip_sched.submit);
+   asciip_sched_stop();
+   pthread_mutex_unlock(&asciip_sched.submit);
+}
@@ -0,0 +1,708 @@
+/************************************************************************
+ *
+ * File        : asciip_series.c
+ *
+ * Description : Contains methods to handle a series of points stored
+ *               in contiguous, growable x and y arrays.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_series.h"
+#include "asciip_sort.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_series_grow
+ *
+ * Description : Makes room for count more points, at least doubling
+ *               the capacity so repeated appends stay amortized O(1).
+ ************************************************************************/
+static int8_t asciip_series_grow(Asciip_Series *series,
+                                 size_t         count,
+                                 Asciip_Error  *error)
+{
+   size_t new_capacity;
+
+   if (count > SIZE_MAX - series->size)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_grow: Capacity too large.");
+      return -1;
+   }
+
+   if (series->size + count <= series->capacity)
+   {
+      return 0;
+   }
+
+   new_capacity = series->capacity * 2;
+   if (new_capacity < ASCIIP_SERIES_MIN_CAPACITY)
+   {
+      new_capacity = ASCIIP_SERIES_MIN_CAPACITY;
+   }
+   if (new_capacity < series->size + count)
+   {
+      new_capacity = series->size + count;
+   }
+
+   return asciip_series_reserve(series, new_capacity, error);
+}
+
+/************************************************************************
+ * Name        : asciip_series_init
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Initializes a new empty Asciip_Series with room for
+ *               at least capacity points.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Series *asciip_series_init(size_t          capacity,
+                                  Asciip_Series **result,
+                                  Asciip_Error   *error)
+{
+   Asciip_Series *series;
+
+   /* Make sure result pointer is not NULL */
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((series = malloc(sizeof(Asciip_Series))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_init: Could not malloc series.");
+      return NULL;
+   }
+
+   series->size = 0;
+   series->capacity = 0;
+   series->x = NULL;
+   series->y = NULL;
+
+   /* Reserve the requested room up front so the caller can fill it without growth */
+   if ((capacity > 0) && (asciip_series_reserve(series, capacity, error) != 0))
+   {
+      free(series);
+      return NULL;
+   }
+
+   *result = series;
+   return series;
+}
+
+/************************************************************************
+ * Name        : asciip_series_destroy
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Releases the columns and the series struct.
+ ************************************************************************/
+void asciip_series_destroy(Asciip_Series *series)
+{
+   /* If the series is NULL we don't need to free it */
+   if (series == NULL)
+   {
+      return;
+   }
+
+   free(series->x);
+   free(series->y);
+   free(series);
+}
+
+/************************************************************************
+ * Name        : asciip_series_reserve
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Grows the columns so that the series can hold at least
+ *               capacity points without reallocating. Never shrinks.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_reserve(Asciip_Series *series,
+                             size_t         capacity,
+                             Asciip_Error  *error)
+{
+   double *new_x;
+   double *new_y;
+
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_reserve: Series was NULL.");
+      return -1;
+   }
+
+   /* Already big enough */
+   if (capacity <= series->capacity)
+   {
+      return 0;
+   }
+
+   if (capacity > SIZE_MAX / sizeof(double))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_reserve: Capacity too large.");
+      return -1;
+   }
+
+   /* Grow each column separately, the series stays valid if the second fails */
+   if ((new_x = realloc(series->x, capacity * sizeof(double))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_reserve: Could not grow x column.");
+      return -1;
+   }
+   series->x = new_x;
+
+   if ((new_y = realloc(series->y, capacity * sizeof(double))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_reserve: Could not grow y column.");
+      return -1;
+   }
+   series->y = new_y;
+
+   series->capacity = capacity;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_add
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Appends the point (x, y) to the back of the series,
+ *               doubling the capacity when the columns are full.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_add(Asciip_Series *series,
+                         double         x,
+                         double         y,
+                         Asciip_Error  *error)
+{
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_add: Series was NULL.");
+      return -1;
+   }
+
+   /* Double the columns when full so appends stay amortized O(1) */
+   if ((series->size == series->capacity) && (asciip_series_grow(series, 1, error) != 0))
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   series->x[series->size] = x;
+   series->y[series->size] = y;
+   series->size++;
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_add_many
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Appends count points from the caller's x and y arrays
+ *               with a single capacity reservation.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_add_many(Asciip_Series *series,
+                              const double  *xs,
+                              const double  *ys,
+                              size_t         count,
+                              Asciip_Error  *error)
+{
+   if ((series == NULL) || (((xs == NULL) || (ys == NULL)) && (count > 0)))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_add_many: One of the parameters were NULL.");
+      return -1;
+   }
+
+   if (asciip_series_grow(series, count, error) != 0)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   if (count > 0)
+   {
+      memcpy(series->x + series->size, xs, count * sizeof(double));
+      memcpy(series->y + series->size, ys, count * sizeof(double));
+      series->size += count;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_add_interleaved
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Appends count points from a caller buffer holding
+ *               x0, y0, x1, y1, ... with a single capacity reservation.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_add_interleaved(Asciip_Series *series,
+                                     const double  *xys,
+                                     size_t         count,
+                                     Asciip_Error  *error)
+{
+   double *xs;
+   double *ys;
+   size_t ind;
+
+   if ((series == NULL) || ((xys == NULL) && (count > 0)))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_add_interleaved: One of the parameters were NULL.");
+      return -1;
+   }
+
+   if (asciip_series_grow(series, count, error) != 0)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   xs = series->x + series->size;
+   ys = series->y + series->size;
+   for (ind = 0; ind < count; ind++)
+   {
+      xs[ind] = xys[2 * ind];
+      ys[ind] = xys[2 * ind + 1];
+   }
+   series->size += count;
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_adopt
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Hands malloc'd x and y arrays of count points over to
+ *               the series, without copying when the series is empty.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_adopt(Asciip_Series *series,
+                           double        *xs,
+                           double        *ys,
+                           size_t         count,
+                           Asciip_Error  *error)
+{
+   int8_t status;
+
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_adopt: Series was NULL.");
+      free(xs);
+      free(ys);
+      return -1;
+   }
+
+   /* An empty series simply swaps its columns for the caller's */
+   if ((series->size == 0) && (xs != NULL) && (ys != NULL))
+   {
+      free(series->x);
+      free(series->y);
+      series->x = xs;
+      series->y = ys;
+      series->size = count;
+      series->capacity = count;
+      return 0;
+   }
+
+   status = asciip_series_add_many(series, xs, ys, count, error);
+   free(xs);
+   free(ys);
+
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_series_get
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Copies the point at the index passed from the user
+ *               into result.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Point *asciip_series_get(const Asciip_Series *series,
+                                size_t               index,
+                                Asciip_Point        *result,
+                                Asciip_Error        *error)
+{
+   if ((series == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_get: One of the parameters were NULL.");
+      return NULL;
+   }
+
+   if (index >= series->size)
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_series_get: Index was not in the bounds of the series.");
+      return NULL;
+   }
+
+   result->x = series->x[index];
+   result->y = series->y[index];
+   return result;
+}
+
+/************************************************************************
+ * Name        : asciip_series_outside
+ *
+ * Description : Predicate selecting points with x outside [lo, hi),
+ *               context holds lo and hi.
+ ************************************************************************/
+static uint8_t asciip_series_outside(double  x,
+                                     double  y,
+                                     void   *context)
+{
+   const double *bounds = context;
+
+   (void)y;
+   return !((x >= bounds[0]) && (x < bounds[1]));
+}
+
+/************************************************************************
+ * Name        : asciip_series_remove_range
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Removes count points starting at index.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_remove_range(Asciip_Series *series,
+                                  size_t         index,
+                                  size_t         count,
+                                  Asciip_Series *removed,
+                                  Asciip_Error  *error)
+{
+   size_t after;
+
+   if ((series == NULL) || (series == removed))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_remove_range: Bad series.");
+      return -1;
+   }
+
+   if ((index > series->size) || (count > series->size - index))
+   {
+      report_error(error, ASCIIP_ERR_INDEX, "asciip_series_remove_range: Range out of bounds.");
+      return -1;
+   }
+
+   if ((removed != NULL) &&
+       (asciip_series_add_many(removed, series->x + index, series->y + index, count, error) != 0))
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   after = series->size - index - count;
+   if ((count > 0) && (after > 0))
+   {
+      memmove(series->x + index, series->x + index + count, after * sizeof(double));
+      memmove(series->y + index, series->y + index + count, after * sizeof(double));
+   }
+   series->size -= count;
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_remove_outside
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Removes every point with x outside [lo, hi).
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_remove_outside(Asciip_Series *series,
+                                    double         lo,
+                                    double         hi,
+                                    Asciip_Series *removed,
+                                    Asciip_Error  *error)
+{
+   double bounds[2];
+
+   bounds[0] = lo;
+   bounds[1] = hi;
+
+   return asciip_series_remove_if(series, asciip_series_outside, bounds, removed, error);
+}
+
+/************************************************************************
+ * Name        : asciip_series_remove_if
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Removes every point pred selects in one compacting
+ *               pass.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_remove_if(Asciip_Series     *series,
+                               Asciip_Point_Pred  pred,
+                               void              *context,
+                               Asciip_Series     *removed,
+                               Asciip_Error      *error)
+{
+   size_t read;
+   size_t write = 0;
+   int8_t status = 0;
+
+   if ((series == NULL) || (pred == NULL) || (series == removed))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_remove_if: Bad series or predicate.");
+      return -1;
+   }
+
+   for (read = 0; read < series->size; read++)
+   {
+      double x = series->x[read];
+      double y = series->y[read];
+
+      /* After a failure every remaining point is kept */
+      if ((status == 0) && pred(x, y, context))
+      {
+         if ((removed == NULL) || ((status = asciip_series_add(removed, x, y, error)) == 0))
+         {
+            continue;
+         }
+      }
+
+      series->x[write] = x;
+      series->y[write] = y;
+      write++;
+   }
+   series->size = write;
+
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_series_sort
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Stable sort of the series points by x, lowest first.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_sort(Asciip_Series *series,
+                          Asciip_Error  *error)
+{
+   uint64_t *keys;
+   uint64_t *values;
+   size_t ind;
+
+   if (series == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_sort: Series was NULL.");
+      return -1;
+   }
+
+   if (series->size == 0)
+   {
+      return 0;
+   }
+
+   /* The sort works on integers, so the columns are copied out rather
+    * than read through uint64_t pointers, which would break aliasing */
+   keys = malloc(series->size * sizeof(uint64_t));
+   values = malloc(series->size * sizeof(uint64_t));
+   if ((keys == NULL) || (values == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_series_sort: Could not allocate keys.");
+      free(keys);
+      free(values);
+      return -1;
+   }
+
+   for (ind = 0; ind < series->size; ind++)
+   {
+      keys[ind] = asciip_sort_key(series->x[ind]);
+   }
+   memcpy(values, series->y, series->size * sizeof(uint64_t));
+
+   if (asciip_sort_radix(keys, values, series->size, 0, error) != 0)
+   {
+      /* Error reporting done in function, the series is unchanged */
+      free(keys);
+      free(values);
+      return -1;
+   }
+
+   for (ind = 0; ind < series->size; ind++)
+   {
+      series->x[ind] = asciip_sort_value(keys[ind]);
+   }
+   memcpy(series->y, values, series->size * sizeof(double));
+
+   free(keys);
+   free(values);
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_series_from_list
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Creates a new series holding a copy of every point in
+ *               the list, in list order. The list is not modified.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Series *asciip_series_from_list(const Asciip_List  *list,
+                                       Asciip_Series     **result,
+                                       Asciip_Error       *error)
+{
+   Asciip_Series *series;
+   Asciip_Node   *nodep;
+   size_t         ind;
+
+   if ((list == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_from_list: One of the parameters were NULL.");
+      return NULL;
+   }
+
+   /* One reservation for the whole list, then a single walk */
+   if (asciip_series_init(list->size, &series, error) == NULL)
+   {
+      /* Error reporting done in function */
+      return NULL;
+   }
+
+   nodep = list->head;
+   for (ind = 0; (ind < list->size) && (nodep != NULL); ind++)
+   {
+      series->x[ind] = nodep->data->x;
+      series->y[ind] = nodep->data->y;
+      nodep = nodep->next;
+   }
+   series->size = ind;
+
+   *result = series;
+   return series;
+}
+
+/************************************************************************
+ * Name        : asciip_series_lower_bound
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Binary search for the first point with x not below a
+ *               value. The probe picks the half with a select rather
+ *               than a branch, so the loop runs a fixed log2(n) steps
+ *               without mispredictions.
+ ************************************************************************/
+size_t asciip_series_lower_bound(const Asciip_Series *series,
+                                 double               x)
+{
+   const double *base = series->x;
+   size_t count = series->size;
+   size_t half;
+
+   if (count == 0)
+   {
+      return 0;
+   }
+
+   while (count > 1)
+   {
+      half = count / 2;
+      base = (base[half] < x) ? base + half : base;
+      count -= half;
+   }
+
+   return (size_t)(base - series->x) + (*base < x);
+}
+
+/************************************************************************
+ * Name        : asciip_series_range
+ *
+ * See         : asciip_series.h
+ *
+ * Description : Sets a view on the points with x in [lo, hi).
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_series_range(const Asciip_Series *series,
+                           double               lo,
+                           double               hi,
+                           Asciip_Series_View  *view,
+                           Asciip_Error        *error)
+{
+   size_t begin;
+   size_t end;
+
+   if ((series == NULL) || (view == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_series_range: One of the parameters were NULL.");
+      return -1;
+   }
+
+   if (isnan(lo) || isnan(hi))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_series_range: Bound was NaN.");
+      return -1;
+   }
+
+   begin = asciip_series_lower_bound(series, lo);
+   end = (hi > lo) ? asciip_series_lower_bound(series, hi) : begin;
+   end = (end > begin) ? end : begin;
+
+   view->x = series->x + begin;
+   view->y = series->y + begin;
+   view->size = end - begin;
+   view->offset = begin;
+
+   return 0;
+}
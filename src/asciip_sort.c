@@ -0,0 +1,311 @@
+/************************************************************************
+ *
+ * File        : asciip_sort.c
+ *
+ * Description : Contains the sort engine used to order series and lists
+ *               by x.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_sched.h"
+#include "asciip_sort.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* 6 passes of 11 bits cover a 64-bit key */
+#define ASCIIP_SORT_DIGIT_BITS 11
+#define ASCIIP_SORT_BUCKETS    (1 << ASCIIP_SORT_DIGIT_BITS)
+#define ASCIIP_SORT_PASSES     ((64 + ASCIIP_SORT_DIGIT_BITS - 1) / ASCIIP_SORT_DIGIT_BITS)
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_sort_slice_t
+{
+   size_t begin;                       /* First key of the slice */
+   size_t end;                         /* One past the last key of the slice */
+   size_t hist[ASCIIP_SORT_BUCKETS];   /* Digit counts, then scatter offsets */
+
+} Asciip_Sort_Slice;
+
+
+typedef struct _asciip_sort_job_t
+{
+   uint64_t          *keys[2];     /* Caller keys and scratch keys */
+   uint64_t          *values[2];   /* Caller values and scratch values */
+   size_t             count;       /* Number of keys */
+   uint32_t           slices;      /* Number of slices */
+   uint32_t           shift;       /* Bit offset of the current digit */
+   uint8_t            src;         /* Buffer holding the keys of the current pass */
+   Asciip_Sort_Slice *slice;       /* Slices the keys are split into */
+
+} Asciip_Sort_Job;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_sort_count
+ *
+ * Description : Scheduler body, builds the digit histogram of each
+ *               slice in [begin, end).
+ ************************************************************************/
+static void asciip_sort_count(size_t  begin,
+                              size_t  end,
+                              void   *context)
+{
+   Asciip_Sort_Job *job = context;
+   Asciip_Sort_Slice *slice;
+   const uint64_t *keys = job->keys[job->src];
+   uint32_t shift = job->shift;
+   size_t ind;
+
+   for (; begin < end; begin++)
+   {
+      slice = &job->slice[begin];
+      memset(slice->hist, 0, sizeof(slice->hist));
+      for (ind = slice->begin; ind < slice->end; ind++)
+      {
+         slice->hist[(keys[ind] >> shift) & (ASCIIP_SORT_BUCKETS - 1)]++;
+      }
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_sort_offsets
+ *
+ * Description : Turns the slice histograms into scatter offsets: bucket
+ *               by bucket, slice by slice, so keys keep their relative
+ *               order. Returns 1 if every key shares the digit, when a
+ *               pass would only copy.
+ ************************************************************************/
+static uint8_t asciip_sort_offsets(Asciip_Sort_Job *job)
+{
+   size_t running = 0;
+   size_t total;
+   size_t bucket;
+   uint32_t slice;
+   uint32_t digit;
+   uint8_t skip = 0;
+
+   for (digit = 0; digit < ASCIIP_SORT_BUCKETS; digit++)
+   {
+      total = 0;
+      for (slice = 0; slice < job->slices; slice++)
+      {
+         bucket = job->slice[slice].hist[digit];
+         job->slice[slice].hist[digit] = running;
+         running += bucket;
+         total += bucket;
+      }
+
+      if (total == job->count)
+      {
+         skip = 1;
+      }
+   }
+
+   return skip;
+}
+
+/************************************************************************
+ * Name        : asciip_sort_scatter
+ *
+ * Description : Scheduler body, moves the keys of each slice in
+ *               [begin, end) to their place in the other buffer.
+ ************************************************************************/
+static void asciip_sort_scatter(size_t  begin,
+                                size_t  end,
+                                void   *context)
+{
+   Asciip_Sort_Job *job = context;
+   Asciip_Sort_Slice *slice;
+   const uint64_t *src_keys = job->keys[job->src];
+   const uint64_t *src_values = job->values[job->src];
+   uint64_t *dst_keys = job->keys[job->src ^ 1];
+   uint64_t *dst_values = job->values[job->src ^ 1];
+   uint32_t shift = job->shift;
+   size_t *offsetp;
+   size_t ind;
+
+   for (; begin < end; begin++)
+   {
+      slice = &job->slice[begin];
+      for (ind = slice->begin; ind < slice->end; ind++)
+      {
+         offsetp = &slice->hist[(src_keys[ind] >> shift) & (ASCIIP_SORT_BUCKETS - 1)];
+         dst_keys[*offsetp] = src_keys[ind];
+         dst_values[*offsetp] = src_values[ind];
+         (*offsetp)++;
+      }
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_sort_insertion
+ *
+ * Description : Stable insertion sort for small inputs.
+ ************************************************************************/
+static void asciip_sort_insertion(uint64_t *keys,
+                                  uint64_t *values,
+                                  size_t    count)
+{
+   uint64_t key;
+   uint64_t value;
+   size_t ind;
+   size_t pos;
+
+   for (ind = 1; ind < count; ind++)
+   {
+      key = keys[ind];
+      value = values[ind];
+
+      for (pos = ind; (pos > 0) && (keys[pos - 1] > key); pos--)
+      {
+         keys[pos] = keys[pos - 1];
+         values[pos] = values[pos - 1];
+      }
+
+      keys[pos] = key;
+      values[pos] = value;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_sort_threads
+ *
+ * See         : asciip_sort.h
+ *
+ * Description : Returns the number of slices the engine splits n keys
+ *               into.
+ ************************************************************************/
+uint32_t asciip_sort_threads(size_t count)
+{
+   size_t threads = count / ASCIIP_SORT_THREAD_MIN;
+   uint32_t workers = asciip_sched_workers();
+
+   if (threads > workers)
+   {
+      threads = workers;
+   }
+
+   if (threads > ASCIIP_SORT_MAX_THREADS)
+   {
+      threads = ASCIIP_SORT_MAX_THREADS;
+   }
+
+   return (threads == 0) ? 1 : (uint32_t)threads;
+}
+
+/************************************************************************
+ * Name        : asciip_sort_radix
+ *
+ * See         : asciip_sort.h
+ *
+ * Description : Stable sort of keys in ascending order, applying the
+ *               same permutation to values.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_sort_radix(uint64_t     *keys,
+                         uint64_t     *values,
+                         size_t        count,
+                         uint32_t      threads,
+                         Asciip_Error *error)
+{
+   Asciip_Sort_Job job;
+   uint32_t pass;
+   uint32_t slice;
+
+   if (((keys == NULL) || (values == NULL)) && (count > 0))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_sort_radix: Keys or values were NULL.");
+      return -1;
+   }
+
+   if (count < ASCIIP_SORT_SMALL)
+   {
+      asciip_sort_insertion(keys, values, count);
+      return 0;
+   }
+
+   if (threads == 0)
+   {
+      threads = asciip_sort_threads(count);
+   }
+   if (threads > count / ASCIIP_SORT_SMALL)
+   {
+      threads = (uint32_t)(count / ASCIIP_SORT_SMALL);
+   }
+
+   job.keys[0] = keys;
+   job.values[0] = values;
+   job.keys[1] = malloc(count * sizeof(uint64_t));
+   job.values[1] = malloc(count * sizeof(uint64_t));
+   job.slice = malloc(threads * sizeof(Asciip_Sort_Slice));
+   job.count = count;
+   job.slices = threads;
+   job.src = 0;
+
+   if ((job.keys[1] == NULL) || (job.values[1] == NULL) || (job.slice == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_sort_radix: Could not allocate scratch space.");
+      free(job.keys[1]);
+      free(job.values[1]);
+      free(job.slice);
+      return -1;
+   }
+
+   for (slice = 0; slice < threads; slice++)
+   {
+      job.slice[slice].begin = count * slice / threads;
+      job.slice[slice].end = count * (slice + 1) / threads;
+   }
+
+   /* Each step runs one slice per chunk on the shared scheduler */
+   for (pass = 0; pass < ASCIIP_SORT_PASSES; pass++)
+   {
+      job.shift = pass * ASCIIP_SORT_DIGIT_BITS;
+      asciip_sched_parallel_for(0, threads, 1, asciip_sort_count, &job, NULL);
+      if (asciip_sort_offsets(&job))
+      {
+         continue;
+      }
+
+      asciip_sched_parallel_for(0, threads, 1, asciip_sort_scatter, &job, NULL);
+      job.src ^= 1;
+   }
+
+   /* An odd number of scatter passes leaves the result in scratch space */
+   if (job.src != 0)
+   {
+      memcpy(keys, job.keys[1], count * sizeof(uint64_t));
+      memcpy(values, job.values[1], count * sizeof(uint64_t));
+   }
+
+   free(job.keys[1]);
+   free(job.values[1]);
+   free(job.slice);
+
+   return 0;
+}
@@ -0,0 +1,441 @@
+/************************************************************************
+ *
+ * File        : asciip_stats.c
+ *
+ * Description : Contains the bounds and statistics kernel used to
+ *               autoscale plot axes.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_sched.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Vector kernels are built with per-function target attributes, so the
+ * rest of the library keeps the default instruction set */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ASCIIP_STATS_X86 1
+#include <immintrin.h>
+#else
+#define ASCIIP_STATS_X86 0
+#endif
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_stats_job_t
+{
+   const Asciip_Series *series;                            /* Series reduced */
+   size_t               grain;                             /* Points per chunk */
+   uint8_t              isa;                               /* Kernel to use */
+   Asciip_Bounds        partial[ASCIIP_STATS_MAX_CHUNKS];  /* Bounds per chunk */
+
+} Asciip_Stats_Job;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_stats_start
+ *
+ * Description : Sets statistics to those of no values, ready to
+ *               accumulate.
+ ************************************************************************/
+static void asciip_stats_start(Asciip_Axis_Stats *stats)
+{
+   stats->min = INFINITY;
+   stats->max = -INFINITY;
+   stats->sum = 0.0;
+   stats->count = 0;
+   stats->nans = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_add
+ *
+ * Description : Accumulates one value.
+ ************************************************************************/
+static inline void asciip_stats_add(Asciip_Axis_Stats *stats,
+                                    double             value)
+{
+   if (isnan(value))
+   {
+      stats->nans++;
+      return;
+   }
+
+   stats->min = (value < stats->min) ? value : stats->min;
+   stats->max = (value > stats->max) ? value : stats->max;
+   stats->sum += value;
+   stats->count++;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_finish
+ *
+ * Description : Marks min and max as NaN if no value was accumulated.
+ ************************************************************************/
+static void asciip_stats_finish(Asciip_Axis_Stats *stats)
+{
+   if (stats->count == 0)
+   {
+      stats->min = NAN;
+      stats->max = NAN;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_stats_scalar
+ *
+ * Description : Portable kernel, also used for the tails of the vector
+ *               kernels.
+ ************************************************************************/
+static void asciip_stats_scalar(const double      *values,
+                                size_t             count,
+                                Asciip_Axis_Stats *stats)
+{
+   size_t ind;
+
+   for (ind = 0; ind < count; ind++)
+   {
+      asciip_stats_add(stats, values[ind]);
+   }
+}
+
+#if ASCIIP_STATS_X86
+/************************************************************************
+ * Name        : asciip_stats_fold_lanes
+ *
+ * Description : Folds per-lane accumulators of a vector kernel into
+ *               stats.
+ ************************************************************************/
+static void asciip_stats_fold_lanes(const double      *mins,
+                                    const double      *maxs,
+                                    const double      *sums,
+                                    const double      *nans,
+                                    size_t             lanes,
+                                    size_t             count,
+                                    Asciip_Axis_Stats *stats)
+{
+   size_t nan_count = 0;
+   size_t lane;
+
+   for (lane = 0; lane < lanes; lane++)
+   {
+      stats->min = (mins[lane] < stats->min) ? mins[lane] : stats->min;
+      stats->max = (maxs[lane] > stats->max) ? maxs[lane] : stats->max;
+      stats->sum += sums[lane];
+      nan_count += (size_t)nans[lane];
+   }
+
+   stats->nans += nan_count;
+   stats->count += count - nan_count;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_sse2
+ *
+ * Description : SSE2 kernel, two values per instruction. min and max
+ *               take the accumulator when the value is NaN, NaN lanes
+ *               are masked out of the sum and counted instead.
+ ************************************************************************/
+__attribute__((target("sse2")))
+static void asciip_stats_sse2(const double      *values,
+                              size_t             count,
+                              Asciip_Axis_Stats *stats)
+{
+   __m128d vmin = _mm_set1_pd(INFINITY);
+   __m128d vmax = _mm_set1_pd(-INFINITY);
+   __m128d vsum = _mm_setzero_pd();
+   __m128d vnan = _mm_setzero_pd();
+   __m128d one = _mm_set1_pd(1.0);
+   double mins[2];
+   double maxs[2];
+   double sums[2];
+   double nans[2];
+   size_t ind;
+
+   for (ind = 0; ind + 2 <= count; ind += 2)
+   {
+      __m128d value = _mm_loadu_pd(values + ind);
+      __m128d nan_mask = _mm_cmpunord_pd(value, value);
+
+      vmin = _mm_min_pd(value, vmin);
+      vmax = _mm_max_pd(value, vmax);
+      vsum = _mm_add_pd(vsum, _mm_andnot_pd(nan_mask, value));
+      vnan = _mm_add_pd(vnan, _mm_and_pd(nan_mask, one));
+   }
+
+   _mm_storeu_pd(mins, vmin);
+   _mm_storeu_pd(maxs, vmax);
+   _mm_storeu_pd(sums, vsum);
+   _mm_storeu_pd(nans, vnan);
+   asciip_stats_fold_lanes(mins, maxs, sums, nans, 2, ind, stats);
+
+   asciip_stats_scalar(values + ind, count - ind, stats);
+}
+
+/************************************************************************
+ * Name        : asciip_stats_avx2
+ *
+ * Description : AVX2 kernel, eight values per iteration in two
+ *               independent accumulator sets so consecutive adds do
+ *               not wait on each other.
+ ************************************************************************/
+__attribute__((target("avx2")))
+static void asciip_stats_avx2(const double      *values,
+                              size_t             count,
+                              Asciip_Axis_Stats *stats)
+{
+   __m256d vmin[2];
+   __m256d vmax[2];
+   __m256d vsum[2];
+   __m256d vnan[2];
+   __m256d one = _mm256_set1_pd(1.0);
+   double mins[4];
+   double maxs[4];
+   double sums[4];
+   double nans[4];
+   size_t ind;
+   uint8_t set;
+
+   for (set = 0; set < 2; set++)
+   {
+      vmin[set] = _mm256_set1_pd(INFINITY);
+      vmax[set] = _mm256_set1_pd(-INFINITY);
+      vsum[set] = _mm256_setzero_pd();
+      vnan[set] = _mm256_setzero_pd();
+   }
+
+   for (ind = 0; ind + 8 <= count; ind += 8)
+   {
+      for (set = 0; set < 2; set++)
+      {
+         __m256d value = _mm256_loadu_pd(values + ind + 4 * set);
+         __m256d nan_mask = _mm256_cmp_pd(value, value, _CMP_UNORD_Q);
+
+         vmin[set] = _mm256_min_pd(value, vmin[set]);
+         vmax[set] = _mm256_max_pd(value, vmax[set]);
+         vsum[set] = _mm256_add_pd(vsum[set], _mm256_andnot_pd(nan_mask, value));
+         vnan[set] = _mm256_add_pd(vnan[set], _mm256_and_pd(nan_mask, one));
+      }
+   }
+
+   _mm256_storeu_pd(mins, _mm256_min_pd(vmin[0], vmin[1]));
+   _mm256_storeu_pd(maxs, _mm256_max_pd(vmax[0], vmax[1]));
+   _mm256_storeu_pd(sums, _mm256_add_pd(vsum[0], vsum[1]));
+   _mm256_storeu_pd(nans, _mm256_add_pd(vnan[0], vnan[1]));
+   asciip_stats_fold_lanes(mins, maxs, sums, nans, 4, ind, stats);
+
+   asciip_stats_scalar(values + ind, count - ind, stats);
+}
+#endif
+
+/************************************************************************
+ * Name        : asciip_stats_isa
+ *
+ * See         : asciip_stats.h
+ *
+ * Description : Returns the widest instruction set the kernel can use
+ *               on this processor.
+ ************************************************************************/
+uint8_t asciip_stats_isa(void)
+{
+#if ASCIIP_STATS_X86
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+   {
+      return ASCIIP_STATS_AVX2;
+   }
+   if (__builtin_cpu_supports("sse2"))
+   {
+      return ASCIIP_STATS_SSE2;
+   }
+#endif
+
+   return ASCIIP_STATS_SCALAR;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_column
+ *
+ * See         : asciip_stats.h
+ *
+ * Description : Computes the statistics of count values in one pass
+ *               with the requested, or best supported, kernel.
+ ************************************************************************/
+void asciip_stats_column(const double      *values,
+                         size_t             count,
+                         uint8_t            isa,
+                         Asciip_Axis_Stats *result)
+{
+   uint8_t supported = asciip_stats_isa();
+
+   if (isa > supported)
+   {
+      isa = supported;
+   }
+
+   asciip_stats_start(result);
+
+#if ASCIIP_STATS_X86
+   if (isa == ASCIIP_STATS_AVX2)
+   {
+      asciip_stats_avx2(values, count, result);
+   }
+   else if (isa == ASCIIP_STATS_SSE2)
+   {
+      asciip_stats_sse2(values, count, result);
+   }
+   else
+#endif
+   {
+      asciip_stats_scalar(values, count, result);
+   }
+
+   asciip_stats_finish(result);
+}
+
+/************************************************************************
+ * Name        : asciip_stats_merge
+ *
+ * See         : asciip_stats.h
+ *
+ * Description : Folds the statistics of one block of values into the
+ *               statistics of another.
+ ************************************************************************/
+void asciip_stats_merge(Asciip_Axis_Stats       *result,
+                        const Asciip_Axis_Stats *other)
+{
+   if (other->count > 0)
+   {
+      result->min = ((result->count == 0) || (other->min < result->min)) ? other->min : result->min;
+      result->max = ((result->count == 0) || (other->max > result->max)) ? other->max : result->max;
+      result->sum += other->sum;
+      result->count += other->count;
+   }
+
+   result->nans += other->nans;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_chunk
+ *
+ * Description : Scheduler body, computes the bounds of one chunk of a
+ *               series.
+ ************************************************************************/
+static void asciip_stats_chunk(size_t  begin,
+                               size_t  end,
+                               void   *context)
+{
+   Asciip_Stats_Job *job = context;
+   Asciip_Bounds *partial = &job->partial[begin / job->grain];
+
+   asciip_stats_column(job->series->x + begin, end - begin, job->isa, &partial->x);
+   asciip_stats_column(job->series->y + begin, end - begin, job->isa, &partial->y);
+}
+
+/************************************************************************
+ * Name        : asciip_stats_series
+ *
+ * See         : asciip_stats.h
+ *
+ * Description : Computes the bounds of both columns of a series.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_stats_series(const Asciip_Series *series,
+                           Asciip_Bounds       *result,
+                           Asciip_Error        *error)
+{
+   Asciip_Stats_Job job;
+   size_t chunk;
+   uint8_t isa;
+
+   if ((series == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_stats_series: One of the parameters were NULL.");
+      return -1;
+   }
+
+   isa = asciip_stats_isa();
+   if (series->size < 2 * ASCIIP_STATS_CHUNK)
+   {
+      asciip_stats_column(series->x, series->size, isa, &result->x);
+      asciip_stats_column(series->y, series->size, isa, &result->y);
+      return 0;
+   }
+
+   job.series = series;
+   job.isa = isa;
+   job.grain = (series->size + ASCIIP_STATS_MAX_CHUNKS - 1) / ASCIIP_STATS_MAX_CHUNKS;
+   job.grain = (job.grain < ASCIIP_STATS_CHUNK) ? ASCIIP_STATS_CHUNK : job.grain;
+   asciip_sched_parallel_for(0, series->size, job.grain, asciip_stats_chunk, &job, NULL);
+
+   /* Folded in chunk order, whichever worker ran each */
+   *result = job.partial[0];
+   for (chunk = 1; chunk * job.grain < series->size; chunk++)
+   {
+      asciip_stats_merge(&result->x, &job.partial[chunk].x);
+      asciip_stats_merge(&result->y, &job.partial[chunk].y);
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_stats_list
+ *
+ * See         : asciip_stats.h
+ *
+ * Description : Computes the bounds of both axes of a list in one walk.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_stats_list(const Asciip_List *list,
+                         Asciip_Bounds     *result,
+                         Asciip_Error      *error)
+{
+   const Asciip_Node *nodep;
+
+   if ((list == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_stats_list: One of the parameters were NULL.");
+      return -1;
+   }
+
+   asciip_stats_start(&result->x);
+   asciip_stats_start(&result->y);
+
+   for (nodep = list->head; nodep != NULL; nodep = nodep->next)
+   {
+      asciip_stats_add(&result->x, nodep->data->x);
+      asciip_stats_add(&result->y, nodep->data->y);
+   }
+
+   asciip_stats_finish(&result->x);
+   asciip_stats_finish(&result->y);
+
+   return 0;
+}
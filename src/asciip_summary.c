@@ -0,0 +1,445 @@
+/************************************************************************
+ *
+ * File        : asciip_summary.c
+ *
+ * Description : Contains methods to keep running bounds on a list so
+ *               that a renderer can autoscale without scanning.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_summary.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+#define ASCIIP_SUMMARY_MIN_CAPACITY 16
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_summary_heap_append
+ *
+ * Description : Appends a value after the heap without sifting it in.
+ ************************************************************************/
+static int8_t asciip_summary_heap_append(Asciip_Summary_Heap *heap,
+                                         double               value)
+{
+   double *values;
+   size_t capacity;
+
+   if (heap->size == heap->capacity)
+   {
+      capacity = (heap->capacity < ASCIIP_SUMMARY_MIN_CAPACITY) ? ASCIIP_SUMMARY_MIN_CAPACITY : 2 * heap->capacity;
+      if ((values = realloc(heap->values, capacity * sizeof(double))) == NULL)
+      {
+         return -1;
+      }
+
+      heap->values = values;
+      heap->capacity = capacity;
+   }
+
+   heap->values[heap->size++] = value;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_heap_flush
+ *
+ * Description : Sifts every appended value into heap order.
+ ************************************************************************/
+static void asciip_summary_heap_flush(Asciip_Summary_Heap *heap)
+{
+   double *values = heap->values;
+   double value;
+   size_t pos;
+
+   for (; heap->heaped < heap->size; heap->heaped++)
+   {
+      value = values[heap->heaped];
+      for (pos = heap->heaped; (pos > 0) && (value < values[(pos - 1) / 2]); pos = (pos - 1) / 2)
+      {
+         values[pos] = values[(pos - 1) / 2];
+      }
+      values[pos] = value;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_heap_pop
+ *
+ * Description : Removes the smallest value of a flushed, non-empty
+ *               heap.
+ ************************************************************************/
+static void asciip_summary_heap_pop(Asciip_Summary_Heap *heap)
+{
+   double *values = heap->values;
+   double value = values[--heap->size];
+   size_t pos = 0;
+   size_t child;
+
+   heap->heaped = heap->size;
+   while ((child = 2 * pos + 1) < heap->size)
+   {
+      if ((child + 1 < heap->size) && (values[child + 1] < values[child]))
+      {
+         child++;
+      }
+
+      if (!(values[child] < value))
+      {
+         break;
+      }
+
+      values[pos] = values[child];
+      pos = child;
+   }
+
+   if (heap->size > 0)
+   {
+      values[pos] = value;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_axis_reset
+ *
+ * Description : Empties an axis, keeping its heap memory.
+ ************************************************************************/
+static void asciip_summary_axis_reset(Asciip_Summary_Axis *axis)
+{
+   uint8_t side;
+
+   axis->stats.min = NAN;
+   axis->stats.max = NAN;
+   axis->stats.sum = 0.0;
+   axis->stats.count = 0;
+   axis->stats.nans = 0;
+
+   for (side = 0; side < 2; side++)
+   {
+      axis->live[side].size = 0;
+      axis->live[side].heaped = 0;
+      axis->dead[side].size = 0;
+      axis->dead[side].heaped = 0;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_axis_free
+ *
+ * Description : Releases the heaps of an axis.
+ ************************************************************************/
+static void asciip_summary_axis_free(Asciip_Summary_Axis *axis)
+{
+   uint8_t side;
+
+   for (side = 0; side < 2; side++)
+   {
+      free(axis->live[side].values);
+      free(axis->dead[side].values);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_axis_add
+ *
+ * Description : Records an added value. NaNs are only counted.
+ ************************************************************************/
+static int8_t asciip_summary_axis_add(Asciip_Summary_Axis *axis,
+                                      double               value)
+{
+   if (isnan(value))
+   {
+      axis->stats.nans++;
+      return 0;
+   }
+
+   if ((axis->stats.count == 0) || (value < axis->stats.min))
+   {
+      axis->stats.min = value;
+   }
+   if ((axis->stats.count == 0) || (value > axis->stats.max))
+   {
+      axis->stats.max = value;
+   }
+   axis->stats.sum += value;
+   axis->stats.count++;
+
+   if ((asciip_summary_heap_append(&axis->live[0], value) != 0) ||
+       (asciip_summary_heap_append(&axis->live[1], -value) != 0))
+   {
+      return -1;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_axis_remove
+ *
+ * Description : Records a removed value, restoring the extents from
+ *               the heaps. Returns 1 when the heaps hold too many
+ *               removed values and should be rebuilt.
+ ************************************************************************/
+static int8_t asciip_summary_axis_remove(Asciip_Summary_Axis *axis,
+                                         double               value)
+{
+   Asciip_Summary_Heap *live;
+   Asciip_Summary_Heap *dead;
+   uint8_t side;
+
+   if (isnan(value))
+   {
+      axis->stats.nans--;
+      return 0;
+   }
+
+   axis->stats.sum -= value;
+   if (--axis->stats.count == 0)
+   {
+      /* Nothing left to track, drop the removed values with the rest */
+      size_t nans = axis->stats.nans;
+
+      asciip_summary_axis_reset(axis);
+      axis->stats.nans = nans;
+      return 0;
+   }
+
+   for (side = 0; side < 2; side++)
+   {
+      live = &axis->live[side];
+      dead = &axis->dead[side];
+
+      if (asciip_summary_heap_append(dead, (side == 0) ? value : -value) != 0)
+      {
+         return -1;
+      }
+      asciip_summary_heap_flush(live);
+      asciip_summary_heap_flush(dead);
+
+      /* Removed values leave the live heap once they reach its top */
+      while ((dead->size > 0) && !(live->values[0] < dead->values[0]) && !(dead->values[0] < live->values[0]))
+      {
+         asciip_summary_heap_pop(live);
+         asciip_summary_heap_pop(dead);
+      }
+   }
+
+   axis->stats.min = axis->live[0].values[0];
+   axis->stats.max = -axis->live[1].values[0];
+
+   return (axis->dead[0].size + axis->dead[1].size > 2 * axis->stats.count + ASCIIP_SUMMARY_SLACK) ? 1 : 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_rebuild
+ *
+ * Description : Rebuilds the summary from every point of the list.
+ ************************************************************************/
+static int8_t asciip_summary_rebuild(Asciip_Summary    *summary,
+                                     const Asciip_List *list)
+{
+   const Asciip_Node *nodep;
+
+   asciip_summary_axis_reset(&summary->x);
+   asciip_summary_axis_reset(&summary->y);
+   summary->stale = 1;
+
+   for (nodep = list->head; nodep != NULL; nodep = nodep->next)
+   {
+      if ((asciip_summary_axis_add(&summary->x, nodep->data->x) != 0) ||
+          (asciip_summary_axis_add(&summary->y, nodep->data->y) != 0))
+      {
+         return -1;
+      }
+   }
+
+   summary->stale = 0;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_enable
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Starts or stops keeping running bounds on a list.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_summary_enable(Asciip_List  *list,
+                             uint8_t       enable,
+                             Asciip_Error *error)
+{
+   Asciip_Summary *summary;
+
+   if (list == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_summary_enable: List was NULL.");
+      return -1;
+   }
+
+   if (!enable)
+   {
+      asciip_summary_destroy(list->summary);
+      list->summary = NULL;
+      return 0;
+   }
+
+   if (list->summary != NULL)
+   {
+      return 0;
+   }
+
+   if ((summary = calloc(1, sizeof(Asciip_Summary))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_summary_enable: Could not malloc summary.");
+      return -1;
+   }
+
+   if (asciip_summary_rebuild(summary, list) != 0)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_summary_enable: Could not build summary.");
+      asciip_summary_destroy(summary);
+      return -1;
+   }
+
+   list->summary = summary;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_get
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Copies the running bounds of a list into result.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_summary_get(Asciip_List   *list,
+                          Asciip_Bounds *result,
+                          Asciip_Error  *error)
+{
+   if ((list == NULL) || (list->summary == NULL) || (result == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_summary_get: List not tracked or result NULL.");
+      return -1;
+   }
+
+   if (list->summary->stale && (asciip_summary_rebuild(list->summary, list) != 0))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_summary_get: Could not rebuild summary.");
+      return -1;
+   }
+
+   result->x = list->summary->x.stats;
+   result->y = list->summary->y.stats;
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_summary_add
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Records a point added to the tracked list.
+ ************************************************************************/
+void asciip_summary_add(Asciip_Summary *summary,
+                        double          x,
+                        double          y)
+{
+   if ((summary == NULL) || summary->stale)
+   {
+      return;
+   }
+
+   /* Out of memory falls back to a rebuild on the next get */
+   if ((asciip_summary_axis_add(&summary->x, x) != 0) ||
+       (asciip_summary_axis_add(&summary->y, y) != 0))
+   {
+      summary->stale = 1;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_remove
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Records a point removed from the tracked list.
+ ************************************************************************/
+void asciip_summary_remove(Asciip_Summary *summary,
+                           double          x,
+                           double          y)
+{
+   if ((summary == NULL) || summary->stale)
+   {
+      return;
+   }
+
+   if ((asciip_summary_axis_remove(&summary->x, x) != 0) ||
+       (asciip_summary_axis_remove(&summary->y, y) != 0))
+   {
+      summary->stale = 1;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_invalidate
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Marks the summary to be rebuilt before its next use.
+ ************************************************************************/
+void asciip_summary_invalidate(Asciip_Summary *summary)
+{
+   if (summary != NULL)
+   {
+      summary->stale = 1;
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_summary_destroy
+ *
+ * See         : asciip_summary.h
+ *
+ * Description : Releases a summary.
+ ************************************************************************/
+void asciip_summary_destroy(Asciip_Summary *summary)
+{
+   if (summary == NULL)
+   {
+      return;
+   }
+
+   asciip_summary_axis_free(&summary->x);
+   asciip_summary_axis_free(&summary->y);
+   free(summary);
+}
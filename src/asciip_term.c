@@ -0,0 +1,386 @@
+/************************************************************************
+ *
+ * File        : asciip_term.c
+ *
+ * Description : Contains methods to put canvas frames on a terminal,
+ *               sending only the cells that changed.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_term.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Bytes of the longest glyph, a braille pattern in UTF-8 */
+#define ASCIIP_TERM_GLYPH_MAX 3
+
+/* Gaps this wide or wider are always cheaper to skip with a move */
+#define ASCIIP_TERM_GAP_MAX 7
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_term_glyph
+ *
+ * Description : Gets the glyph of a canvas cell: the character in text
+ *               mode, the braille code point in braille mode, or a
+ *               space for a braille cell without dots.
+ ************************************************************************/
+static inline uint32_t asciip_term_glyph(const Asciip_Canvas *canvas,
+                                         size_t               row,
+                                         size_t               col)
+{
+   uint8_t mask;
+
+   if (canvas->mode == ASCIIP_CANVAS_BRAILLE)
+   {
+      mask = canvas->dots[row * canvas->width + col];
+      return (mask == 0) ? ' ' : 0x2800 + mask;
+   }
+
+   return (uint8_t)canvas->cells[row * canvas->stride + col];
+}
+
+/************************************************************************
+ * Name        : asciip_term_glyph_size
+ *
+ * Description : Gets the bytes a glyph takes in UTF-8.
+ ************************************************************************/
+static inline size_t asciip_term_glyph_size(uint32_t glyph)
+{
+   return (glyph < 0x80) ? 1 : ASCIIP_TERM_GLYPH_MAX;
+}
+
+/************************************************************************
+ * Name        : asciip_term_put_glyph
+ *
+ * Description : Appends a glyph in UTF-8.
+ ************************************************************************/
+static inline char *asciip_term_put_glyph(char     *out,
+                                          uint32_t  glyph)
+{
+   if (glyph < 0x80)
+   {
+      *out++ = (char)glyph;
+      return out;
+   }
+
+   *out++ = (char)(0xE0 | (glyph >> 12));
+   *out++ = (char)(0x80 | ((glyph >> 6) & 0x3F));
+   *out++ = (char)(0x80 | (glyph & 0x3F));
+   return out;
+}
+
+/************************************************************************
+ * Name        : asciip_term_put_number
+ *
+ * Description : Appends a decimal number.
+ ************************************************************************/
+static inline char *asciip_term_put_number(char   *out,
+                                           size_t  number)
+{
+   char digits[20];
+   size_t count = 0;
+
+   do
+   {
+      digits[count++] = (char)('0' + number % 10);
+      number /= 10;
+   } while (number > 0);
+
+   while (count > 0)
+   {
+      *out++ = digits[--count];
+   }
+
+   return out;
+}
+
+/************************************************************************
+ * Name        : asciip_term_number_size
+ *
+ * Description : Gets the digits of a decimal number.
+ ************************************************************************/
+static inline size_t asciip_term_number_size(size_t number)
+{
+   size_t count = 1;
+
+   while (number >= 10)
+   {
+      number /= 10;
+      count++;
+   }
+
+   return count;
+}
+
+/************************************************************************
+ * Name        : asciip_term_init
+ *
+ * See         : asciip_term.h
+ *
+ * Description : Initializes output of frames to a file descriptor.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+Asciip_Term *asciip_term_init(int            fd,
+                              size_t         width,
+                              size_t         height,
+                              Asciip_Term  **result,
+                              Asciip_Error  *error)
+{
+   Asciip_Term *term;
+
+   if (result == NULL)
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_term_init: Result pointer was NULL.");
+      return NULL;
+   }
+
+   if ((width == 0) || (height == 0) || (width > 65535) || (height > 65535))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_term_init: Bad terminal size.");
+      return NULL;
+   }
+
+   if ((term = calloc(1, sizeof(Asciip_Term))) == NULL)
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_term_init: Could not malloc terminal.");
+      return NULL;
+   }
+
+   /* Worst case is a move before every changed glyph */
+   term->fd = fd;
+   term->width = width;
+   term->height = height;
+   term->top = 1;
+   term->capacity = width * height * (ASCIIP_TERM_MOVE_MAX + ASCIIP_TERM_GLYPH_MAX);
+   term->shown = malloc(width * height * sizeof(uint32_t));
+   term->buffer = malloc(term->capacity);
+   if ((term->shown == NULL) || (term->buffer == NULL))
+   {
+      report_error(error, ASCIIP_ERR_MEM, "asciip_term_init: Could not malloc frame buffers.");
+      asciip_term_destroy(term);
+      return NULL;
+   }
+
+   *result = term;
+   return term;
+}
+
+/************************************************************************
+ * Name        : asciip_term_destroy
+ *
+ * See         : asciip_term.h
+ *
+ * Description : Releases the terminal.
+ ************************************************************************/
+void asciip_term_destroy(Asciip_Term *term)
+{
+   if (term == NULL)
+   {
+      return;
+   }
+
+   free(term->shown);
+   free(term->buffer);
+   free(term);
+}
+
+/************************************************************************
+ * Name        : asciip_term_invalidate
+ *
+ * See         : asciip_term.h
+ *
+ * Description : Forgets what is on screen.
+ ************************************************************************/
+void asciip_term_invalidate(Asciip_Term *term)
+{
+   term->valid = 0;
+}
+
+/************************************************************************
+ * Name        : asciip_term_diff
+ *
+ * See         : asciip_term.h
+ *
+ * Description : Builds the bytes that bring the screen from the last
+ *               frame to the canvas. The cursor position is tracked so
+ *               that a changed cell right after the last one sent needs
+ *               no move, and a short gap on the same row is bridged by
+ *               whichever of its glyphs or a cursor forward is shorter.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+const char *asciip_term_diff(Asciip_Term         *term,
+                             const Asciip_Canvas *canvas,
+                             size_t              *length,
+                             Asciip_Error        *error)
+{
+   uint32_t *shown;
+   uint32_t glyph;
+   char *out;
+   size_t row;
+   size_t col;
+   size_t cursor_row = SIZE_MAX;
+   size_t cursor_col = 0;
+   size_t gap;
+   size_t bridge;
+   size_t ind;
+
+   if ((term == NULL) || (canvas == NULL) || (length == NULL))
+   {
+      report_error(error, ASCIIP_ERR_NULL_PTR, "asciip_term_diff: One of the parameters were NULL.");
+      return NULL;
+   }
+
+   if ((canvas->width != term->width) || (canvas->height != term->height))
+   {
+      report_error(error, ASCIIP_ERR_RANGE, "asciip_term_diff: Canvas size did not match.");
+      return NULL;
+   }
+
+   out = term->buffer;
+   for (row = 0; row < term->height; row++)
+   {
+      shown = term->shown + row * term->width;
+      for (col = 0; col < term->width; col++)
+      {
+         glyph = asciip_term_glyph(canvas, row, col);
+         if (term->valid && (glyph == shown[col]))
+         {
+            continue;
+         }
+
+         if ((cursor_row != row) || (col - cursor_col >= ASCIIP_TERM_GAP_MAX))
+         {
+            /* ESC [ row ; col H, or ESC [ n C to skip ahead on the row */
+            *out++ = '\033';
+            *out++ = '[';
+            if (cursor_row != row)
+            {
+               out = asciip_term_put_number(out, term->top + row);
+               *out++ = ';';
+               out = asciip_term_put_number(out, col + 1);
+               *out++ = 'H';
+            }
+            else
+            {
+               out = asciip_term_put_number(out, col - cursor_col);
+               *out++ = 'C';
+            }
+         }
+         else if (col > cursor_col)
+         {
+            gap = col - cursor_col;
+            bridge = 0;
+            for (ind = cursor_col; ind < col; ind++)
+            {
+               bridge += asciip_term_glyph_size(shown[ind]);
+            }
+
+            if (bridge <= 3 + asciip_term_number_size(gap))
+            {
+               for (ind = cursor_col; ind < col; ind++)
+               {
+                  out = asciip_term_put_glyph(out, shown[ind]);
+               }
+            }
+            else
+            {
+               *out++ = '\033';
+               *out++ = '[';
+               out = asciip_term_put_number(out, gap);
+               *out++ = 'C';
+            }
+         }
+
+         out = asciip_term_put_glyph(out, glyph);
+         shown[col] = glyph;
+         cursor_row = row;
+         cursor_col = col + 1;
+      }
+   }
+
+   term->valid = 1;
+   *length = (size_t)(out - term->buffer);
+   return term->buffer;
+}
+
+/************************************************************************
+ * Name        : asciip_term_draw
+ *
+ * See         : asciip_term.h
+ *
+ * Description : Sends the changes from the last frame with one write.
+ *
+ *               If error is NULL, the errors will not be tracked.
+ ************************************************************************/
+int8_t asciip_term_draw(Asciip_Term         *term,
+                        const Asciip_Canvas *canvas,
+                        Asciip_Error        *error)
+{
+   const char *frame;
+   size_t length;
+   size_t sent = 0;
+   ssize_t count;
+
+   if ((frame = asciip_term_diff(term, canvas, &length, error)) == NULL)
+   {
+      /* Error reporting done in function */
+      return -1;
+   }
+
+   term->writes = 0;
+   while (sent < length)
+   {
+      count = write(term->fd, frame + sent, length - sent);
+      term->writes++;
+      if (count < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+
+         term->valid = 0;
+         report_error(error, ASCIIP_ERR_IO, "asciip_term_draw: Could not write frame.");
+         return -1;
+      }
+      sent += (size_t)count;
+   }
+
+   term->frames++;
+   term->bytes = length;
+   term->total_bytes += length;
+   term->total_writes += term->writes;
+
+   return 0;
+}
@@ -1,12 +1,1005 @@
-/*
- * main.c
+/************************************************************************
  *
- *  Created on: Jul 16, 2016
- *      Author: nic
- */
+ * File        : main.c
+ *
+ * Description : Command-line front end. Reads x/y pairs from the files
+ *               named, or from stdin, and prints a plot of them.
+ *
+ *               usage: asciip [-w width] [-h height] [-b] [--stats]
+ *                             [file ...]
+ *
+ *               The work is a pipeline of four threads: the reader
+ *               cuts the input into blocks of whole lines, the parser
+ *               turns blocks into batches of points, the reducer
+ *               appends batches to the series and keeps a decimated
+ *               copy of it, and the renderer draws. Stages hand fixed
+ *               sets of buffers back and forth through bounded
+ *               channels, so a slow stage holds up the ones before it
+ *               instead of letting memory grow. On a terminal the
+ *               reducer offers a frame at a fixed rate while input is
+ *               still arriving; the last frame is always drawn from
+ *               every point.
+ *
+ *               Named regular files are mapped instead of read, and
+ *               cut into segments of whole lines that the parser
+ *               splits across threads of its own.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "asciip_canvas.h"
+#include "asciip_channel.h"
+#include "asciip_decimate.h"
+#include "asciip_parse.h"
+#include "asciip_series.h"
+#include "asciip_stats.h"
+#include "asciip_term.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+#define ASCIIP_MAIN_WIDTH  72
+#define ASCIIP_MAIN_HEIGHT 20
+
+/* Frames per second offered while input arrives on a terminal */
+#define ASCIIP_MAIN_FPS 20
+
+/* Buffers of each kind in flight between stages */
+#define ASCIIP_MAIN_BLOCKS  4
+#define ASCIIP_MAIN_BATCHES 4
+#define ASCIIP_MAIN_FRAMES  2
+
+/* Decimation buckets per grid column. The decimated range is at most
+ * three times the data range, so every column keeps two buckets */
+#define ASCIIP_MAIN_BUCKETS_PER_COLUMN 6
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _asciip_main_options_t
+{
+   size_t   width;     /* Columns of the plot */
+   size_t   height;    /* Rows of the plot */
+   uint8_t  braille;   /* Non-zero to draw in braille dots */
+   uint8_t  stats;     /* Non-zero to report throughput on stderr */
+   char   **files;     /* Files to read, stdin when there are none */
+   int      count;     /* Number of files */
+
+} Asciip_Main_Options;
+
+
+typedef struct _asciip_main_block_t
+{
+   char       *storage;   /* ASCIIP_PARSE_BUFFER bytes read into */
+   const char *text;      /* Whole lines, in storage or a mapped file */
+   size_t      length;    /* Bytes of whole lines held */
+
+} Asciip_Main_Block;
+
+
+typedef struct _asciip_main_batch_t
+{
+   Asciip_Series *series;   /* Points of one block */
+
+} Asciip_Main_Batch;
+
+
+typedef struct _asciip_main_map_t
+{
+   void   *text;     /* Mapped file, NULL for none */
+   size_t  length;   /* Bytes mapped */
+
+} Asciip_Main_Map;
+
+
+typedef struct _asciip_main_frame_t
+{
+   Asciip_Series *series;   /* Decimated points to draw */
+   Asciip_Bounds  bounds;   /* Bounds of every point so far */
+   uint8_t        final;    /* Set on the last frame, drawn from every point */
+
+} Asciip_Main_Frame;
+
+
+typedef struct _asciip_main_pipeline_t
+{
+   const Asciip_Main_Options *options;         /* Command line */
+   uint32_t                   fps;             /* Frames offered per second, 0 for none */
+   Asciip_Channel            *blocks;          /* Empty blocks, to the reader */
+   Asciip_Channel            *texts;           /* Filled blocks, to the parser */
+   Asciip_Channel            *batches;         /* Empty batches, to the parser */
+   Asciip_Channel            *points;          /* Filled batches, to the reducer */
+   Asciip_Channel            *frames;          /* Spare frames, to the reducer */
+   Asciip_Channel            *ready;           /* Filled frames, to the renderer */
+   Asciip_Series             *series;          /* Every point, the reducer's until the last frame */
+   Asciip_Parse_Stats         read_stats;      /* Bytes and dropped lines, reader owned */
+   Asciip_Parse_Stats         parse_stats;     /* Lines and points, parser owned */
+   int8_t                     read_status;     /* -1 if the reader failed */
+   int8_t                     parse_status;    /* -1 if the parser failed */
+   int8_t                     reduce_status;   /* -1 if the reducer failed */
+   double                     start;           /* Time the pipeline started */
+   double                     parsed;          /* Time the parser finished */
+   double                     first;           /* Time of the first frame, 0 for none */
+   Asciip_Main_Block          block[ASCIIP_MAIN_BLOCKS];   /* Blocks in flight */
+   Asciip_Main_Batch         *batch;                       /* ASCIIP_MAIN_BATCHES batches in flight */
+   Asciip_Main_Frame          frame[ASCIIP_MAIN_FRAMES];   /* Frames in flight */
+   Asciip_Main_Map           *map;                         /* Mapping per file, until the end */
+
+} Asciip_Main_Pipeline;
+
+/************************************************************************
+ * Constant Definitions
+ ************************************************************************/
+static const char asciip_main_usage[] =
+   "usage: asciip [-w width] [-h height] [-b] [--stats] [file ...]\n"
+   "  Plots x/y pairs separated by blanks or a comma, one per line.\n"
+   "  Lines without two finite numbers are skipped.\n"
+   "  -w width   columns of the plot\n"
+   "  -h height  rows of the plot\n"
+   "  -b         draw with braille dots\n"
+   "  --stats    report parsing throughput on stderr\n";
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/************************************************************************
+ * Name        : asciip_main_now
+ *
+ * Description : Gets a monotonic time in seconds.
+ ************************************************************************/
+static double asciip_main_now(void)
+{
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+/************************************************************************
+ * Name        : asciip_main_size
+ *
+ * Description : Parses a plot dimension, 0 if it is not one.
+ ************************************************************************/
+static size_t asciip_main_size(const char *text)
+{
+   char *stop;
+   unsigned long value = (text == NULL) ? 0 : strtoul(text, &stop, 10);
 
+   return ((value == 0) || (value > 65535) || (*stop != '\0')) ? 0 : (size_t)value;
+}
+
+/************************************************************************
+ * Name        : asciip_main_options
+ *
+ * Description : Parses the command line. Returns -1 on a bad option.
+ ************************************************************************/
+static int8_t asciip_main_options(int                  argc,
+                                  char               **argv,
+                                  Asciip_Main_Options *options)
+{
+   int arg;
+
+   options->width = ASCIIP_MAIN_WIDTH;
+   options->height = ASCIIP_MAIN_HEIGHT;
+   options->braille = 0;
+   options->stats = 0;
+
+   for (arg = 1; (arg < argc) && (argv[arg][0] == '-') && (argv[arg][1] != '\0'); arg++)
+   {
+      if (strcmp(argv[arg], "--") == 0)
+      {
+         arg++;
+         break;
+      }
+      else if (strcmp(argv[arg], "--stats") == 0)
+      {
+         options->stats = 1;
+      }
+      else if (strcmp(argv[arg], "-b") == 0)
+      {
+         options->braille = 1;
+      }
+      else if ((strcmp(argv[arg], "-w") == 0) && ((options->width = asciip_main_size(argv[arg + 1])) != 0))
+      {
+         arg++;
+      }
+      else if ((strcmp(argv[arg], "-h") == 0) && ((options->height = asciip_main_size(argv[arg + 1])) != 0))
+      {
+         arg++;
+      }
+      else
+      {
+         return -1;
+      }
+   }
+
+   options->files = argv + arg;
+   options->count = argc - arg;
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_main_abort
+ *
+ * Description : Closes every channel so that each stage stops at its
+ *               next push or pop.
+ ************************************************************************/
+static void asciip_main_abort(Asciip_Main_Pipeline *pipeline)
+{
+   asciip_channel_close(pipeline->blocks);
+   asciip_channel_close(pipeline->texts);
+   asciip_channel_close(pipeline->batches);
+   asciip_channel_close(pipeline->points);
+   asciip_channel_close(pipeline->frames);
+   asciip_channel_close(pipeline->ready);
+}
+
+/************************************************************************
+ * Name        : asciip_main_read_fd
+ *
+ * Description : Reads one input, handing on blocks of whole lines as
+ *               soon as they arrive. The partial last line of a block
+ *               moves to the start of the next. Returns -1 if the
+ *               input could not be read or the pipeline stopped.
+ ************************************************************************/
+static int8_t asciip_main_read_fd(Asciip_Main_Pipeline  *pipeline,
+                                  int                    fd,
+                                  const char            *name,
+                                  Asciip_Main_Block    **current)
+{
+   Asciip_Main_Block *block = *current;
+   Asciip_Main_Block *next;
+   size_t end;
+   size_t cut;
+   ssize_t got;
+   uint8_t overlong = 0;
+
+   while (1)
+   {
+      if ((got = read(fd, block->storage + block->length, ASCIIP_PARSE_BUFFER - block->length)) < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+
+         fprintf(stderr, "asciip: %s: %s\n", name, strerror(errno));
+         return -1;
+      }
+
+      if (got == 0)
+      {
+         break;
+      }
+      pipeline->read_stats.bytes += (uint64_t)got;
+      end = block->length;
+      block->length += (size_t)got;
+
+      /* Drop the rest of a line too long for a block */
+      if (overlong)
+      {
+         for (cut = end; (cut < block->length) && (block->storage[cut] != '\n'); cut++);
+         if (cut == block->length)
+         {
+            block->length = 0;
+            continue;
+         }
+
+         memmove(block->storage, block->storage + cut + 1, block->length - cut - 1);
+         block->length -= cut + 1;
+         overlong = 0;
+         end = 0;
+      }
+
+      /* A carried partial line holds no newline, so only the new
+       * bytes can hold the last one */
+      for (cut = block->length; (cut > end) && (block->storage[cut - 1] != '\n'); cut--);
+      if (cut == end)
+      {
+         if (block->length == ASCIIP_PARSE_BUFFER)
+         {
+            pipeline->read_stats.lines++;
+            pipeline->read_stats.skipped++;
+            block->length = 0;
+            overlong = 1;
+         }
+         continue;
+      }
+
+      if ((next = asciip_channel_pop(pipeline->blocks)) == NULL)
+      {
+         return -1;
+      }
+      next->length = block->length - cut;
+      memcpy(next->storage, block->storage + cut, next->length);
+      block->length = cut;
+      block->text = block->storage;
 
-int main()
+      if (asciip_channel_push(pipeline->texts, block) != 0)
+      {
+         return -1;
+      }
+      block = next;
+      *current = block;
+   }
+
+   /* An unterminated last line ends with its input */
+   if (block->length > 0)
+   {
+      if ((next = asciip_channel_pop(pipeline->blocks)) == NULL)
+      {
+         return -1;
+      }
+      next->length = 0;
+      block->text = block->storage;
+
+      if (asciip_channel_push(pipeline->texts, block) != 0)
+      {
+         return -1;
+      }
+      *current = next;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_main_read_map
+ *
+ * Description : Maps one input and hands it on in segments of whole
+ *               lines, sized to keep every parsing thread busy. The
+ *               mapping lasts until the pipeline is torn down. Returns
+ *               1 if the input cannot be mapped, such as a pipe, and
+ *               -1 if the pipeline stopped.
+ ************************************************************************/
+static int8_t asciip_main_read_map(Asciip_Main_Pipeline  *pipeline,
+                                   int                    fd,
+                                   Asciip_Main_Map       *map,
+                                   Asciip_Main_Block    **current)
 {
+   Asciip_Main_Block *block = *current;
+   Asciip_Main_Block *next;
+   struct stat info;
+   const char *text;
+   const char *line;
+   size_t segment = asciip_parse_threads(SIZE_MAX) * (size_t)ASCIIP_PARSE_SEGMENT;
+   size_t offset;
+   size_t cut;
+
+   if ((fstat(fd, &info) != 0) || !S_ISREG(info.st_mode) || (info.st_size == 0) ||
+       ((uint64_t)info.st_size > SIZE_MAX) ||
+       ((map->text = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED))
+   {
+      map->text = NULL;
+      return 1;
+   }
+
+   map->length = (size_t)info.st_size;
+   text = (const char *)map->text;
+   madvise(map->text, map->length, MADV_SEQUENTIAL);
+   pipeline->read_stats.bytes += map->length;
+
+   for (offset = 0; offset < map->length; offset = cut)
+   {
+      cut = (map->length - offset > segment) ? offset + segment : map->length;
+      if (cut < map->length)
+      {
+         line = memchr(text + cut - 1, '\n', map->length - cut + 1);
+         cut = (line == NULL) ? map->length : (size_t)(line - text) + 1;
+      }
+
+      if ((next = asciip_channel_pop(pipeline->blocks)) == NULL)
+      {
+         return -1;
+      }
+      next->length = 0;
+      block->text = text + offset;
+      block->length = cut - offset;
+
+      if (asciip_channel_push(pipeline->texts, block) != 0)
+      {
+         return -1;
+      }
+      block = next;
+      *current = block;
+   }
+
    return 0;
 }
+
+/************************************************************************
+ * Name        : asciip_main_reader
+ *
+ * Description : Reader stage, reads every input in order.
+ ************************************************************************/
+static void *asciip_main_reader(void *arg)
+{
+   Asciip_Main_Pipeline *pipeline = (Asciip_Main_Pipeline *)arg;
+   const Asciip_Main_Options *options = pipeline->options;
+   Asciip_Main_Block *block;
+   const char *name;
+   int8_t status = 0;
+   int ind;
+   int fd;
+
+   if ((block = asciip_channel_pop(pipeline->blocks)) != NULL)
+   {
+      block->length = 0;
+      for (ind = 0; (ind < ((options->count == 0) ? 1 : options->count)) && (status == 0); ind++)
+      {
+         name = (options->count == 0) ? "-" : options->files[ind];
+         if (strcmp(name, "-") == 0)
+         {
+            fd = STDIN_FILENO;
+            name = "stdin";
+         }
+         else if ((fd = open(name, O_RDONLY)) < 0)
+         {
+            fprintf(stderr, "asciip: %s: %s\n", name, strerror(errno));
+            status = -1;
+            break;
+         }
+
+         /* stdin is always read, it may not start at the beginning */
+         status = (fd == STDIN_FILENO) ? 1 : asciip_main_read_map(pipeline, fd, &pipeline->map[ind], &block);
+         if (status > 0)
+         {
+            status = asciip_main_read_fd(pipeline, fd, name, &block);
+         }
+         if (fd != STDIN_FILENO)
+         {
+            close(fd);
+         }
+      }
+   }
+
+   pipeline->read_status = status;
+   if (status != 0)
+   {
+      asciip_main_abort(pipeline);
+   }
+   asciip_channel_close(pipeline->texts);
+
+   return NULL;
+}
+
+/************************************************************************
+ * Name        : asciip_main_finite
+ *
+ * Description : Drops the points of a batch with an x or y that is not
+ *               finite, keeping the others in order, and counts them as
+ *               skipped lines. The parser accepts inf and nan, which
+ *               can not be placed on the plot.
+ ************************************************************************/
+static void asciip_main_finite(Asciip_Series      *series,
+                               Asciip_Parse_Stats *stats)
+{
+   size_t kept = 0;
+   size_t ind;
+
+   for (ind = 0; ind < series->size; ind++)
+   {
+      if (isfinite(series->x[ind]) && isfinite(series->y[ind]))
+      {
+         series->x[kept] = series->x[ind];
+         series->y[kept] = series->y[ind];
+         kept++;
+      }
+   }
+
+   stats->points -= series->size - kept;
+   stats->skipped += series->size - kept;
+   series->size = kept;
+}
+
+/************************************************************************
+ * Name        : asciip_main_parser
+ *
+ * Description : Parser stage, turns each block into a batch of points,
+ *               splitting large blocks across threads.
+ ************************************************************************/
+static void *asciip_main_parser(void *arg)
+{
+   Asciip_Main_Pipeline *pipeline = (Asciip_Main_Pipeline *)arg;
+   Asciip_Main_Block *block;
+   Asciip_Main_Batch *batch;
+   Asciip_Error error;
+   int8_t status = 0;
+
+   while ((status == 0) && ((block = asciip_channel_pop(pipeline->texts)) != NULL))
+   {
+      if ((batch = asciip_channel_pop(pipeline->batches)) == NULL)
+      {
+         status = -1;
+         break;
+      }
+
+      if (asciip_parse_text(block->text, block->length, 0, batch->series, &pipeline->parse_stats, &error) != 0)
+      {
+         fprintf(stderr, "asciip: %s\n", error.message);
+         status = -1;
+      }
+      else
+      {
+         asciip_main_finite(batch->series, &pipeline->parse_stats);
+         status = asciip_channel_push(pipeline->points, batch);
+      }
+
+      block->length = 0;
+      asciip_channel_push(pipeline->blocks, block);
+   }
+
+   pipeline->parsed = asciip_main_now();
+   pipeline->parse_status = status;
+   if (status != 0)
+   {
+      asciip_main_abort(pipeline);
+   }
+   asciip_channel_close(pipeline->points);
+
+   return NULL;
+}
+
+/************************************************************************
+ * Name        : asciip_main_merge
+ *
+ * Description : Widens running axis statistics by those of a batch.
+ ************************************************************************/
+static void asciip_main_merge(Asciip_Axis_Stats       *total,
+                              const Asciip_Axis_Stats *batch)
+{
+   if (batch->count > 0)
+   {
+      total->min = ((total->count == 0) || (batch->min < total->min)) ? batch->min : total->min;
+      total->max = ((total->count == 0) || (batch->max > total->max)) ? batch->max : total->max;
+   }
+   total->sum += batch->sum;
+   total->count += batch->count;
+   total->nans += batch->nans;
+}
+
+/************************************************************************
+ * Name        : asciip_main_decimate
+ *
+ * Description : Brings the decimator up to date with the whole series.
+ *               A new range grows by the data span on the side that
+ *               outgrew it, so a series growing in x is only added in
+ *               full a logarithmic number of times.
+ ************************************************************************/
+static int8_t asciip_main_decimate(Asciip_Decimate     *decimate,
+                                   const Asciip_Series *series,
+                                   const Asciip_Bounds *bounds,
+                                   uint8_t              ranged)
+{
+   double span = bounds->x.max - bounds->x.min;
+   double x_min = decimate->x_min;
+   double x_max = decimate->x_max;
+
+   span = (span > 0.0) ? span : 1.0;
+   if (!ranged)
+   {
+      x_min = bounds->x.min;
+      x_max = bounds->x.max + span;
+   }
+   else
+   {
+      x_min = (bounds->x.min < x_min) ? bounds->x.min - span : x_min;
+      x_max = (bounds->x.max > x_max) ? bounds->x.max + span : x_max;
+   }
+
+   /* Near the largest doubles there is no room to grow */
+   if (!isfinite(x_max - x_min))
+   {
+      x_min = bounds->x.min;
+      x_max = bounds->x.max;
+   }
+
+   if ((asciip_decimate_set_range(decimate, x_min, x_max, NULL) != 0) ||
+       (asciip_decimate_add_series(decimate, series, NULL) != 0))
+   {
+      return -1;
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_main_reducer
+ *
+ * Description : Reducer stage, appends batches to the series and keeps
+ *               a decimated copy for the frames offered on the way.
+ *               Frames are only offered when the renderer has a spare
+ *               one, so drawing never holds up the input.
+ ************************************************************************/
+static void *asciip_main_reducer(void *arg)
+{
+   Asciip_Main_Pipeline *pipeline = (Asciip_Main_Pipeline *)arg;
+   const Asciip_Main_Options *options = pipeline->options;
+   Asciip_Main_Batch *batch;
+   Asciip_Main_Frame *frame;
+   Asciip_Decimate *decimate = NULL;
+   Asciip_Bounds bounds;
+   Asciip_Bounds added;
+   Asciip_Error error;
+   double last = pipeline->start;
+   double now;
+   uint8_t ranged = 0;
+   uint8_t stale = 1;
+   int8_t status = 0;
+
+   memset(&bounds, 0, sizeof(bounds));
+   bounds.x.min = bounds.x.max = bounds.y.min = bounds.y.max = NAN;
+
+   if ((pipeline->fps > 0) &&
+       (asciip_decimate_init(ASCIIP_MAIN_BUCKETS_PER_COLUMN * options->width * (options->braille ? 2 : 1),
+                             ASCIIP_DECIMATE_MINMAX, &decimate, &error) == NULL))
+   {
+      fprintf(stderr, "asciip: %s\n", error.message);
+      status = -1;
+   }
+
+   while ((status == 0) && ((batch = asciip_channel_pop(pipeline->points)) != NULL))
+   {
+      if (asciip_series_add_many(pipeline->series, batch->series->x, batch->series->y, batch->series->size, &error) != 0)
+      {
+         fprintf(stderr, "asciip: %s\n", error.message);
+         status = -1;
+         break;
+      }
+
+      asciip_stats_series(batch->series, &added, NULL);
+      asciip_main_merge(&bounds.x, &added.x);
+      asciip_main_merge(&bounds.y, &added.y);
+
+      if ((decimate != NULL) && !stale)
+      {
+         if ((added.x.count > 0) && ((added.x.min < decimate->x_min) || (added.x.max > decimate->x_max)))
+         {
+            stale = 1;
+         }
+         else
+         {
+            asciip_decimate_add(decimate, batch->series->x, batch->series->y, batch->series->size);
+         }
+      }
+
+      batch->series->size = 0;
+      asciip_channel_push(pipeline->batches, batch);
+
+      now = asciip_main_now();
+      if ((decimate == NULL) || (bounds.x.count == 0) || (now - last < 1.0 / pipeline->fps) ||
+          ((frame = asciip_channel_try_pop(pipeline->frames)) == NULL))
+      {
+         continue;
+      }
+
+      if (stale && (asciip_main_decimate(decimate, pipeline->series, &bounds, ranged) == 0))
+      {
+         ranged = 1;
+         stale = 0;
+      }
+
+      frame->series->size = 0;
+      if (!stale && (asciip_decimate_output(decimate, frame->series, NULL) != 0))
+      {
+         frame->series->size = 0;
+      }
+      frame->bounds = bounds;
+      frame->final = 0;
+      asciip_channel_push(pipeline->ready, frame);
+      last = now;
+   }
+
+   /* The series is handed over with the last frame */
+   if ((status == 0) && (pipeline->parse_status == 0) && ((frame = asciip_channel_pop(pipeline->frames)) != NULL))
+   {
+      frame->bounds = bounds;
+      frame->final = 1;
+      asciip_channel_push(pipeline->ready, frame);
+   }
+
+   asciip_decimate_destroy(decimate);
+   pipeline->reduce_status = status;
+   if (status != 0)
+   {
+      asciip_main_abort(pipeline);
+   }
+   asciip_channel_close(pipeline->ready);
+
+   return NULL;
+}
+
+/************************************************************************
+ * Name        : asciip_main_render
+ *
+ * Description : Renderer stage, run on the calling thread. Frames on
+ *               the way go to the terminal by changed cells; the last
+ *               frame goes to the terminal or is printed whole.
+ ************************************************************************/
+static int8_t asciip_main_render(Asciip_Main_Pipeline *pipeline)
+{
+   const Asciip_Main_Options *options = pipeline->options;
+   static const char clear[] = "\033[H\033[2J";
+   Asciip_Main_Frame *frame;
+   Asciip_Canvas *canvas;
+   Asciip_Term *term = NULL;
+   Asciip_Error error;
+   char below[32];
+   int8_t status = -1;
+   int length;
+
+   if ((asciip_canvas_init(options->width, options->height, &canvas, &error) == NULL) ||
+       (asciip_canvas_set_mode(canvas, options->braille ? ASCIIP_CANVAS_BRAILLE : ASCIIP_CANVAS_TEXT, &error) != 0) ||
+       ((pipeline->fps > 0) && (asciip_term_init(STDOUT_FILENO, options->width, options->height, &term, &error) == NULL)))
+   {
+      fprintf(stderr, "asciip: %s\n", error.message);
+      asciip_canvas_destroy(canvas);
+      return -1;
+   }
+
+   if ((term != NULL) && (write(STDOUT_FILENO, clear, sizeof(clear) - 1) < 0))
+   {
+      asciip_term_invalidate(term);
+   }
+
+   while ((frame = asciip_channel_pop(pipeline->ready)) != NULL)
+   {
+      asciip_canvas_clear(canvas);
+      if ((asciip_canvas_fit(canvas, &frame->bounds, &error) != 0) ||
+          (asciip_canvas_draw_series(canvas, frame->final ? pipeline->series : frame->series,
+                                     ASCIIP_CANVAS_POINTS, '*', &error) != 0))
+      {
+         fprintf(stderr, "asciip: %s\n", error.message);
+         asciip_channel_push(pipeline->frames, frame);
+         break;
+      }
+
+      if (frame->final)
+      {
+         status = (term != NULL) ? asciip_term_draw(term, canvas, &error) : asciip_canvas_print(canvas, stdout, &error);
+         if (status != 0)
+         {
+            fprintf(stderr, "asciip: %s\n", error.message);
+         }
+      }
+      else if (asciip_term_draw(term, canvas, NULL) == 0)
+      {
+         pipeline->first = (pipeline->first > 0.0) ? pipeline->first : asciip_main_now();
+      }
+
+      asciip_channel_push(pipeline->frames, frame);
+   }
+
+   /* Leave the cursor under the plot */
+   if (term != NULL)
+   {
+      length = snprintf(below, sizeof(below), "\033[%zu;1H", options->height + 1);
+      if (write(STDOUT_FILENO, below, (size_t)length) < 0)
+      {
+         status = -1;
+      }
+   }
+
+   asciip_term_destroy(term);
+   asciip_canvas_destroy(canvas);
+   return status;
+}
+
+/************************************************************************
+ * Name        : asciip_main_setup
+ *
+ * Description : Allocates the channels and the buffers in flight, and
+ *               fills the channels of empty buffers.
+ ************************************************************************/
+static int8_t asciip_main_setup(Asciip_Main_Pipeline *pipeline)
+{
+   uint8_t ind;
+
+   if (((pipeline->batch = calloc(ASCIIP_MAIN_BATCHES, sizeof(Asciip_Main_Batch))) == NULL) ||
+       ((pipeline->map = calloc((size_t)pipeline->options->count + 1, sizeof(Asciip_Main_Map))) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_BLOCKS, &pipeline->blocks, NULL) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_BLOCKS, &pipeline->texts, NULL) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_BATCHES, &pipeline->batches, NULL) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_BATCHES, &pipeline->points, NULL) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_FRAMES, &pipeline->frames, NULL) == NULL) ||
+       (asciip_channel_init(ASCIIP_MAIN_FRAMES, &pipeline->ready, NULL) == NULL) ||
+       (asciip_series_init(0, &pipeline->series, NULL) == NULL))
+   {
+      return -1;
+   }
+
+   for (ind = 0; ind < ASCIIP_MAIN_BLOCKS; ind++)
+   {
+      if ((pipeline->block[ind].storage = malloc(ASCIIP_PARSE_BUFFER)) == NULL)
+      {
+         return -1;
+      }
+      asciip_channel_push(pipeline->blocks, &pipeline->block[ind]);
+   }
+
+   for (ind = 0; ind < ASCIIP_MAIN_BATCHES; ind++)
+   {
+      if (asciip_series_init(0, &pipeline->batch[ind].series, NULL) == NULL)
+      {
+         return -1;
+      }
+      asciip_channel_push(pipeline->batches, &pipeline->batch[ind]);
+   }
+
+   for (ind = 0; ind < ASCIIP_MAIN_FRAMES; ind++)
+   {
+      if (asciip_series_init(0, &pipeline->frame[ind].series, NULL) == NULL)
+      {
+         return -1;
+      }
+      asciip_channel_push(pipeline->frames, &pipeline->frame[ind]);
+   }
+
+   return 0;
+}
+
+/************************************************************************
+ * Name        : asciip_main_teardown
+ *
+ * Description : Releases whatever asciip_main_setup allocated.
+ ************************************************************************/
+static void asciip_main_teardown(Asciip_Main_Pipeline *pipeline)
+{
+   int ind;
+
+   for (ind = 0; ind < ASCIIP_MAIN_FRAMES; ind++)
+   {
+      asciip_series_destroy(pipeline->frame[ind].series);
+   }
+   for (ind = 0; ind < ASCIIP_MAIN_BATCHES; ind++)
+   {
+      asciip_series_destroy((pipeline->batch == NULL) ? NULL : pipeline->batch[ind].series);
+   }
+   for (ind = 0; ind < ASCIIP_MAIN_BLOCKS; ind++)
+   {
+      free(pipeline->block[ind].storage);
+   }
+   for (ind = 0; (pipeline->map != NULL) && (ind < pipeline->options->count); ind++)
+   {
+      if (pipeline->map[ind].text != NULL)
+      {
+         munmap(pipeline->map[ind].text, pipeline->map[ind].length);
+      }
+   }
+   free(pipeline->map);
+   asciip_series_destroy(pipeline->series);
+   asciip_channel_destroy(pipeline->blocks);
+   asciip_channel_destroy(pipeline->texts);
+   asciip_channel_destroy(pipeline->batches);
+   asciip_channel_destroy(pipeline->points);
+   asciip_channel_destroy(pipeline->frames);
+   asciip_channel_destroy(pipeline->ready);
+   free(pipeline->batch);
+}
+
+/************************************************************************
+ * Name        : asciip_main_report
+ *
+ * Description : Prints the throughput of a finished pipeline.
+ ************************************************************************/
+static void asciip_main_report(const Asciip_Main_Pipeline *pipeline)
+{
+   double elapsed = pipeline->parsed - pipeline->start;
+
+   fprintf(stderr, "asciip: %llu points from %.1f MB in %.3f s, %.1f MB/s, %llu lines skipped\n",
+           (unsigned long long)pipeline->parse_stats.points, (double)pipeline->read_stats.bytes / 1e6, elapsed,
+           (elapsed > 0.0) ? (double)pipeline->read_stats.bytes / 1e6 / elapsed : 0.0,
+           (unsigned long long)(pipeline->parse_stats.skipped + pipeline->read_stats.skipped));
+
+   if (pipeline->first > 0.0)
+   {
+      fprintf(stderr, "asciip: first frame after %.3f s\n", pipeline->first - pipeline->start);
+   }
+}
+
+/************************************************************************
+ * Name        : asciip_main_run
+ *
+ * Description : Runs the reader, parser and reducer on threads of their
+ *               own and renders on the calling thread.
+ ************************************************************************/
+static int8_t asciip_main_run(const Asciip_Main_Options *options)
+{
+   void *(*stages[3])(void *) = { asciip_main_reader, asciip_main_parser, asciip_main_reducer };
+   Asciip_Main_Pipeline *pipeline;
+   pthread_t threads[3];
+   uint8_t started;
+   uint8_t ind;
+   int8_t status = -1;
+
+   if ((pipeline = calloc(1, sizeof(Asciip_Main_Pipeline))) == NULL)
+   {
+      fputs("asciip: Could not malloc pipeline.\n", stderr);
+      return -1;
+   }
+
+   pipeline->options = options;
+   pipeline->fps = isatty(STDOUT_FILENO) ? ASCIIP_MAIN_FPS : 0;
+   if (asciip_main_setup(pipeline) != 0)
+   {
+      fputs("asciip: Could not malloc pipeline.\n", stderr);
+      asciip_main_teardown(pipeline);
+      free(pipeline);
+      return -1;
+   }
+
+   pipeline->start = asciip_main_now();
+   for (started = 0; started < 3; started++)
+   {
+      if (pthread_create(&threads[started], NULL, stages[started], pipeline) != 0)
+      {
+         fputs("asciip: Could not start pipeline.\n", stderr);
+         asciip_main_abort(pipeline);
+         break;
+      }
+   }
+
+   if (started == 3)
+   {
+      status = asciip_main_render(pipeline);
+   }
+
+   /* Stops the stages early if rendering failed */
+   asciip_main_abort(pipeline);
+   for (ind = 0; ind < started; ind++)
+   {
+      pthread_join(threads[ind], NULL);
+   }
+
+   if ((pipeline->read_status != 0) || (pipeline->parse_status != 0) || (pipeline->reduce_status != 0))
+   {
+      status = -1;
+   }
+   else if (options->stats)
+   {
+      asciip_main_report(pipeline);
+   }
+
+   asciip_main_teardown(pipeline);
+   free(pipeline);
+   return status;
+}
+
+int main(int    argc,
+         char **argv)
+{
+   Asciip_Main_Options options;
+
+   /* Errors are printed once, on stderr, with the tool's prefix */
+   report_error_echo(0);
+
+   if (asciip_main_options(argc, argv, &options) != 0)
+   {
+      fputs(asciip_main_usage, stderr);
+      return 2;
+   }
+
+   return (asciip_main_run(&options) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,319 @@
+/************************************************************************
+ *
+ * File        : test_asciip_canvas.cpp
+ *
+ * Description : Test cases for the character canvas rasterizer.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_canvas.h"
+#include "asciip_sched.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(CanvasTestGroup)
+{
+   Asciip_Canvas *canvas;
+
+   void setup()
+   {
+      canvas = asciip_canvas_init(4, 3, &canvas, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_canvas_destroy(canvas);
+   }
+};
+
+TEST(CanvasTestGroup, TestCanvasInit)
+{
+   Asciip_Canvas *other;
+
+   CHECK_TEXT((!asciip_canvas_init(4, 3, NULL, NULL)), "Canvas was initialized with NULL result");
+   CHECK_TEXT((!asciip_canvas_init(0, 3, &other, NULL)), "Canvas was initialized without columns");
+
+   /* Sizes whose cell count overflows are refused, not wrapped */
+   CHECK_TEXT((!asciip_canvas_init(4, SIZE_MAX / 4 + 1, &other, NULL)), "Canvas was initialized with 2^62 rows");
+   CHECK_TEXT((!asciip_canvas_init(4, SIZE_MAX, &other, NULL)), "Canvas was initialized with SIZE_MAX rows");
+   CHECK_TEXT((!asciip_canvas_init(SIZE_MAX / 8, 2, &other, NULL)), "Canvas was initialized past the cell limit");
+   CHECK_TEXT((!asciip_canvas_init(1, SIZE_MAX / 4, &other, NULL)), "Canvas was initialized past the row limit");
+
+   UNSIGNED_LONGS_EQUAL(5, canvas->stride);
+   MEMCMP_EQUAL("    \n    \n    \n", canvas->cells, 15);
+
+   LONGS_EQUAL(-1, asciip_canvas_set_range(canvas, 1.0, 1.0, 0.0, 1.0, NULL));
+   LONGS_EQUAL(-1, asciip_canvas_set_range(canvas, 0.0, INFINITY, 0.0, 1.0, NULL));
+   LONGS_EQUAL(0, asciip_canvas_set_range(canvas, 0.0, 4.0, 0.0, 3.0, NULL));
+   DOUBLES_EQUAL(1.0, canvas->x_scale, 0.0);
+}
+
+TEST(CanvasTestGroup, TestCanvasPoints)
+{
+   const double xs[] = { 0.0, 4.0, 2.5, 5.0, NAN, 1.0 };
+   const double ys[] = { 0.0, 3.0, 1.5, 1.0, 1.0, -0.1 };
+
+   /* Edges are inside, the top right corner is the last cell */
+   LONGS_EQUAL(0, asciip_canvas_set_range(canvas, 0.0, 4.0, 0.0, 3.0, NULL));
+   asciip_canvas_plot(canvas, xs, ys, 6, ASCIIP_CANVAS_POINTS, '*');
+   MEMCMP_EQUAL("   *\n"
+                "  * \n"
+                "*   \n", canvas->cells, 15);
+
+   asciip_canvas_clear(canvas);
+   MEMCMP_EQUAL("    \n    \n    \n", canvas->cells, 15);
+}
+
+TEST(CanvasTestGroup, TestCanvasLines)
+{
+   Asciip_Canvas *wide;
+   const double xs[] = { 0.0, 7.9, 7.9, NAN, 0.0, -100.0 };
+   const double ys[] = { 0.0, 3.9, 0.0, 0.0, 3.9, 0.0 };
+   Asciip_List *list;
+   size_t ind;
+
+   wide = asciip_canvas_init(8, 4, &wide, NULL);
+   LONGS_EQUAL(0, asciip_canvas_set_range(wide, 0.0, 8.0, 0.0, 4.0, NULL));
+
+   /* Diagonal, vertical, a NaN break, then a segment clipped at the left edge */
+   asciip_canvas_plot(wide, xs, ys, 6, ASCIIP_CANVAS_LINES, '#');
+   MEMCMP_EQUAL("#     ##\n"
+                "    ## #\n"
+                "  ##   #\n"
+                "##     #\n", wide->cells, 36);
+
+   /* Lists drawn in batches join the batches up */
+   list = asciip_list_init(NULL, &list, NULL);
+   for (ind = 0; ind <= 2 * ASCIIP_CANVAS_LIST_BATCH; ind++)
+   {
+      asciip_list_add_xy(list, (double)ind / (2 * ASCIIP_CANVAS_LIST_BATCH), (ind == ASCIIP_CANVAS_LIST_BATCH) ? 1.0 : 0.0, NULL);
+   }
+   asciip_canvas_clear(canvas);
+   LONGS_EQUAL(0, asciip_canvas_set_range(canvas, 0.0, 1.0, 0.0, 1.0, NULL));
+   LONGS_EQUAL(0, asciip_canvas_draw_list(canvas, list, ASCIIP_CANVAS_LINES, '.', NULL));
+   MEMCMP_EQUAL("  . \n"
+                "  . \n"
+                "....\n", canvas->cells, 15);
+
+   LONGS_EQUAL(0, asciip_list_destroy(list, NULL));
+   asciip_canvas_destroy(wide);
+}
+
+TEST(CanvasTestGroup, TestCanvasBraille)
+{
+   const double xs[] = { 0.0, 4.0, 0.0, 4.0 };
+   const double ys[] = { 4.0, 0.0, 4.0, 4.0 };
+   const char *frame;
+   size_t length;
+
+   /* 4x3 cells of 2x4 dots make an 8x12 grid */
+   LONGS_EQUAL(0, asciip_canvas_set_range(canvas, 0.0, 4.0, 0.0, 4.0, NULL));
+   LONGS_EQUAL(0, asciip_canvas_set_mode(canvas, ASCIIP_CANVAS_BRAILLE, NULL));
+   UNSIGNED_LONGS_EQUAL(8, canvas->grid_width);
+   UNSIGNED_LONGS_EQUAL(12, canvas->grid_height);
+   DOUBLES_EQUAL(2.0, canvas->x_scale, 0.0);
+   DOUBLES_EQUAL(3.0, canvas->y_scale, 0.0);
+
+   /* Top left dot of the first cell, bottom right dot of the last */
+   asciip_canvas_plot(canvas, xs, ys, 2, ASCIIP_CANVAS_POINTS, '*');
+   UNSIGNED_LONGS_EQUAL(0x01, canvas->dots[0]);
+   UNSIGNED_LONGS_EQUAL(0x80, canvas->dots[11]);
+   frame = asciip_canvas_frame(canvas, &length);
+   UNSIGNED_LONGS_EQUAL(19, length);
+   MEMCMP_EQUAL("\xE2\xA0\x81   \n"
+                "    \n"
+                "   \xE2\xA2\x80\n", frame, 19);
+
+   /* A line along the top fills the top row of dots of every cell */
+   asciip_canvas_clear(canvas);
+   asciip_canvas_plot(canvas, xs + 2, ys + 2, 2, ASCIIP_CANVAS_LINES, '*');
+   frame = asciip_canvas_frame(canvas, &length);
+   UNSIGNED_LONGS_EQUAL(4 * 3 + 1 + 2 * 5, length);
+   MEMCMP_EQUAL("\xE2\xA0\x89\xE2\xA0\x89\xE2\xA0\x89\xE2\xA0\x89\n"
+                "    \n"
+                "    \n", frame, length);
+
+   /* Back to text keeps the range at cell resolution */
+   LONGS_EQUAL(0, asciip_canvas_set_mode(canvas, ASCIIP_CANVAS_TEXT, NULL));
+   DOUBLES_EQUAL(1.0, canvas->x_scale, 0.0);
+   asciip_canvas_plot(canvas, xs, ys, 2, ASCIIP_CANVAS_POINTS, '*');
+   frame = asciip_canvas_frame(canvas, &length);
+   MEMCMP_EQUAL("*   \n"
+                "    \n"
+                "   *\n", frame, 15);
+}
+
+TEST(CanvasTestGroup, TestCanvasFitPrint)
+{
+   Asciip_Series *series;
+   Asciip_Bounds bounds;
+   char printed[32];
+   FILE *stream;
+
+   series = asciip_series_init(0, &series, NULL);
+   asciip_series_add(series, 10.0, 5.0, NULL);
+   asciip_series_add(series, 30.0, 5.0, NULL);
+   asciip_stats_series(series, &bounds, NULL);
+
+   /* A flat series is centred vertically */
+   LONGS_EQUAL(0, asciip_canvas_fit(canvas, &bounds, NULL));
+   DOUBLES_EQUAL(10.0, canvas->x_min, 0.0);
+   DOUBLES_EQUAL(4.5, canvas->y_min, 0.0);
+   LONGS_EQUAL(0, asciip_canvas_draw_series(canvas, series, ASCIIP_CANVAS_POINTS, 'o', NULL));
+
+   stream = tmpfile();
+   LONGS_EQUAL(0, asciip_canvas_print(canvas, stream, NULL));
+   rewind(stream);
+   UNSIGNED_LONGS_EQUAL(15, fread(printed, 1, sizeof(printed), stream));
+   MEMCMP_EQUAL("    \n"
+                "o  o\n"
+                "    \n", printed, 15);
+   fclose(stream);
+
+   asciip_series_destroy(series);
+}
+
+TEST(CanvasTestGroup, TestCanvasFitNonFinite)
+{
+   Asciip_Series *series;
+   Asciip_Bounds bounds;
+   const char *frame;
+   size_t length;
+
+   /* An infinite x end is replaced by the finite one */
+   series = asciip_series_init(0, &series, NULL);
+   asciip_series_add(series, 1.0, 1.0, NULL);
+   asciip_series_add(series, INFINITY, 2.0, NULL);
+   asciip_series_add(series, 3.0, 3.0, NULL);
+   asciip_stats_series(series, &bounds, NULL);
+   LONGS_EQUAL(0, asciip_canvas_fit(canvas, &bounds, NULL));
+   DOUBLES_EQUAL(0.5, canvas->x_min, 0.0);
+   DOUBLES_EQUAL(1.5, canvas->x_max, 0.0);
+   DOUBLES_EQUAL(1.0, canvas->y_min, 0.0);
+   DOUBLES_EQUAL(3.0, canvas->y_max, 0.0);
+   LONGS_EQUAL(0, asciip_canvas_draw_series(canvas, series, ASCIIP_CANVAS_POINTS, 'o', NULL));
+   frame = asciip_canvas_frame(canvas, &length);
+   UNSIGNED_LONGS_EQUAL(15, length);
+   MEMCMP_EQUAL("    \n"
+                "    \n"
+                "  o \n", frame, 15);
+   asciip_series_destroy(series);
+
+   /* No finite end at all maps [0, 1] */
+   series = asciip_series_init(0, &series, NULL);
+   asciip_series_add(series, -INFINITY, 0.5, NULL);
+   asciip_series_add(series, INFINITY, 0.5, NULL);
+   asciip_stats_series(series, &bounds, NULL);
+   LONGS_EQUAL(0, asciip_canvas_fit(canvas, &bounds, NULL));
+   DOUBLES_EQUAL(0.0, canvas->x_min, 0.0);
+   DOUBLES_EQUAL(1.0, canvas->x_max, 0.0);
+   asciip_series_destroy(series);
+
+   /* A span that overflows is cut down, and points inside it draw */
+   series = asciip_series_init(0, &series, NULL);
+   asciip_series_add(series, -1e308, -1e308, NULL);
+   asciip_series_add(series, 0.0, 0.0, NULL);
+   asciip_series_add(series, 1e308, 1e308, NULL);
+   asciip_stats_series(series, &bounds, NULL);
+   LONGS_EQUAL(0, asciip_canvas_fit(canvas, &bounds, NULL));
+   CHECK(isfinite(canvas->x_max - canvas->x_min));
+   CHECK(isfinite(canvas->y_max - canvas->y_min));
+   CHECK(canvas->x_min < 0.0);
+   CHECK(canvas->x_max > 0.0);
+   asciip_canvas_clear(canvas);
+   LONGS_EQUAL(0, asciip_canvas_draw_series(canvas, series, ASCIIP_CANVAS_POINTS, 'o', NULL));
+   frame = asciip_canvas_frame(canvas, &length);
+   UNSIGNED_LONGS_EQUAL(15, length);
+   MEMCMP_EQUAL("    \n"
+                "  o \n"
+                "    \n", frame, 15);
+   asciip_series_destroy(series);
+
+   /* A single value near the largest double still gets a range */
+   series = asciip_series_init(0, &series, NULL);
+   asciip_series_add(series, 1e308, DBL_MAX, NULL);
+   asciip_stats_series(series, &bounds, NULL);
+   LONGS_EQUAL(0, asciip_canvas_fit(canvas, &bounds, NULL));
+   CHECK(canvas->x_max > canvas->x_min);
+   CHECK(canvas->y_max > canvas->y_min);
+   DOUBLES_EQUAL(DBL_MAX, canvas->y_max, 0.0);
+   asciip_series_destroy(series);
+}
+
+TEST(CanvasTestGroup, TestCanvasChunked)
+{
+   size_t count = 3 * ASCIIP_CANVAS_CHUNK + 17;
+   double *xs = (double *)malloc(count * sizeof(double));
+   double *ys = (double *)malloc(count * sizeof(double));
+   char *single;
+   const char *frame;
+   size_t length;
+   size_t ind;
+   uint8_t mode;
+
+   /* A wandering line that leaves the plot area and breaks on NaNs */
+   for (ind = 0; ind < count; ind++)
+   {
+      xs[ind] = sin((double)ind * 0.001) * 1.2;
+      ys[ind] = (ind % 5000 == 1) ? NAN : cos((double)ind * 0.0037) * 1.1;
+   }
+
+   asciip_canvas_destroy(canvas);
+   canvas = asciip_canvas_init(60, 20, &canvas, NULL);
+
+   /* Chunks joined across workers draw what chunks in order draw */
+   for (mode = ASCIIP_CANVAS_TEXT; mode <= ASCIIP_CANVAS_BRAILLE; mode++)
+   {
+      LONGS_EQUAL(0, asciip_canvas_set_mode(canvas, mode, NULL));
+      LONGS_EQUAL(0, asciip_canvas_set_range(canvas, -1.0, 1.0, -1.0, 1.0, NULL));
+
+      LONGS_EQUAL(0, asciip_sched_set_workers(1, NULL));
+      asciip_canvas_plot(canvas, xs, ys, count, ASCIIP_CANVAS_LINES, '*');
+      frame = asciip_canvas_frame(canvas, &length);
+      single = (char *)malloc(length);
+      memcpy(single, frame, length);
+
+      LONGS_EQUAL(0, asciip_sched_set_workers(4, NULL));
+      asciip_canvas_clear(canvas);
+      asciip_canvas_plot(canvas, xs, ys, count, ASCIIP_CANVAS_LINES, '*');
+      frame = asciip_canvas_frame(canvas, &ind);
+      UNSIGNED_LONGS_EQUAL(length, ind);
+      MEMCMP_EQUAL(single, frame, length);
+      free(single);
+   }
+
+   LONGS_EQUAL(0, asciip_sched_set_workers(0, NULL));
+   free(xs);
+   free(ys);
+}
@@ -0,0 +1,125 @@
+/************************************************************************
+ *
+ * File        : test_asciip_channel.cpp
+ *
+ * Description : Test cases for the bounded channel between threads.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_channel.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Items passed through the channel by the threaded test */
+#define CHANNEL_TEST_ITEMS 20000
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Pushes 1, 2, ... CHANNEL_TEST_ITEMS, then closes the channel */
+static void *channel_producer(void *arg)
+{
+   Asciip_Channel *channel = (Asciip_Channel *)arg;
+   uintptr_t item;
+
+   for (item = 1; item <= CHANNEL_TEST_ITEMS; item++)
+   {
+      if (asciip_channel_push(channel, (void *)item) != 0)
+      {
+         break;
+      }
+   }
+
+   asciip_channel_close(channel);
+   return NULL;
+}
+
+TEST_GROUP(ChannelTestGroup)
+{
+   Asciip_Channel *channel;
+
+   void setup()
+   {
+      channel = asciip_channel_init(3, &channel, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_channel_destroy(channel);
+   }
+};
+
+TEST(ChannelTestGroup, TestChannelInit)
+{
+   Asciip_Channel *other;
+
+   CHECK_TEXT((!asciip_channel_init(3, NULL, NULL)), "Channel was initialized with NULL result");
+   CHECK_TEXT((!asciip_channel_init(0, &other, NULL)), "Channel was initialized without capacity");
+   UNSIGNED_LONGS_EQUAL(3, channel->capacity);
+   UNSIGNED_LONGS_EQUAL(0, channel->size);
+}
+
+TEST(ChannelTestGroup, TestChannelOrder)
+{
+   int items[4];
+
+   /* Oldest first, across the wrap of the slots */
+   LONGS_EQUAL(0, asciip_channel_push(channel, &items[0]));
+   LONGS_EQUAL(0, asciip_channel_push(channel, &items[1]));
+   POINTERS_EQUAL(&items[0], asciip_channel_pop(channel));
+   LONGS_EQUAL(0, asciip_channel_push(channel, &items[2]));
+   LONGS_EQUAL(0, asciip_channel_push(channel, &items[3]));
+   UNSIGNED_LONGS_EQUAL(3, channel->size);
+   POINTERS_EQUAL(&items[1], asciip_channel_pop(channel));
+   POINTERS_EQUAL(&items[2], asciip_channel_try_pop(channel));
+
+   /* Closing keeps what is held but refuses more */
+   asciip_channel_close(channel);
+   LONGS_EQUAL(-1, asciip_channel_push(channel, &items[0]));
+   POINTERS_EQUAL(&items[3], asciip_channel_pop(channel));
+   POINTERS_EQUAL(NULL, asciip_channel_pop(channel));
+   POINTERS_EQUAL(NULL, asciip_channel_try_pop(channel));
+}
+
+TEST(ChannelTestGroup, TestChannelThreads)
+{
+   pthread_t thread;
+   uintptr_t expected = 1;
+   void *item;
+
+   /* The producer blocks on the full channel until the consumer keeps up */
+   LONGS_EQUAL(0, pthread_create(&thread, NULL, channel_producer, channel));
+   while ((item = asciip_channel_pop(channel)) != NULL)
+   {
+      UNSIGNED_LONGS_EQUAL(expected, (uintptr_t)item);
+      expected++;
+   }
+   pthread_join(thread, NULL);
+
+   UNSIGNED_LONGS_EQUAL(CHANNEL_TEST_ITEMS + 1, expected);
+}
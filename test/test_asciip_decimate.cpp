@@ -0,0 +1,169 @@
+/************************************************************************
+ *
+ * File        : test_asciip_decimate.cpp
+ *
+ * Description : Test cases for min/max and Largest-Triangle-Three-
+ *               Buckets decimation.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_decimate.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(DecimateTestGroup)
+{
+   Asciip_Decimate *decimate;
+   Asciip_Series *series;
+
+   void setup()
+   {
+      decimate = NULL;
+      series = asciip_series_init(0, &series, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_decimate_destroy(decimate);
+      asciip_series_destroy(series);
+   }
+
+   void check_points(const double *xs, const double *ys, size_t count)
+   {
+      size_t ind;
+
+      UNSIGNED_LONGS_EQUAL(count, series->size);
+      for (ind = 0; ind < count; ind++)
+      {
+         DOUBLES_EQUAL(xs[ind], series->x[ind], 0.0);
+         DOUBLES_EQUAL(ys[ind], series->y[ind], 0.0);
+      }
+   }
+};
+
+TEST(DecimateTestGroup, TestDecimateMinMax)
+{
+   Asciip_Decimate *other;
+   const double xs[] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, -1.0, -3.0, 9.0, NAN };
+   const double ys[] = { 0.0, 5.0, -2.0, 1.0, 3.0, 3.0, 7.0, -7.0, 2.0, 10.0, 20.0, 30.0, 0.0 };
+   const double expected_x[] = { -1.0, 0.0, 1.0, 2.0, 3.0, 4.0, 6.0, 7.0, 9.0 };
+   const double expected_y[] = { 10.0, 0.0, 5.0, -2.0, 1.0, 3.0, 7.0, -7.0, 30.0 };
+
+   CHECK_TEXT((!asciip_decimate_init(0, ASCIIP_DECIMATE_MINMAX, &other, NULL)), "Decimator was initialized without buckets");
+   decimate = asciip_decimate_init(4, ASCIIP_DECIMATE_MINMAX, &decimate, NULL);
+   LONGS_EQUAL(-1, asciip_decimate_set_range(decimate, 1.0, 1.0, NULL));
+   LONGS_EQUAL(0, asciip_decimate_set_range(decimate, 0.0, 8.0, NULL));
+
+   /* Streaming in two batches, flat buckets give one point, the right
+    * edge belongs to the last bucket and only the nearest outside
+    * points are kept */
+   asciip_decimate_add(decimate, xs, ys, 5);
+   asciip_decimate_add(decimate, xs + 5, ys + 5, 8);
+   LONGS_EQUAL(0, asciip_decimate_output(decimate, series, NULL));
+   check_points(expected_x, expected_y, 9);
+
+   /* Clearing keeps the range */
+   asciip_decimate_clear(decimate);
+   asciip_series_remove_range(series, 0, series->size, NULL, NULL);
+   LONGS_EQUAL(0, asciip_decimate_output(decimate, series, NULL));
+   UNSIGNED_LONGS_EQUAL(0, series->size);
+   DOUBLES_EQUAL(0.5, decimate->x_scale, 0.0);
+}
+
+TEST(DecimateTestGroup, TestDecimateLTTB)
+{
+   const double xs[] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+   const double ys[] = { 0.0, 1.0, 4.0, 0.0, 0.0, -3.0, 0.0 };
+   const double expected_x[] = { 0.0, 1.0, 2.0, 5.0, 6.0 };
+   const double expected_y[] = { 0.0, 1.0, 4.0, -3.0, 0.0 };
+
+   /* Ends are kept, each bucket keeps the extreme with the larger
+    * triangle against the kept point and the next bucket's mean */
+   decimate = asciip_decimate_init(3, ASCIIP_DECIMATE_LTTB, &decimate, NULL);
+   LONGS_EQUAL(0, asciip_decimate_set_range(decimate, 0.0, 6.0, NULL));
+   asciip_decimate_add(decimate, xs, ys, 7);
+   LONGS_EQUAL(0, asciip_decimate_output(decimate, series, NULL));
+   check_points(expected_x, expected_y, 5);
+}
+
+TEST(DecimateTestGroup, TestDecimateExtremesKept)
+{
+   Asciip_Series *reduced;
+   Asciip_List *list;
+   double low = INFINITY;
+   double high = -INFINITY;
+   size_t ind;
+   uint8_t method;
+
+   list = asciip_list_init_pooled(0, &list, NULL);
+   for (ind = 0; ind < 100000; ind++)
+   {
+      double y = sin((double)ind / 1000.0) + ((ind == 31337) ? 50.0 : 0.0) - ((ind == 77777) ? 50.0 : 0.0);
+
+      asciip_series_add(series, (double)ind, y, NULL);
+      asciip_list_add_xy(list, (double)ind, y, NULL);
+   }
+
+   for (method = ASCIIP_DECIMATE_MINMAX; method <= ASCIIP_DECIMATE_LTTB; method++)
+   {
+      decimate = asciip_decimate_init(80, method, &decimate, NULL);
+      reduced = asciip_series_init(0, &reduced, NULL);
+      LONGS_EQUAL(0, asciip_decimate_set_range(decimate, 0.0, 99999.0, NULL));
+      LONGS_EQUAL(0, asciip_decimate_add_series(decimate, series, NULL));
+      LONGS_EQUAL(0, asciip_decimate_output(decimate, reduced, NULL));
+      CHECK(reduced->size <= 2 * 80 + 2);
+
+      /* Both spikes survive, in x order */
+      low = INFINITY;
+      high = -INFINITY;
+      for (ind = 0; ind < reduced->size; ind++)
+      {
+         low = (reduced->y[ind] < low) ? reduced->y[ind] : low;
+         high = (reduced->y[ind] > high) ? reduced->y[ind] : high;
+         CHECK((ind == 0) || (reduced->x[ind - 1] < reduced->x[ind]));
+      }
+      CHECK(high > 40.0);
+      CHECK(low < -40.0);
+
+      /* A list streams to the same points */
+      asciip_decimate_clear(decimate);
+      LONGS_EQUAL(0, asciip_decimate_add_list(decimate, list, NULL));
+      ind = reduced->size;
+      LONGS_EQUAL(0, asciip_decimate_output(decimate, reduced, NULL));
+      UNSIGNED_LONGS_EQUAL(2 * ind, reduced->size);
+      MEMCMP_EQUAL(reduced->y, reduced->y + ind, ind * sizeof(double));
+
+      asciip_series_destroy(reduced);
+      asciip_decimate_destroy(decimate);
+   }
+
+   decimate = NULL;
+   LONGS_EQUAL(0, asciip_list_destroy(list, NULL));
+}
@@ -0,0 +1,139 @@
+/************************************************************************
+ *
+ * File        : test_asciip_file.cpp
+ *
+ * Description : Test cases for the memory-mapped series file format.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_file.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(FileTestGroup)
+{
+   Asciip_Series *series;
+   char path[32];
+
+   void setup()
+   {
+      size_t ind;
+
+      series = asciip_series_init(0, &series, NULL);
+      for (ind = 0; ind < 1000; ind++)
+      {
+         asciip_series_add(series, (double)ind, (double)(ind % 7) - 3.0, NULL);
+      }
+
+      snprintf(path, sizeof(path), "/tmp/asciip_file_XXXXXX");
+      close(mkstemp(path));
+   }
+
+   void teardown()
+   {
+      asciip_series_destroy(series);
+      unlink(path);
+   }
+};
+
+TEST(FileTestGroup, TestFileRoundTrip)
+{
+   Asciip_File *file;
+   Asciip_Series_View view;
+
+   UNSIGNED_LONGS_EQUAL(128, sizeof(Asciip_File_Header));
+   LONGS_EQUAL(0, asciip_file_write(path, series, NULL));
+   file = asciip_file_init(path, &file, NULL);
+   CHECK_TEXT((file != NULL), "File was not loaded");
+
+   /* The columns are read in place from the mapping */
+   UNSIGNED_LONGS_EQUAL(1000, file->series.size);
+   UNSIGNED_LONGS_EQUAL(128 + 2 * 1000 * sizeof(double), file->length);
+   POINTERS_EQUAL((const char *)file->map + 128, file->series.x);
+   DOUBLES_EQUAL(999.0, file->series.x[999], 0.0);
+   DOUBLES_EQUAL(2.0, file->series.y[999], 0.0);
+
+   /* Bounds and order come from the header */
+   UNSIGNED_LONGS_EQUAL(1, file->sorted);
+   DOUBLES_EQUAL(0.0, file->bounds.x.min, 0.0);
+   DOUBLES_EQUAL(999.0, file->bounds.x.max, 0.0);
+   DOUBLES_EQUAL(-3.0, file->bounds.y.min, 0.0);
+   DOUBLES_EQUAL(3.0, file->bounds.y.max, 0.0);
+   UNSIGNED_LONGS_EQUAL(1000, file->bounds.y.count);
+
+   LONGS_EQUAL(0, asciip_series_range(&file->series, 10.0, 19.5, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(10, view.offset);
+   UNSIGNED_LONGS_EQUAL(10, view.size);
+
+   asciip_file_destroy(file);
+}
+
+TEST(FileTestGroup, TestFileUnsorted)
+{
+   Asciip_File *file;
+
+   asciip_series_add(series, 5.0, NAN, NULL);
+   LONGS_EQUAL(0, asciip_file_write(path, series, NULL));
+   file = asciip_file_init(path, &file, NULL);
+
+   UNSIGNED_LONGS_EQUAL(0, file->sorted);
+   UNSIGNED_LONGS_EQUAL(1001, file->series.size);
+   UNSIGNED_LONGS_EQUAL(1, file->bounds.y.nans);
+   CHECK(isnan(file->series.y[1000]));
+   asciip_file_destroy(file);
+
+   /* An empty series still makes a valid file */
+   series->size = 0;
+   LONGS_EQUAL(0, asciip_file_write(path, series, NULL));
+   file = asciip_file_init(path, &file, NULL);
+   UNSIGNED_LONGS_EQUAL(0, file->series.size);
+   UNSIGNED_LONGS_EQUAL(1, file->sorted);
+   asciip_file_destroy(file);
+}
+
+TEST(FileTestGroup, TestFileRejected)
+{
+   Asciip_File *file;
+   Asciip_Error error;
+
+   CHECK_TEXT((!asciip_file_init(path, &file, &error)), "Empty file was loaded");
+   LONGS_EQUAL(ASCIIP_ERR_IO, error.code);
+   CHECK_TEXT((!asciip_file_init("/nonexistent/asciip", &file, NULL)), "Missing file was loaded");
+   CHECK_TEXT((!asciip_file_init(path, NULL, NULL)), "File was loaded with NULL result");
+   LONGS_EQUAL(-1, asciip_file_write(path, NULL, NULL));
+
+   /* A file cut short of its columns is not trusted */
+   LONGS_EQUAL(0, asciip_file_write(path, series, NULL));
+   LONGS_EQUAL(0, truncate(path, 128 + 1000 * sizeof(double)));
+   CHECK_TEXT((!asciip_file_init(path, &file, &error)), "Truncated file was loaded");
+   LONGS_EQUAL(ASCIIP_ERR_RANGE, error.code);
+}
@@ -13,7 +13,9 @@
 /************************************************************************
  * Standard Header Includes
  ************************************************************************/
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 /************************************************************************
  * Other Header Includes
@@ -21,6 +23,7 @@
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
 #include "asciip_lists.h"
+#include "asciip_pool.h"
 
 /************************************************************************
  * Macro Definitions
@@ -37,6 +40,14 @@
 /************************************************************************
  * Functions
  ************************************************************************/
+/* Selects points with odd x */
+static uint8_t odd_x(double x, double y, void *context)
+{
+   (void)y;
+   (void)context;
+   return ((long)x % 2) != 0;
+}
+
 /* TODO need to add checks for error reporting the correct codes using mocks */
 TEST_GROUP(ListTestGroup)
 {
@@ -79,3 +90,622 @@ TEST(ListTestGroup, TestListInit)
    UNSIGNED_LONGS_EQUAL(1, res->size);
    POINTERS_EQUAL(point, res->head->data);
 };
+
+TEST(ListTestGroup, TestListIndexPastUint16)
+{
+   Asciip_List *res;
+   Asciip_Point *point;
+   size_t ind;
+
+   /* Build a list longer than the old 65,535 point ceiling */
+   res = asciip_list_init(NULL, &res, NULL);
+   for (ind = 0; ind < 70000; ind++)
+   {
+      point = asciip_point_init((double)ind, 0, &point, NULL);
+      LONGS_EQUAL(0, asciip_list_add(res, point, NULL));
+   }
+   UNSIGNED_LONGS_EQUAL(70000, res->size);
+
+   /* Points past the old ceiling are reachable by index */
+   point = asciip_list_get(res, 69999, NULL, NULL);
+   CHECK_TEXT((point), "Could not get point past 65,535");
+   DOUBLES_EQUAL(69999.0, point->x, 0.0);
+   point = asciip_list_get(res, 1, NULL, NULL);
+   DOUBLES_EQUAL(1.0, point->x, 0.0);
+   CHECK_TEXT((!asciip_list_get(res, 70000, NULL, NULL)), "Got point past end of list");
+
+   /* Removing the tail moves the tail back */
+   point = asciip_list_remove(res, 69999, NULL);
+   DOUBLES_EQUAL(69999.0, point->x, 0.0);
+   asciip_point_destroy(point);
+   DOUBLES_EQUAL(69998.0, res->tail->data->x, 0.0);
+
+   /* Removing from the middle keeps the order */
+   point = asciip_list_remove(res, 65536, NULL);
+   DOUBLES_EQUAL(65536.0, point->x, 0.0);
+   asciip_point_destroy(point);
+   DOUBLES_EQUAL(65537.0, asciip_list_get(res, 65536, NULL, NULL)->x, 0.0);
+   UNSIGNED_LONGS_EQUAL(69998, res->size);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListIndexSlidingWindow)
+{
+   Asciip_List *res;
+   Asciip_Point *point;
+   size_t most = 0;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   for (ind = 0; ind < 1000; ind++)
+   {
+      asciip_list_add_xy(res, (double)ind, 0.0, NULL);
+   }
+   DOUBLES_EQUAL(500.0, asciip_list_get(res, 500, NULL, NULL)->x, 0.0);
+
+   /* Appending at the back and removing at the front empties a chunk
+    * every ASCIIP_LIST_INDEX_CHUNK points, those must not pile up */
+   for (ind = 1000; ind < 200000; ind++)
+   {
+      asciip_list_add_xy(res, (double)ind, 0.0, NULL);
+      point = asciip_list_remove(res, 0, NULL);
+      DOUBLES_EQUAL((double)(ind - 1000), point->x, 0.0);
+      asciip_point_destroy(point);
+
+      if (asciip_list_index_chunks(res) > most)
+      {
+         most = asciip_list_index_chunks(res);
+      }
+   }
+
+   CHECK(most > 0);
+   CHECK(most <= 2 * (1000 / ASCIIP_LIST_INDEX_CHUNK + 2));
+   UNSIGNED_LONGS_EQUAL(1000, res->size);
+   DOUBLES_EQUAL(199500.0, asciip_list_get(res, 500, NULL, NULL)->x, 0.0);
+   DOUBLES_EQUAL(199000.0, asciip_list_get(res, 0, NULL, NULL)->x, 0.0);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListIndexPastUint32)
+{
+   Asciip_List *res;
+   Asciip_List *other;
+   Asciip_List *split;
+   Asciip_Point *point;
+   size_t wide = (size_t)UINT32_MAX + 6;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   for (ind = 0; ind < 70000; ind++)
+   {
+      LONGS_EQUAL(0, asciip_list_add_xy(res, (double)ind, 0.0, NULL));
+   }
+
+   /* An index past 2^16 is not cut down to a smaller one */
+   point = asciip_list_get(res, (1 << 16) + 5, NULL, NULL);
+   DOUBLES_EQUAL(65541.0, point->x, 0.0);
+
+#if SIZE_MAX > UINT32_MAX
+   /* Indices and counts past 2^32 would land on point 5 if they were
+    * cut to 32 bits, they must fail instead and leave the list alone */
+   other = asciip_list_init(NULL, &other, NULL);
+   asciip_list_add_xy(other, -1.0, 0.0, NULL);
+   CHECK_TEXT((!asciip_list_get(res, wide, NULL, NULL)), "Got point past 2^32");
+   CHECK_TEXT((!asciip_list_remove(res, wide, NULL)), "Removed point past 2^32");
+   LONGS_EQUAL(-1, asciip_list_remove_range(res, wide, 1, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_list_remove_range(res, 5, wide, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_list_splice(res, wide, other, NULL));
+   CHECK_TEXT((!asciip_list_split(res, wide, &split, NULL)), "Split past 2^32");
+   UNSIGNED_LONGS_EQUAL(70000, res->size);
+   UNSIGNED_LONGS_EQUAL(1, other->size);
+   DOUBLES_EQUAL(5.0, asciip_list_get(res, 5, NULL, NULL)->x, 0.0);
+   DOUBLES_EQUAL(69999.0, res->tail->data->x, 0.0);
+   LONGS_EQUAL(0, asciip_list_destroy(other, NULL));
+#else
+   (void)other;
+   (void)split;
+   (void)wide;
+#endif
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListSortOddSize)
+{
+   Asciip_List *res;
+   Asciip_Point *point;
+   const double values[] = {5, 3, 9, 1, 7, 2, 8};
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   for (ind = 0; ind < sizeof(values) / sizeof(values[0]); ind++)
+   {
+      point = asciip_point_init(values[ind], 0, &point, NULL);
+      asciip_list_add(res, point, NULL);
+   }
+
+   LONGS_EQUAL(0, asciip_list_sort(res, NULL));
+   for (ind = 1; ind < res->size; ind++)
+   {
+      CHECK_TEXT((asciip_list_get(res, ind - 1, NULL, NULL)->x <= asciip_list_get(res, ind, NULL, NULL)->x),
+                 "List was not sorted");
+   }
+   UNSIGNED_LONGS_EQUAL(7, res->size);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListPooled)
+{
+   Asciip_List *res;
+   Asciip_Point *point;
+   size_t ind;
+
+   res = asciip_list_init_pooled(256, &res, NULL);
+   CHECK_TEXT((res), "Pooled list was not initialized");
+   CHECK_TEXT((res->pool), "Pooled list has no pool");
+   UNSIGNED_LONGS_EQUAL(0, res->size);
+
+   for (ind = 0; ind < 10000; ind++)
+   {
+      LONGS_EQUAL(0, asciip_list_add_xy(res, (double)ind, (double)(2 * ind), NULL));
+   }
+
+   /* Caller allocated points are copied into the pool */
+   point = asciip_point_init(10000, 20000, &point, NULL);
+   LONGS_EQUAL(0, asciip_list_add(res, point, NULL));
+   UNSIGNED_LONGS_EQUAL(10001, res->size);
+   DOUBLES_EQUAL(20000.0, res->tail->data->y, 0.0);
+
+   /* One malloc per block of 256 points instead of two per point */
+   UNSIGNED_LONGS_EQUAL(2 * 10001, res->pool->allocs);
+   UNSIGNED_LONGS_EQUAL((10001 + 255) / 256, res->pool->mallocs);
+
+   /* Removed points are owned by the caller, pool slots are reused */
+   point = asciip_list_remove(res, 5000, NULL);
+   CHECK_TEXT((point), "Could not remove from pooled list");
+   DOUBLES_EQUAL(5000.0, point->x, 0.0);
+   asciip_point_destroy(point);
+   DOUBLES_EQUAL(5001.0, asciip_list_get(res, 5000, NULL, NULL)->x, 0.0);
+
+   LONGS_EQUAL(0, asciip_list_add_xy(res, 1, 1, NULL));
+   UNSIGNED_LONGS_EQUAL((10001 + 255) / 256, res->pool->mallocs);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListIndexedAccess)
+{
+   Asciip_List *res;
+   Asciip_Point *point;
+   double *expected;
+   size_t size = 0;
+   size_t ind;
+   size_t pos;
+
+   expected = (double *)malloc(20000 * sizeof(double));
+   res = asciip_list_init_pooled(0, &res, NULL);
+
+   /* Interleave appends, removes and gets against a reference array */
+   srand(7);
+   for (ind = 0; ind < 20000; ind++)
+   {
+      if ((size > 0) && (rand() % 3 == 0))
+      {
+         pos = (size_t)rand() % size;
+         point = asciip_list_remove(res, pos, NULL);
+         DOUBLES_EQUAL(expected[pos], point->x, 0.0);
+         asciip_point_destroy(point);
+         memmove(&expected[pos], &expected[pos + 1], (size - pos - 1) * sizeof(double));
+         size--;
+      }
+      else
+      {
+         asciip_list_add_xy(res, (double)ind, 0, NULL);
+         expected[size++] = (double)ind;
+      }
+
+      if (size > 0)
+      {
+         pos = (size_t)rand() % size;
+         DOUBLES_EQUAL(expected[pos], asciip_list_get(res, pos, NULL, NULL)->x, 0.0);
+      }
+   }
+
+   /* Every position still resolves after the churn */
+   UNSIGNED_LONGS_EQUAL(size, res->size);
+   for (pos = 0; pos < size; pos++)
+   {
+      DOUBLES_EQUAL(expected[pos], asciip_list_get(res, pos, NULL, NULL)->x, 0.0);
+   }
+   DOUBLES_EQUAL(expected[size - 1], res->tail->data->x, 0.0);
+
+   free(expected);
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListIterator)
+{
+   Asciip_List *res;
+   Asciip_List_Iter iter;
+   Asciip_Point *point;
+   double xs[4];
+   double ys[4];
+   size_t ind;
+
+   /* Empty list ends immediately */
+   res = asciip_list_init(NULL, &res, NULL);
+   asciip_list_iter_begin(res, &iter);
+   CHECK_TEXT((!asciip_list_iter_next(&iter)), "Iterator returned point from empty list");
+
+   for (ind = 0; ind < 10; ind++)
+   {
+      asciip_list_add_xy(res, (double)ind, -(double)ind, NULL);
+   }
+
+   /* Points come back in list order */
+   ind = 0;
+   asciip_list_iter_begin(res, &iter);
+   while ((point = asciip_list_iter_next(&iter)) != NULL)
+   {
+      DOUBLES_EQUAL((double)ind, point->x, 0.0);
+      ind++;
+   }
+   UNSIGNED_LONGS_EQUAL(10, ind);
+
+   /* Batched reads copy runs of up to the buffer size */
+   asciip_list_iter_begin(res, &iter);
+   UNSIGNED_LONGS_EQUAL(4, asciip_list_iter_read(&iter, xs, ys, 4));
+   DOUBLES_EQUAL(3.0, xs[3], 0.0);
+   DOUBLES_EQUAL(-3.0, ys[3], 0.0);
+   UNSIGNED_LONGS_EQUAL(4, asciip_list_iter_read(&iter, xs, ys, 4));
+   UNSIGNED_LONGS_EQUAL(2, asciip_list_iter_read(&iter, xs, ys, 4));
+   DOUBLES_EQUAL(9.0, xs[1], 0.0);
+   UNSIGNED_LONGS_EQUAL(0, asciip_list_iter_read(&iter, xs, ys, 4));
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListSortStable)
+{
+   Asciip_List *res;
+   Asciip_List_Iter iter;
+   Asciip_Point *point;
+   Asciip_Point *prev;
+   size_t sizes[] = { 100, 5000 };
+   size_t run;
+   size_t ind;
+
+   /* Both the merge path and the radix path keep equal x in list order */
+   for (run = 0; run < 2; run++)
+   {
+      res = asciip_list_init(NULL, &res, NULL);
+      srand(5);
+      for (ind = 0; ind < sizes[run]; ind++)
+      {
+         asciip_list_add_xy(res, (double)(rand() % 50), (double)ind, NULL);
+      }
+
+      LONGS_EQUAL(0, asciip_list_sort(res, NULL));
+      UNSIGNED_LONGS_EQUAL(sizes[run], res->size);
+
+      asciip_list_iter_begin(res, &iter);
+      prev = asciip_list_iter_next(&iter);
+      while ((point = asciip_list_iter_next(&iter)) != NULL)
+      {
+         CHECK_TEXT((prev->x <= point->x), "List was not sorted");
+         if (prev->x <= point->x && point->x <= prev->x)
+         {
+            CHECK_TEXT((prev->y < point->y), "List sort was not stable");
+         }
+         prev = point;
+      }
+      POINTERS_EQUAL(prev, res->tail->data);
+      DOUBLES_EQUAL(asciip_list_get(res, sizes[run] - 1, NULL, NULL)->x, prev->x, 0.0);
+
+      LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+   }
+};
+
+TEST(ListTestGroup, TestListKeepSorted)
+{
+   Asciip_List *res;
+   Asciip_List_Iter iter;
+   Asciip_Point *point;
+   Asciip_Point *prev;
+   size_t ind;
+
+   res = asciip_list_init_pooled(0, &res, NULL);
+   asciip_list_add_xy(res, 5, 0, NULL);
+   asciip_list_add_xy(res, 1, 0, NULL);
+
+   /* Turning the mode on sorts what is already there */
+   LONGS_EQUAL(0, asciip_list_keep_sorted(res, 1, NULL));
+   DOUBLES_EQUAL(1.0, res->head->data->x, 0.0);
+   DOUBLES_EQUAL(5.0, res->tail->data->x, 0.0);
+
+   /* Mostly increasing x with some stragglers and many duplicates */
+   srand(9);
+   for (ind = 0; ind < 20000; ind++)
+   {
+      double x = (rand() % 10 == 0) ? (double)(rand() % 100) : (double)(ind / 100);
+
+      LONGS_EQUAL(0, asciip_list_add_xy(res, x, (double)ind, NULL));
+
+      if (ind % 1000 == 0)
+      {
+         point = asciip_list_remove(res, (size_t)rand() % res->size, NULL);
+         asciip_point_destroy(point);
+      }
+   }
+
+   /* Order holds and equal x keep arrival order */
+   asciip_list_iter_begin(res, &iter);
+   prev = asciip_list_iter_next(&iter);
+   ind = 1;
+   while ((point = asciip_list_iter_next(&iter)) != NULL)
+   {
+      CHECK_TEXT((prev->x <= point->x), "Keep sorted list out of order");
+      if ((prev->x <= point->x) && (point->x <= prev->x))
+      {
+         CHECK_TEXT((prev->y < point->y), "Equal x were not kept in arrival order");
+      }
+      DOUBLES_EQUAL(point->x, asciip_list_get(res, ind, NULL, NULL)->x, 0.0);
+      prev = point;
+      ind++;
+   }
+   UNSIGNED_LONGS_EQUAL(res->size, ind);
+   POINTERS_EQUAL(prev, res->tail->data);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListAddMany)
+{
+   Asciip_List *res;
+   const double xs[] = { 3, 1, 2 };
+   const double ys[] = { 30, 10, 20 };
+
+   res = asciip_list_init_pooled(0, &res, NULL);
+   LONGS_EQUAL(0, asciip_list_add_many(res, xs, ys, 3, NULL));
+   UNSIGNED_LONGS_EQUAL(3, res->size);
+   DOUBLES_EQUAL(10.0, asciip_list_get(res, 1, NULL, NULL)->y, 0.0);
+
+   /* Keep sorted lists place each point */
+   LONGS_EQUAL(0, asciip_list_keep_sorted(res, 1, NULL));
+   LONGS_EQUAL(0, asciip_list_add_many(res, xs, ys, 3, NULL));
+   UNSIGNED_LONGS_EQUAL(6, res->size);
+   DOUBLES_EQUAL(1.0, asciip_list_get(res, 1, NULL, NULL)->x, 0.0);
+   DOUBLES_EQUAL(3.0, res->tail->data->x, 0.0);
+
+   LONGS_EQUAL(-1, asciip_list_add_many(res, NULL, ys, 3, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListRemoveBatch)
+{
+   Asciip_List *res;
+   Asciip_List *removed;
+   Asciip_List *pooled;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   removed = asciip_list_init(NULL, &removed, NULL);
+   pooled = asciip_list_init_pooled(0, &pooled, NULL);
+   for (ind = 0; ind < 200; ind++)
+   {
+      asciip_list_add_xy(res, (double)ind, -(double)ind, NULL);
+   }
+
+   /* Out of bounds ranges leave the list alone */
+   LONGS_EQUAL(-1, asciip_list_remove_range(res, 150, 51, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_list_remove_range(res, 0, 1, res, NULL));
+   UNSIGNED_LONGS_EQUAL(200, res->size);
+
+   /* Middle range moves nodes to removed, indexed access still works */
+   DOUBLES_EQUAL(120.0, asciip_list_get(res, 120, NULL, NULL)->x, 0.0);
+   LONGS_EQUAL(0, asciip_list_remove_range(res, 10, 20, removed, NULL));
+   UNSIGNED_LONGS_EQUAL(180, res->size);
+   UNSIGNED_LONGS_EQUAL(20, removed->size);
+   DOUBLES_EQUAL(10.0, removed->head->data->x, 0.0);
+   DOUBLES_EQUAL(29.0, removed->tail->data->x, 0.0);
+   DOUBLES_EQUAL(30.0, asciip_list_get(res, 10, NULL, NULL)->x, 0.0);
+
+   /* Trailing range moves the tail back */
+   LONGS_EQUAL(0, asciip_list_remove_range(res, 170, 10, NULL, NULL));
+   DOUBLES_EQUAL(189.0, res->tail->data->x, 0.0);
+
+   /* Window trim copies into a pooled list */
+   LONGS_EQUAL(0, asciip_list_remove_outside(res, 50.0, 150.0, pooled, NULL));
+   UNSIGNED_LONGS_EQUAL(100, res->size);
+   UNSIGNED_LONGS_EQUAL(70, pooled->size);
+   DOUBLES_EQUAL(50.0, res->head->data->x, 0.0);
+   DOUBLES_EQUAL(149.0, res->tail->data->x, 0.0);
+   DOUBLES_EQUAL(150.0, asciip_list_get(pooled, 30, NULL, NULL)->x, 0.0);
+
+   /* Predicate removal releases points, tail ends on the last kept node */
+   LONGS_EQUAL(0, asciip_list_remove_if(res, odd_x, NULL, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(50, res->size);
+   DOUBLES_EQUAL(148.0, res->tail->data->x, 0.0);
+   DOUBLES_EQUAL(52.0, asciip_list_get(res, 1, NULL, NULL)->x, 0.0);
+
+   /* Removing everything empties the list, and it can be reused */
+   LONGS_EQUAL(0, asciip_list_remove_outside(pooled, 0.0, 0.0, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(0, pooled->size);
+   POINTERS_EQUAL(NULL, pooled->head);
+   POINTERS_EQUAL(NULL, pooled->tail);
+   LONGS_EQUAL(0, asciip_list_add_xy(pooled, 1.0, 1.0, NULL));
+   POINTERS_EQUAL(pooled->head, pooled->tail);
+
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(removed, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(pooled, NULL));
+};
+
+TEST(ListTestGroup, TestListSpliceSplit)
+{
+   Asciip_List *res;
+   Asciip_List *other;
+   Asciip_List *tail_list;
+   Asciip_List *pooled;
+   Asciip_List *pooled_tail;
+   Asciip_Node *moved;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   other = asciip_list_init(NULL, &other, NULL);
+   for (ind = 0; ind < 10; ind++)
+   {
+      asciip_list_add_xy(res, (double)ind, 0.0, NULL);
+      asciip_list_add_xy(other, (double)(100 + ind), 0.0, NULL);
+   }
+
+   LONGS_EQUAL(-1, asciip_list_splice(res, 11, other, NULL));
+   LONGS_EQUAL(-1, asciip_list_concat(res, res, NULL));
+
+   /* Splicing relinks the nodes themselves */
+   moved = other->head;
+   LONGS_EQUAL(0, asciip_list_splice(res, 5, other, NULL));
+   UNSIGNED_LONGS_EQUAL(20, res->size);
+   UNSIGNED_LONGS_EQUAL(0, other->size);
+   POINTERS_EQUAL(NULL, other->head);
+   POINTERS_EQUAL(NULL, other->tail);
+   POINTERS_EQUAL(moved, res->head->next->next->next->next->next);
+   DOUBLES_EQUAL(109.0, asciip_list_get(res, 14, NULL, NULL)->x, 0.0);
+   DOUBLES_EQUAL(5.0, asciip_list_get(res, 15, NULL, NULL)->x, 0.0);
+
+   /* Split moves the back half, concat puts it back */
+   tail_list = asciip_list_split(res, 15, &tail_list, NULL);
+   CHECK(tail_list != NULL);
+   UNSIGNED_LONGS_EQUAL(15, res->size);
+   UNSIGNED_LONGS_EQUAL(5, tail_list->size);
+   DOUBLES_EQUAL(109.0, res->tail->data->x, 0.0);
+   DOUBLES_EQUAL(5.0, tail_list->head->data->x, 0.0);
+   LONGS_EQUAL(0, asciip_list_concat(res, tail_list, NULL));
+   DOUBLES_EQUAL(9.0, res->tail->data->x, 0.0);
+   UNSIGNED_LONGS_EQUAL(20, res->size);
+   LONGS_EQUAL(0, asciip_list_destroy(tail_list, NULL));
+
+   /* Split of a pooled list at an x boundary shares the pool */
+   pooled = asciip_list_init_pooled(0, &pooled, NULL);
+   for (ind = 0; ind < 100; ind++)
+   {
+      asciip_list_add_xy(pooled, (double)ind, 0.0, NULL);
+   }
+   pooled_tail = asciip_list_split_x(pooled, 42.5, &pooled_tail, NULL);
+   POINTERS_EQUAL(pooled->pool, pooled_tail->pool);
+   UNSIGNED_LONGS_EQUAL(43, pooled->size);
+   UNSIGNED_LONGS_EQUAL(57, pooled_tail->size);
+   DOUBLES_EQUAL(42.0, pooled->tail->data->x, 0.0);
+   DOUBLES_EQUAL(43.0, pooled_tail->head->data->x, 0.0);
+
+   /* Pooled points copy into a heap list, the pool survives the first destroy */
+   LONGS_EQUAL(0, asciip_list_concat(res, pooled_tail, NULL));
+   UNSIGNED_LONGS_EQUAL(77, res->size);
+   DOUBLES_EQUAL(99.0, res->tail->data->x, 0.0);
+   LONGS_EQUAL(0, asciip_list_destroy(pooled_tail, NULL));
+   DOUBLES_EQUAL(42.0, asciip_list_get(pooled, 42, NULL, NULL)->x, 0.0);
+
+   LONGS_EQUAL(0, asciip_list_destroy(pooled, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(other, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListSpliceUnsortedKeepSorted)
+{
+   const double unsorted[] = { 15.0, 3.0, -1.0, 30.0, 3.0, 7.5 };
+   Asciip_List *res;
+   Asciip_List *other;
+   Asciip_List *tail_list;
+   Asciip_Node *nodep;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   other = asciip_list_init(NULL, &other, NULL);
+   LONGS_EQUAL(0, asciip_list_keep_sorted(res, 1, NULL));
+   for (ind = 0; ind < 10; ind++)
+   {
+      asciip_list_add_xy(res, (double)(2 * ind), -1.0, NULL);
+   }
+
+   /* Splice and concat take points from a list in any order */
+   for (ind = 0; ind < 6; ind++)
+   {
+      asciip_list_add_xy(other, unsorted[ind], (double)ind, NULL);
+   }
+   LONGS_EQUAL(0, asciip_list_splice(res, 3, other, NULL));
+   UNSIGNED_LONGS_EQUAL(0, other->size);
+   for (ind = 0; ind < 3; ind++)
+   {
+      asciip_list_add_xy(other, unsorted[ind] + 0.5, 10.0, NULL);
+   }
+   LONGS_EQUAL(0, asciip_list_concat(res, other, NULL));
+   UNSIGNED_LONGS_EQUAL(19, res->size);
+
+   for (nodep = res->head; nodep->next != NULL; nodep = nodep->next)
+   {
+      CHECK(!(nodep->next->data->x < nodep->data->x));
+   }
+   DOUBLES_EQUAL(-1.0, res->head->data->x, 0.0);
+   DOUBLES_EQUAL(30.0, res->tail->data->x, 0.0);
+
+   /* Points of other with equal x keep their order */
+   DOUBLES_EQUAL(10.0, asciip_list_get(res, 1, NULL, NULL)->y, 0.0);
+   DOUBLES_EQUAL(1.0, asciip_list_get(res, 4, NULL, NULL)->y, 0.0);
+   DOUBLES_EQUAL(4.0, asciip_list_get(res, 5, NULL, NULL)->y, 0.0);
+
+   /* Searches by x still find the boundary */
+   tail_list = asciip_list_split_x(res, 7.0, &tail_list, NULL);
+   DOUBLES_EQUAL(6.0, res->tail->data->x, 0.0);
+   DOUBLES_EQUAL(7.5, tail_list->head->data->x, 0.0);
+
+   LONGS_EQUAL(0, asciip_list_destroy(tail_list, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(other, NULL));
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
+
+TEST(ListTestGroup, TestListMerge)
+{
+   Asciip_List *lists[4];
+   Asciip_List *res;
+   Asciip_Node *nodep;
+   size_t ind;
+
+   res = asciip_list_init(NULL, &res, NULL);
+   for (ind = 0; ind < 4; ind++)
+   {
+      lists[ind] = asciip_list_init(NULL, &lists[ind], NULL);
+   }
+
+   /* Run r holds x = r, r + 4, ... with y tagging the run */
+   for (ind = 0; ind < 40; ind++)
+   {
+      asciip_list_add_xy((ind % 5 == 4) ? res : lists[ind % 5], (double)(ind / 5), (double)(ind % 5), NULL);
+   }
+   asciip_list_add_xy(lists[2], -1.0, 2.0, NULL);
+   LONGS_EQUAL(0, asciip_list_sort(lists[2], NULL));
+
+   LONGS_EQUAL(-1, asciip_list_merge(res, &res, 1, NULL));
+   LONGS_EQUAL(0, asciip_list_merge(res, lists, 4, NULL));
+   UNSIGNED_LONGS_EQUAL(41, res->size);
+   DOUBLES_EQUAL(-1.0, res->head->data->x, 0.0);
+   DOUBLES_EQUAL(7.0, res->tail->data->x, 0.0);
+
+   /* Sorted by x, ties in list order: res first, then the others */
+   nodep = res->head->next;
+   for (ind = 0; ind < 40; ind++, nodep = nodep->next)
+   {
+      DOUBLES_EQUAL((double)(ind / 5), nodep->data->x, 0.0);
+      DOUBLES_EQUAL((double)((ind % 5 + 4) % 5), nodep->data->y, 0.0);
+   }
+   POINTERS_EQUAL(NULL, nodep);
+
+   for (ind = 0; ind < 4; ind++)
+   {
+      UNSIGNED_LONGS_EQUAL(0, lists[ind]->size);
+      LONGS_EQUAL(0, asciip_list_destroy(lists[ind], NULL));
+   }
+   LONGS_EQUAL(0, asciip_list_destroy(res, NULL));
+};
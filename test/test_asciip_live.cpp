@@ -0,0 +1,140 @@
+/************************************************************************
+ *
+ * File        : test_asciip_live.cpp
+ *
+ * Description : Test cases for the fixed frame rate live plot.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_live.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Pushes a fast stream of points, then stops the loop */
+static void *live_producer(void *arg)
+{
+   Asciip_Live *live = (Asciip_Live *)arg;
+   struct timespec pause = { 0, 100000 };
+   double x;
+   double y;
+   int ind;
+
+   for (ind = 0; ind < 2000; ind++)
+   {
+      x = (double)ind;
+      y = (double)(ind % 10);
+      asciip_live_push(live, &x, &y, 1);
+      if (ind % 100 == 0)
+      {
+         nanosleep(&pause, NULL);
+      }
+   }
+
+   asciip_live_stop(live);
+   return NULL;
+}
+
+TEST_GROUP(LiveTestGroup)
+{
+   Asciip_Live *live;
+   FILE *stream;
+
+   void setup()
+   {
+      stream = tmpfile();
+      live = asciip_live_init(100, 4, 3, 200, stream, &live, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_live_destroy(live);
+      fclose(stream);
+   }
+};
+
+TEST(LiveTestGroup, TestLiveFrame)
+{
+   const double xs[] = { 0.0, 1.0, 2.0, 3.0, 10.0, 11.0 };
+   const double ys[] = { 9.0, 9.0, 9.0, 9.0, 0.0, 3.0 };
+   char printed[64];
+   Asciip_Live *other;
+
+   CHECK_TEXT((!asciip_live_init(10, 4, 3, 0, stream, &other, NULL)), "Live plot was initialized without a frame rate");
+
+   /* Only the window behind the newest point is drawn */
+   live->window = 1.0;
+   live->style = ASCIIP_CANVAS_POINTS;
+   asciip_live_push(live, xs, ys, 6);
+   LONGS_EQUAL(0, asciip_live_frame(live, NULL));
+   UNSIGNED_LONGS_EQUAL(2, live->ring->size);
+   UNSIGNED_LONGS_EQUAL(1, live->frames);
+
+   rewind(stream);
+   UNSIGNED_LONGS_EQUAL(30, fread(printed, 1, sizeof(printed), stream));
+   MEMCMP_EQUAL("\033[1;1H   *"
+                "\033[2;1H    "
+                "\033[3;1H*   ", printed, 30);
+
+   /* Nothing new, nothing sent */
+   LONGS_EQUAL(0, asciip_live_frame(live, NULL));
+   UNSIGNED_LONGS_EQUAL(0, live->term->bytes);
+   UNSIGNED_LONGS_EQUAL(0, live->term->writes);
+}
+
+TEST(LiveTestGroup, TestLiveRun)
+{
+   pthread_t producer;
+   uint64_t start;
+   struct timespec now;
+
+   /* A frame limit stops the loop without a final frame */
+   LONGS_EQUAL(0, asciip_live_run(live, 3, NULL));
+   UNSIGNED_LONGS_EQUAL(3, live->frames);
+
+   /* A producer far faster than the frame rate does not change it, and
+    * stopping wakes the loop for one last frame */
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   start = (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+   pthread_create(&producer, NULL, live_producer, live);
+   LONGS_EQUAL(0, asciip_live_run(live, 0, NULL));
+   pthread_join(producer, NULL);
+   clock_gettime(CLOCK_MONOTONIC, &now);
+
+   UNSIGNED_LONGS_EQUAL(100, live->ring->size);
+   DOUBLES_EQUAL(1999.0, live->ring->x[(live->ring->head + 99) % 100], 0.0);
+   CHECK(live->frames - 3 <= ((uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000 - start) / 5 + 3);
+
+   /* Once stopped, running only writes the final frame */
+   LONGS_EQUAL(0, asciip_live_run(live, 0, NULL));
+}
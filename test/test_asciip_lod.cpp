@@ -0,0 +1,205 @@
+/************************************************************************
+ *
+ * File        : test_asciip_lod.cpp
+ *
+ * Description : Test cases for the level of detail pyramid.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_decimate.h"
+#include "asciip_lod.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(LodTestGroup)
+{
+   Asciip_Series *series;
+   Asciip_Lod *lod;
+
+   void setup()
+   {
+      series = asciip_series_init(0, &series, NULL);
+      lod = NULL;
+   }
+
+   void teardown()
+   {
+      asciip_lod_destroy(lod);
+      asciip_series_destroy(series);
+   }
+
+   void append(size_t count, uint8_t nans)
+   {
+      size_t ind;
+      size_t at;
+
+      for (ind = 0; ind < count; ind++)
+      {
+         at = series->size;
+         asciip_series_add(series,
+                           (double)at * 0.5,
+                           (nans && (at % 97 == 5)) ? NAN : (double)((at * 7919) % 1009) - 500.25,
+                           NULL);
+      }
+   }
+
+   /* Compares every column of a query with a scan of the series */
+   void check_query(double x_min, double x_max, size_t columns)
+   {
+      Asciip_Lod_Bucket result[64];
+      Asciip_Lod_Bucket expected;
+      double x_scale = (double)columns / (x_max - x_min);
+      size_t column;
+      size_t ind;
+      size_t at;
+
+      LONGS_EQUAL(0, asciip_lod_query(lod, x_min, x_max, columns, result, NULL));
+      for (column = 0; column < columns; column++)
+      {
+         expected.count = 0;
+         for (ind = 0; ind < series->size; ind++)
+         {
+            if ((series->x[ind] < x_min) || (series->x[ind] > x_max) || isnan(series->y[ind]))
+            {
+               continue;
+            }
+
+            at = (size_t)((series->x[ind] - x_min) * x_scale);
+            if (((at < columns) ? at : columns - 1) != column)
+            {
+               continue;
+            }
+
+            if ((expected.count == 0) || (series->y[ind] < expected.min))
+            {
+               expected.min = series->y[ind];
+            }
+            if ((expected.count == 0) || (series->y[ind] > expected.max))
+            {
+               expected.max = series->y[ind];
+            }
+            expected.count++;
+         }
+
+         UNSIGNED_LONGS_EQUAL(expected.count, result[column].count);
+         if (expected.count > 0)
+         {
+            DOUBLES_EQUAL(expected.min, result[column].min, 0.0);
+            DOUBLES_EQUAL(expected.max, result[column].max, 0.0);
+            DOUBLES_EQUAL(expected.min, series->y[result[column].min_at], 0.0);
+            DOUBLES_EQUAL(expected.max, series->y[result[column].max_at], 0.0);
+         }
+      }
+   }
+};
+
+TEST(LodTestGroup, TestLodQuery)
+{
+   Asciip_Lod_Bucket result[4];
+   Asciip_Lod *other;
+
+   CHECK_TEXT((!asciip_lod_init(NULL, 0, &other, NULL)), "Pyramid was initialized without a series");
+
+   append(20000, 1);
+   lod = asciip_lod_init(series, 3, &lod, NULL);
+   UNSIGNED_LONGS_EQUAL(20000 / ASCIIP_LOD_LEAF, lod->level[0].size);
+   UNSIGNED_LONGS_EQUAL(20000 / ASCIIP_LOD_LEAF / 2, lod->level[1].size);
+
+   /* Whole series, zoomed in, unaligned edges, past the ends */
+   check_query(0.0, 9999.5, 64);
+   check_query(1234.25, 1300.0, 40);
+   check_query(17.0, 9000.0, 7);
+   check_query(-100.0, 20000.0, 13);
+   check_query(5000.1, 5000.2, 3);
+
+   LONGS_EQUAL(-1, asciip_lod_query(lod, 1.0, 1.0, 4, result, NULL));
+   LONGS_EQUAL(-1, asciip_lod_query(lod, 0.0, 1.0, 0, result, NULL));
+}
+
+TEST(LodTestGroup, TestLodUpdate)
+{
+   Asciip_Lod *fresh;
+   size_t depth;
+
+   append(100, 1);
+   lod = asciip_lod_init(series, 1, &lod, NULL);
+
+   /* Appends only add buckets, ending where a fresh build would */
+   while (series->size < 9000)
+   {
+      append(331, 1);
+      LONGS_EQUAL(0, asciip_lod_update(lod, NULL));
+   }
+   fresh = asciip_lod_init(series, 2, &fresh, NULL);
+   for (depth = 0; depth < ASCIIP_LOD_MAX_LEVELS; depth++)
+   {
+      UNSIGNED_LONGS_EQUAL(fresh->level[depth].size, lod->level[depth].size);
+      if (fresh->level[depth].size > 0)
+      {
+         MEMCMP_EQUAL(fresh->level[depth].buckets, lod->level[depth].buckets,
+                      fresh->level[depth].size * sizeof(Asciip_Lod_Bucket));
+      }
+   }
+   asciip_lod_destroy(fresh);
+   check_query(0.0, 4600.0, 50);
+
+   /* Shrinking rebuilds */
+   LONGS_EQUAL(0, asciip_series_remove_range(series, 1000, series->size - 1000, NULL, NULL));
+   LONGS_EQUAL(0, asciip_lod_update(lod, NULL));
+   UNSIGNED_LONGS_EQUAL(1000 / ASCIIP_LOD_LEAF, lod->level[0].size);
+   check_query(0.0, 500.0, 10);
+}
+
+TEST(LodTestGroup, TestLodOutput)
+{
+   Asciip_Decimate *decimate;
+   Asciip_Series *expected;
+   Asciip_Series *output;
+
+   /* Matches min/max decimation of the same view */
+   append(50000, 0);
+   lod = asciip_lod_init(series, 0, &lod, NULL);
+   decimate = asciip_decimate_init(120, ASCIIP_DECIMATE_MINMAX, &decimate, NULL);
+   expected = asciip_series_init(0, &expected, NULL);
+   output = asciip_series_init(0, &output, NULL);
+
+   LONGS_EQUAL(0, asciip_decimate_set_range(decimate, 3000.0, 17000.0, NULL));
+   LONGS_EQUAL(0, asciip_decimate_add_series(decimate, series, NULL));
+   LONGS_EQUAL(0, asciip_decimate_output(decimate, expected, NULL));
+   LONGS_EQUAL(0, asciip_lod_output(lod, 3000.0, 17000.0, 120, output, NULL));
+
+   UNSIGNED_LONGS_EQUAL(expected->size, output->size);
+   MEMCMP_EQUAL(expected->x, output->x, expected->size * sizeof(double));
+   MEMCMP_EQUAL(expected->y, output->y, expected->size * sizeof(double));
+
+   asciip_series_destroy(expected);
+   asciip_series_destroy(output);
+   asciip_decimate_destroy(decimate);
+}
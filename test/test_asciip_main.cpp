@@ -0,0 +1,136 @@
+/************************************************************************
+ *
+ * File        : test_asciip_main.cpp
+ *
+ * Description : Test cases for the asciip command-line tool, run as a
+ *               separate process.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Room for the output of one run */
+#define MAIN_TEST_OUTPUT 256
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(MainTestGroup)
+{
+   char input[32];
+   char errors[32];
+   char out[MAIN_TEST_OUTPUT];
+   char err[MAIN_TEST_OUTPUT];
+
+   void setup()
+   {
+      int fd;
+
+      strcpy(input, "/tmp/asciip_inXXXXXX");
+      strcpy(errors, "/tmp/asciip_errXXXXXX");
+      fd = mkstemp(input);
+      close(fd);
+      fd = mkstemp(errors);
+      close(fd);
+   }
+
+   void teardown()
+   {
+      unlink(input);
+      unlink(errors);
+   }
+
+   /* Runs the tool on text with args, keeping stdout and stderr, and
+    * returns its exit status */
+   int run(const char *text,
+           const char *args)
+   {
+      char command[256];
+      FILE *stream;
+      size_t length;
+      int status;
+
+      stream = fopen(input, "w");
+      fputs(text, stream);
+      fclose(stream);
+
+      snprintf(command, sizeof(command), "%s %s < %s 2> %s", ASCIIP_TEST_CLI, args, input, errors);
+      stream = popen(command, "r");
+      length = fread(out, 1, sizeof(out) - 1, stream);
+      out[length] = '\0';
+      status = pclose(stream);
+
+      stream = fopen(errors, "r");
+      length = fread(err, 1, sizeof(err) - 1, stream);
+      err[length] = '\0';
+      fclose(stream);
+
+      return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+   }
+};
+
+TEST(MainTestGroup, TestMainPlot)
+{
+   LONGS_EQUAL(0, run("1 1\n2 2\n3 3\n", "-w 3 -h 3"));
+   STRCMP_EQUAL("  *\n"
+                " * \n"
+                "*  \n", out);
+   STRCMP_EQUAL("", err);
+}
+
+TEST(MainTestGroup, TestMainNonFinite)
+{
+   /* Points that are not finite are skipped, the rest still plot */
+   LONGS_EQUAL(0, run("1 1\n2 inf\n-inf 4\n3 nan\n3 2\n", "-w 3 -h 2 --stats"));
+   STRCMP_EQUAL("  *\n"
+                "*  \n", out);
+   CHECK(strstr(err, "2 points") != NULL);
+   CHECK(strstr(err, "3 lines skipped") != NULL);
+
+   /* Extremes whose span overflows a double still plot */
+   LONGS_EQUAL(0, run("-1e308 -1e308\n0 0\n1e308 1e308\n", "-w 3 -h 3"));
+   STRCMP_EQUAL("   \n"
+                " * \n"
+                "   \n", out);
+   STRCMP_EQUAL("", err);
+}
+
+TEST(MainTestGroup, TestMainErrors)
+{
+   /* Diagnostics go to stderr only */
+   LONGS_EQUAL(1, run("1 1\n", "-w 3 -h 3 /nonexistent/asciip"));
+   STRCMP_EQUAL("", out);
+   CHECK(strstr(err, "asciip: /nonexistent/asciip") != NULL);
+
+   LONGS_EQUAL(2, run("", "-w"));
+   STRCMP_EQUAL("", out);
+   CHECK(strstr(err, "usage: asciip") != NULL);
+}
@@ -0,0 +1,272 @@
+/************************************************************************
+ *
+ * File        : test_asciip_parse.cpp
+ *
+ * Description : Test cases for the text point parser.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_parse.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(ParseTestGroup)
+{
+   Asciip_Parse_Stats stats;
+   double xs[8];
+   double ys[8];
+
+   void setup()
+   {
+      memset(&stats, 0, sizeof(stats));
+   }
+
+   void teardown()
+   {
+   }
+
+   /* Parses all of text as one number, checking against strtod */
+   void check_number(const char *text)
+   {
+      const char *end = text + strlen(text);
+      double expected = strtod(text, NULL);
+      double value;
+
+      POINTERS_EQUAL(end, asciip_parse_number(text, end, &value));
+      if (isnan(expected))
+      {
+         CHECK(isnan(value));
+      }
+      else
+      {
+         CHECK(!(value < expected) && !(expected < value));
+      }
+   }
+};
+
+TEST(ParseTestGroup, TestParseNumber)
+{
+   const char *text = "12.5e";
+   double value;
+
+   check_number("0");
+   check_number("-17");
+   check_number("+3.25");
+   check_number(".5");
+   check_number("7.");
+   check_number("0.1");
+   check_number("1e22");
+   check_number("-2.5E-3");
+   check_number("123456789012345678");
+   check_number("0.12345678901234567");
+   check_number("1e300");
+   check_number("4.9e-324");
+   check_number("-inf");
+   check_number("nan");
+
+   /* The exponent needs digits, and nothing past end is read */
+   POINTERS_EQUAL(text + 4, asciip_parse_number(text, text + 5, &value));
+   DOUBLES_EQUAL(12.5, value, 0.0);
+   POINTERS_EQUAL(text + 2, asciip_parse_number(text, text + 2, &value));
+   DOUBLES_EQUAL(12.0, value, 0.0);
+
+   POINTERS_EQUAL(NULL, asciip_parse_number(text, text, &value));
+   POINTERS_EQUAL(NULL, asciip_parse_number("-", text + 1, &value));
+   POINTERS_EQUAL(NULL, asciip_parse_number("x1", text + 2, &value));
+   POINTERS_EQUAL(NULL, asciip_parse_number(" 1", text + 2, &value));
+}
+
+TEST(ParseTestGroup, TestParseLines)
+{
+   const char text[] = "x,y\n1 2\n\n  3,4\r\n5\t, 6,extra\n7x 8\n9 10";
+   size_t consumed;
+
+   /* The unterminated last line waits for more text */
+   UNSIGNED_LONGS_EQUAL(3, asciip_parse_lines(text, strlen(text), 0, xs, ys, 8, &consumed, &stats));
+   UNSIGNED_LONGS_EQUAL(strlen(text) - 4, consumed);
+   DOUBLES_EQUAL(1.0, xs[0], 0.0);
+   DOUBLES_EQUAL(4.0, ys[1], 0.0);
+   DOUBLES_EQUAL(5.0, xs[2], 0.0);
+   DOUBLES_EQUAL(6.0, ys[2], 0.0);
+   UNSIGNED_LONGS_EQUAL(6, stats.lines);
+   UNSIGNED_LONGS_EQUAL(3, stats.points);
+   UNSIGNED_LONGS_EQUAL(2, stats.skipped);
+
+   UNSIGNED_LONGS_EQUAL(1, asciip_parse_lines(text + consumed, 4, 1, xs, ys, 8, &consumed, &stats));
+   UNSIGNED_LONGS_EQUAL(4, consumed);
+   DOUBLES_EQUAL(10.0, ys[0], 0.0);
+
+   /* Parsing stops at the end of the line that fills the arrays */
+   UNSIGNED_LONGS_EQUAL(1, asciip_parse_lines(text, strlen(text), 1, xs, ys, 1, &consumed, NULL));
+   UNSIGNED_LONGS_EQUAL(8, consumed);
+}
+
+TEST(ParseTestGroup, TestParseFd)
+{
+   Asciip_Series *series;
+   char *text;
+   size_t length = 0;
+   size_t ind;
+   FILE *stream;
+
+   /* Enough lines to fill several batches */
+   text = (char *)malloc(3 * ASCIIP_PARSE_BATCH * 16);
+   for (ind = 0; ind < 3 * ASCIIP_PARSE_BATCH; ind++)
+   {
+      length += (size_t)sprintf(text + length, "%u %u\n", (unsigned)ind, (unsigned)(ind % 10));
+   }
+   length += (size_t)sprintf(text + length, "1e3,-1");
+
+   series = asciip_series_init(0, &series, NULL);
+   stream = tmpfile();
+   UNSIGNED_LONGS_EQUAL(length, fwrite(text, 1, length, stream));
+   fflush(stream);
+   rewind(stream);
+
+   LONGS_EQUAL(0, asciip_parse_fd(fileno(stream), series, &stats, NULL));
+   fclose(stream);
+   UNSIGNED_LONGS_EQUAL(3 * ASCIIP_PARSE_BATCH + 1, series->size);
+   UNSIGNED_LONGS_EQUAL(length, stats.bytes);
+   UNSIGNED_LONGS_EQUAL(series->size, stats.points);
+   DOUBLES_EQUAL(4097.0, series->x[4097], 0.0);
+   DOUBLES_EQUAL(7.0, series->y[4097], 0.0);
+   DOUBLES_EQUAL(1000.0, series->x[series->size - 1], 0.0);
+
+   LONGS_EQUAL(-1, asciip_parse_fd(-1, series, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_parse_fd(0, NULL, NULL, NULL));
+
+   asciip_series_destroy(series);
+   free(text);
+}
+
+TEST(ParseTestGroup, TestParseText)
+{
+   Asciip_Series *single;
+   Asciip_Series *chunked;
+   Asciip_Parse_Stats split;
+   char *text;
+   size_t length = 0;
+   size_t ind;
+   uint32_t threads;
+
+   text = (char *)malloc(1000 * 16);
+   for (ind = 0; ind < 1000; ind++)
+   {
+      length += (size_t)sprintf(text + length, (ind % 100 == 0) ? "bad\n" : "%u,%u\n", (unsigned)ind, (unsigned)(ind % 7));
+   }
+   length += (size_t)sprintf(text + length, "1e3 -1");
+
+   single = asciip_series_init(0, &single, NULL);
+   chunked = asciip_series_init(0, &chunked, NULL);
+   memset(&split, 0, sizeof(split));
+   asciip_series_add(chunked, -1.0, -1.0, NULL);
+
+   /* Any split gives the points of one thread, in the same order, after
+    * what was already there */
+   LONGS_EQUAL(0, asciip_parse_text(text, length, 1, single, &stats, NULL));
+   UNSIGNED_LONGS_EQUAL(991, single->size);
+   UNSIGNED_LONGS_EQUAL(length, stats.bytes);
+   UNSIGNED_LONGS_EQUAL(1001, stats.lines);
+   UNSIGNED_LONGS_EQUAL(10, stats.skipped);
+
+   for (threads = 2; threads <= 7; threads++)
+   {
+      chunked->size = 1;
+      memset(&split, 0, sizeof(split));
+      LONGS_EQUAL(0, asciip_parse_text(text, length, threads, chunked, &split, NULL));
+      UNSIGNED_LONGS_EQUAL(single->size + 1, chunked->size);
+      MEMCMP_EQUAL(single->x, chunked->x + 1, single->size * sizeof(double));
+      MEMCMP_EQUAL(single->y, chunked->y + 1, single->size * sizeof(double));
+      MEMCMP_EQUAL(&stats, &split, sizeof(stats));
+   }
+   DOUBLES_EQUAL(-1.0, chunked->x[0], 0.0);
+
+   /* More threads than lines leaves some chunks empty */
+   chunked->size = 0;
+   LONGS_EQUAL(0, asciip_parse_text("1 2\n3 4", 7, ASCIIP_PARSE_MAX_THREADS, chunked, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(2, chunked->size);
+   DOUBLES_EQUAL(3.0, chunked->x[1], 0.0);
+
+   LONGS_EQUAL(0, asciip_parse_text(text, 0, 4, chunked, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(2, chunked->size);
+   LONGS_EQUAL(-1, asciip_parse_text(NULL, 0, 1, chunked, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_parse_text(text, length, 1, NULL, NULL, NULL));
+   CHECK(asciip_parse_threads(0) == 1);
+   CHECK(asciip_parse_threads(SIZE_MAX) <= ASCIIP_PARSE_MAX_THREADS);
+
+   asciip_series_destroy(single);
+   asciip_series_destroy(chunked);
+   free(text);
+}
+
+TEST(ParseTestGroup, TestParseFile)
+{
+   Asciip_Series *series;
+   char path[32];
+   FILE *stream;
+   size_t ind;
+
+   snprintf(path, sizeof(path), "/tmp/asciip_parse_XXXXXX");
+   close(mkstemp(path));
+   series = asciip_series_init(0, &series, NULL);
+
+   /* An empty file has no points */
+   LONGS_EQUAL(0, asciip_parse_file(path, 2, series, &stats, NULL));
+   UNSIGNED_LONGS_EQUAL(0, series->size);
+
+   stream = fopen(path, "w");
+   for (ind = 0; ind < 5000; ind++)
+   {
+      fprintf(stream, "%u\t%u\r\n", (unsigned)ind, (unsigned)(ind % 10));
+   }
+   fclose(stream);
+
+   LONGS_EQUAL(0, asciip_parse_file(path, 3, series, &stats, NULL));
+   UNSIGNED_LONGS_EQUAL(5000, series->size);
+   UNSIGNED_LONGS_EQUAL(5000, stats.points);
+   for (ind = 0; ind < 5000; ind++)
+   {
+      DOUBLES_EQUAL((double)ind, series->x[ind], 0.0);
+   }
+   DOUBLES_EQUAL(9.0, series->y[4999], 0.0);
+
+   /* Anything that is not a regular file is read as a stream */
+   LONGS_EQUAL(0, asciip_parse_file("/dev/null", 0, series, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(5000, series->size);
+
+   unlink(path);
+   LONGS_EQUAL(-1, asciip_parse_file(path, 0, series, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_parse_file(NULL, 0, series, NULL, NULL));
+
+   asciip_series_destroy(series);
+}
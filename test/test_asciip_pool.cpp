@@ -0,0 +1,94 @@
+/************************************************************************
+ *
+ * File        : test_asciip_pool.cpp
+ *
+ * Description : Test cases for the fixed-size object pool.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_pool.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(PoolTestGroup)
+{
+   Asciip_Pool *pool;
+
+   void setup()
+   {
+      pool = NULL;
+   }
+
+   void teardown()
+   {
+      asciip_pool_destroy(pool);
+   }
+};
+
+TEST(PoolTestGroup, TestPoolInit)
+{
+   CHECK_TEXT((!asciip_pool_init(16, 4, NULL, NULL)), "Pool was initialized with NULL result");
+
+   /* Small objects are grown to hold the free list link */
+   pool = asciip_pool_init(1, 0, &pool, NULL);
+   CHECK_TEXT((pool), "Pool was not initialized");
+   UNSIGNED_LONGS_EQUAL(sizeof(void *), pool->object_size);
+   UNSIGNED_LONGS_EQUAL(ASCIIP_POOL_DEFAULT_BLOCK_OBJECTS, pool->block_objects);
+   UNSIGNED_LONGS_EQUAL(0, pool->mallocs);
+}
+
+TEST(PoolTestGroup, TestPoolBlocks)
+{
+   double *objects[10];
+   size_t ind;
+
+   pool = asciip_pool_init(sizeof(double), 4, &pool, NULL);
+
+   /* Ten objects at four per block need three blocks */
+   for (ind = 0; ind < 10; ind++)
+   {
+      objects[ind] = (double *)asciip_pool_alloc(pool, NULL);
+      CHECK_TEXT((objects[ind]), "Pool did not hand out object");
+      UNSIGNED_LONGS_EQUAL(0, (uintptr_t)objects[ind] % sizeof(double));
+      *objects[ind] = (double)ind;
+   }
+   UNSIGNED_LONGS_EQUAL(3, pool->mallocs);
+   UNSIGNED_LONGS_EQUAL(10, pool->allocs);
+
+   /* Objects do not overlap */
+   for (ind = 0; ind < 10; ind++)
+   {
+      DOUBLES_EQUAL((double)ind, *objects[ind], 0.0);
+   }
+
+   /* Released objects are handed out again before carving */
+   asciip_pool_release(pool, objects[3]);
+   POINTERS_EQUAL(objects[3], asciip_pool_alloc(pool, NULL));
+   UNSIGNED_LONGS_EQUAL(3, pool->mallocs);
+}
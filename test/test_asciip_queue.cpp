@@ -0,0 +1,200 @@
+/************************************************************************
+ *
+ * File        : test_asciip_queue.cpp
+ *
+ * Description : Test cases for the lock-free multi-producer queue.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_queue.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Producer threads and points per producer of the stress test */
+#define QUEUE_TEST_PRODUCERS 8
+#define QUEUE_TEST_POINTS    50000
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Pushes points x = lane, y = 0, 1, ... singly and in batches */
+static void *queue_producer(void *arg)
+{
+   Asciip_Queue *queue = (Asciip_Queue *)arg;
+   Asciip_Queue_Lane *lane = asciip_queue_lane(queue, NULL);
+   double xs[7];
+   double ys[7];
+   size_t sent = 0;
+   size_t batch;
+   size_t ind;
+
+   while (sent < QUEUE_TEST_POINTS)
+   {
+      if (sent % 2 == 0)
+      {
+         if (!asciip_queue_push(lane, (double)(lane - queue->lanes), (double)sent))
+         {
+            sched_yield();
+            continue;
+         }
+         sent++;
+      }
+      else
+      {
+         batch = (QUEUE_TEST_POINTS - sent < 7) ? QUEUE_TEST_POINTS - sent : 7;
+         for (ind = 0; ind < batch; ind++)
+         {
+            xs[ind] = (double)(lane - queue->lanes);
+            ys[ind] = (double)(sent + ind);
+         }
+
+         batch = asciip_queue_push_many(lane, xs, ys, batch);
+         if (batch == 0)
+         {
+            sched_yield();
+         }
+         sent += batch;
+      }
+   }
+
+   return NULL;
+}
+
+TEST_GROUP(QueueTestGroup)
+{
+   Asciip_Queue *queue;
+   Asciip_Series *series;
+
+   void setup()
+   {
+      queue = asciip_queue_init(2, 3, &queue, NULL);
+      series = asciip_series_init(0, &series, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_queue_destroy(queue);
+      asciip_series_destroy(series);
+   }
+};
+
+TEST(QueueTestGroup, TestQueueInit)
+{
+   Asciip_Queue *other;
+
+   CHECK_TEXT((!asciip_queue_init(2, 3, NULL, NULL)), "Queue was initialized with NULL result");
+   CHECK_TEXT((!asciip_queue_init(0, 3, &other, NULL)), "Queue was initialized without lanes");
+   CHECK_TEXT((!asciip_queue_init(2, 0, &other, NULL)), "Queue was initialized without capacity");
+
+   /* Capacity rounds up to a power of two, lanes sit on their own lines */
+   UNSIGNED_LONGS_EQUAL(3, queue->lanes[0].mask);
+   UNSIGNED_LONGS_EQUAL(2 * ASCIIP_QUEUE_LINE, sizeof(Asciip_Queue_Lane));
+   UNSIGNED_LONGS_EQUAL(0, (uintptr_t)queue->lanes % ASCIIP_QUEUE_LINE);
+
+   CHECK(asciip_queue_lane(queue, NULL) == &queue->lanes[0]);
+   CHECK(asciip_queue_lane(queue, NULL) == &queue->lanes[1]);
+   CHECK_TEXT((!asciip_queue_lane(queue, NULL)), "Lane was claimed twice");
+}
+
+TEST(QueueTestGroup, TestQueuePushDrain)
+{
+   const double xs[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+   Asciip_Queue_Lane *first = asciip_queue_lane(queue, NULL);
+   Asciip_Queue_Lane *second = asciip_queue_lane(queue, NULL);
+   size_t drained;
+
+   /* Full lanes refuse points rather than overwrite them */
+   UNSIGNED_LONGS_EQUAL(3, asciip_queue_push_many(first, xs, xs, 3));
+   UNSIGNED_LONGS_EQUAL(1, asciip_queue_push(first, 4.0, 4.0));
+   UNSIGNED_LONGS_EQUAL(0, asciip_queue_push(first, 5.0, 5.0));
+   UNSIGNED_LONGS_EQUAL(1, asciip_queue_push(second, 10.0, 10.0));
+
+   LONGS_EQUAL(0, asciip_queue_drain_series(queue, series, &drained, NULL));
+   UNSIGNED_LONGS_EQUAL(5, drained);
+   DOUBLES_EQUAL(1.0, series->x[0], 0.0);
+   DOUBLES_EQUAL(4.0, series->x[3], 0.0);
+   DOUBLES_EQUAL(10.0, series->x[4], 0.0);
+
+   /* A batch across the wrap drains as two runs, in order; the second
+    * lane goes first this time */
+   UNSIGNED_LONGS_EQUAL(4, asciip_queue_push_many(first, xs + 2, xs + 2, 4));
+   UNSIGNED_LONGS_EQUAL(1, asciip_queue_push(second, 11.0, 11.0));
+   LONGS_EQUAL(0, asciip_queue_drain_series(queue, series, &drained, NULL));
+   UNSIGNED_LONGS_EQUAL(5, drained);
+   UNSIGNED_LONGS_EQUAL(10, series->size);
+   DOUBLES_EQUAL(11.0, series->x[5], 0.0);
+   DOUBLES_EQUAL(3.0, series->x[6], 0.0);
+   DOUBLES_EQUAL(6.0, series->x[9], 0.0);
+
+   LONGS_EQUAL(0, asciip_queue_drain_series(queue, series, &drained, NULL));
+   UNSIGNED_LONGS_EQUAL(0, drained);
+   LONGS_EQUAL(-1, asciip_queue_drain_series(queue, NULL, &drained, NULL));
+}
+
+TEST(QueueTestGroup, TestQueueProducers)
+{
+   Asciip_Queue *shared;
+   pthread_t threads[QUEUE_TEST_PRODUCERS];
+   double expected[QUEUE_TEST_PRODUCERS] = { 0.0 };
+   size_t drained;
+   size_t lane;
+   size_t ind;
+
+   shared = asciip_queue_init(QUEUE_TEST_PRODUCERS, 256, &shared, NULL);
+   for (ind = 0; ind < QUEUE_TEST_PRODUCERS; ind++)
+   {
+      LONGS_EQUAL(0, pthread_create(&threads[ind], NULL, queue_producer, shared));
+   }
+
+   /* Drain while the producers run, until every point has arrived */
+   while (series->size < QUEUE_TEST_PRODUCERS * QUEUE_TEST_POINTS)
+   {
+      LONGS_EQUAL(0, asciip_queue_drain_series(shared, series, &drained, NULL));
+      if (drained == 0)
+      {
+         sched_yield();
+      }
+   }
+
+   for (ind = 0; ind < QUEUE_TEST_PRODUCERS; ind++)
+   {
+      pthread_join(threads[ind], NULL);
+   }
+
+   /* Every point once, each producer's points in the order pushed */
+   UNSIGNED_LONGS_EQUAL(QUEUE_TEST_PRODUCERS * QUEUE_TEST_POINTS, series->size);
+   for (ind = 0; ind < series->size; ind++)
+   {
+      lane = (size_t)series->x[ind];
+      DOUBLES_EQUAL(expected[lane], series->y[ind], 0.0);
+      expected[lane] += 1.0;
+   }
+
+   asciip_queue_destroy(shared);
+}
@@ -0,0 +1,132 @@
+/************************************************************************
+ *
+ * File        : test_asciip_ring.cpp
+ *
+ * Description : Test cases for the fixed-capacity ring buffer.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_ring.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(RingTestGroup)
+{
+   Asciip_Ring *ring;
+
+   void setup()
+   {
+      ring = asciip_ring_init(5, &ring, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_ring_destroy(ring);
+   }
+
+   /* Checks the ring holds x values first, first + 1, ... oldest first */
+   void check_ring(size_t size, double first)
+   {
+      Asciip_Series_View runs[2];
+      size_t ind;
+      size_t run;
+      double expected = first;
+
+      asciip_ring_runs(ring, runs);
+      UNSIGNED_LONGS_EQUAL(size, runs[0].size + runs[1].size);
+      UNSIGNED_LONGS_EQUAL(runs[0].size, runs[1].offset);
+      for (run = 0; run < 2; run++)
+      {
+         for (ind = 0; ind < runs[run].size; ind++)
+         {
+            DOUBLES_EQUAL(expected, runs[run].x[ind], 0.0);
+            DOUBLES_EQUAL(-expected, runs[run].y[ind], 0.0);
+            expected += 1.0;
+         }
+      }
+   }
+};
+
+TEST(RingTestGroup, TestRingPushEvict)
+{
+   Asciip_Series_View runs[2];
+   Asciip_Ring *other;
+   size_t ind;
+
+   CHECK_TEXT((!asciip_ring_init(0, &other, NULL)), "Ring was initialized without capacity");
+   LONGS_EQUAL(0, asciip_ring_runs(ring, runs));
+
+   for (ind = 0; ind < 3; ind++)
+   {
+      asciip_ring_push(ring, (double)ind, -(double)ind);
+   }
+   LONGS_EQUAL(1, asciip_ring_runs(ring, runs));
+   check_ring(3, 0.0);
+
+   /* A full ring overwrites the oldest and wraps into two runs */
+   for (; ind < 8; ind++)
+   {
+      asciip_ring_push(ring, (double)ind, -(double)ind);
+   }
+   LONGS_EQUAL(2, asciip_ring_runs(ring, runs));
+   check_ring(5, 3.0);
+
+   UNSIGNED_LONGS_EQUAL(2, asciip_ring_evict(ring, 2));
+   check_ring(3, 5.0);
+   UNSIGNED_LONGS_EQUAL(1, asciip_ring_evict_before(ring, 5.5));
+   check_ring(2, 6.0);
+   UNSIGNED_LONGS_EQUAL(2, asciip_ring_evict(ring, 10));
+   check_ring(0, 0.0);
+}
+
+TEST(RingTestGroup, TestRingPushMany)
+{
+   double xs[12];
+   double ys[12];
+   size_t ind;
+
+   for (ind = 0; ind < 12; ind++)
+   {
+      xs[ind] = (double)ind;
+      ys[ind] = -(double)ind;
+   }
+
+   /* Batches that wrap, fill exactly and overflow the ring */
+   asciip_ring_push_many(ring, xs, ys, 3);
+   asciip_ring_push_many(ring, xs + 3, ys + 3, 4);
+   check_ring(5, 2.0);
+   asciip_ring_push_many(ring, xs + 7, ys + 7, 5);
+   check_ring(5, 7.0);
+   asciip_ring_push_many(ring, xs, ys, 12);
+   check_ring(5, 7.0);
+
+   asciip_ring_clear(ring);
+   asciip_ring_push_many(ring, xs, ys, 2);
+   check_ring(2, 0.0);
+}
@@ -0,0 +1,217 @@
+/************************************************************************
+ *
+ * File        : test_asciip_sched.cpp
+ *
+ * Description : Test cases for the shared task scheduler.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_sched.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/* Indices and grain of the parallel runs */
+#define SCHED_TEST_COUNT 200000
+#define SCHED_TEST_GRAIN 1000
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+typedef struct _sched_test_t
+{
+   size_t    calls;                                        /* Chunks run */
+   size_t    begins[16];                                   /* Start of the first chunks run */
+   size_t    ends[16];                                     /* End of the first chunks run */
+   uint8_t  *hits;                                         /* Times each index was run */
+   double    sums[SCHED_TEST_COUNT / SCHED_TEST_GRAIN];    /* Sum per chunk */
+
+} Sched_Test;
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Records the chunks in the order they run */
+static void sched_record(size_t  begin,
+                         size_t  end,
+                         void   *context)
+{
+   Sched_Test *test = (Sched_Test *)context;
+
+   if (test->calls < 16)
+   {
+      test->begins[test->calls] = begin;
+      test->ends[test->calls] = end;
+   }
+   test->calls++;
+}
+
+/* Marks every index and sums a chunk into its own slot */
+static void sched_sum(size_t  begin,
+                      size_t  end,
+                      void   *context)
+{
+   Sched_Test *test = (Sched_Test *)context;
+   double sum = 0.0;
+   size_t ind;
+
+   for (ind = begin; ind < end; ind++)
+   {
+      test->hits[ind]++;
+      sum += sin((double)ind);
+   }
+   test->sums[begin / SCHED_TEST_GRAIN] = sum;
+}
+
+/* Starts a job from inside a job, which runs inline */
+static void sched_nested(size_t  begin,
+                         size_t  end,
+                         void   *context)
+{
+   Sched_Test *test = (Sched_Test *)context;
+   size_t ind;
+
+   for (ind = begin; ind < end; ind++)
+   {
+      asciip_sched_parallel_for(ind * SCHED_TEST_GRAIN, (ind + 1) * SCHED_TEST_GRAIN, 10, sched_sum, test, NULL);
+   }
+}
+
+/* Runs a job alongside the test thread */
+static void *sched_other(void *arg)
+{
+   Sched_Test *test = (Sched_Test *)arg;
+
+   asciip_sched_parallel_for(0, SCHED_TEST_COUNT, SCHED_TEST_GRAIN, sched_sum, test, NULL);
+   return NULL;
+}
+
+TEST_GROUP(SchedTestGroup)
+{
+   Sched_Test *test;
+
+   void setup()
+   {
+      test = (Sched_Test *)calloc(1, sizeof(Sched_Test));
+      test->hits = (uint8_t *)calloc(SCHED_TEST_COUNT, 1);
+   }
+
+   void teardown()
+   {
+      asciip_sched_set_workers(0, NULL);
+      free(test->hits);
+      free(test);
+   }
+
+   /* Folds the chunk sums in chunk order */
+   double fold()
+   {
+      double total = 0.0;
+      size_t ind;
+
+      for (ind = 0; ind < SCHED_TEST_COUNT / SCHED_TEST_GRAIN; ind++)
+      {
+         total += test->sums[ind];
+      }
+      return total;
+   }
+};
+
+TEST(SchedTestGroup, TestSchedSingle)
+{
+   LONGS_EQUAL(-1, asciip_sched_set_workers(ASCIIP_SCHED_MAX_WORKERS + 1, NULL));
+   LONGS_EQUAL(0, asciip_sched_set_workers(1, NULL));
+   UNSIGNED_LONGS_EQUAL(1, asciip_sched_workers());
+
+   /* One worker runs the chunks in order, the last one cut short */
+   LONGS_EQUAL(0, asciip_sched_parallel_for(3, 103, 10, sched_record, test, NULL));
+   UNSIGNED_LONGS_EQUAL(10, test->calls);
+   UNSIGNED_LONGS_EQUAL(3, test->begins[0]);
+   UNSIGNED_LONGS_EQUAL(13, test->ends[0]);
+   UNSIGNED_LONGS_EQUAL(13, test->begins[1]);
+   UNSIGNED_LONGS_EQUAL(93, test->begins[9]);
+   UNSIGNED_LONGS_EQUAL(103, test->ends[9]);
+
+   LONGS_EQUAL(0, asciip_sched_parallel_for(0, 5, 10, sched_record, test, NULL));
+   UNSIGNED_LONGS_EQUAL(11, test->calls);
+   UNSIGNED_LONGS_EQUAL(5, test->ends[10]);
+
+   /* Nothing to run, or nothing that can be run */
+   LONGS_EQUAL(0, asciip_sched_parallel_for(7, 7, 10, sched_record, test, NULL));
+   LONGS_EQUAL(-1, asciip_sched_parallel_for(0, 10, 0, sched_record, test, NULL));
+   LONGS_EQUAL(-1, asciip_sched_parallel_for(0, 10, 1, NULL, test, NULL));
+   UNSIGNED_LONGS_EQUAL(11, test->calls);
+}
+
+TEST(SchedTestGroup, TestSchedParallel)
+{
+   Sched_Test *second;
+   pthread_t other;
+   double single;
+   size_t ind;
+
+   LONGS_EQUAL(0, asciip_sched_set_workers(1, NULL));
+   LONGS_EQUAL(0, asciip_sched_parallel_for(0, SCHED_TEST_COUNT, SCHED_TEST_GRAIN, sched_sum, test, NULL));
+   single = fold();
+
+   /* Every index runs once, and per chunk results fold to the same
+    * answer on any number of workers */
+   LONGS_EQUAL(0, asciip_sched_set_workers(4, NULL));
+   UNSIGNED_LONGS_EQUAL(4, asciip_sched_workers());
+   memset(test->hits, 0, SCHED_TEST_COUNT);
+   LONGS_EQUAL(0, asciip_sched_parallel_for(0, SCHED_TEST_COUNT, SCHED_TEST_GRAIN, sched_sum, test, NULL));
+   for (ind = 0; ind < SCHED_TEST_COUNT; ind++)
+   {
+      UNSIGNED_LONGS_EQUAL(1, test->hits[ind]);
+   }
+   CHECK(!(fold() < single) && !(single < fold()));
+
+   /* A job started from a job runs inline */
+   memset(test->hits, 0, SCHED_TEST_COUNT);
+   LONGS_EQUAL(0, asciip_sched_parallel_for(0, SCHED_TEST_COUNT / SCHED_TEST_GRAIN, 1, sched_nested, test, NULL));
+   for (ind = 0; ind < SCHED_TEST_COUNT; ind++)
+   {
+      UNSIGNED_LONGS_EQUAL(1, test->hits[ind]);
+   }
+
+   /* Stopped workers come back for the next job, and a job started
+    * while another runs is still run in full */
+   asciip_sched_shutdown();
+   second = (Sched_Test *)calloc(1, sizeof(Sched_Test));
+   second->hits = (uint8_t *)calloc(SCHED_TEST_COUNT, 1);
+   memset(test->hits, 0, SCHED_TEST_COUNT);
+   pthread_create(&other, NULL, sched_other, second);
+   LONGS_EQUAL(0, asciip_sched_parallel_for(0, SCHED_TEST_COUNT, SCHED_TEST_GRAIN, sched_sum, test, NULL));
+   pthread_join(other, NULL);
+   for (ind = 0; ind < SCHED_TEST_COUNT; ind++)
+   {
+      UNSIGNED_LONGS_EQUAL(1, test->hits[ind]);
+      UNSIGNED_LONGS_EQUAL(1, second->hits[ind]);
+   }
+
+   free(second->hits);
+   free(second);
+}
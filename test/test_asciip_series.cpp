@@ -0,0 +1,360 @@
+/************************************************************************
+ *
+ * File        : test_asciip_series.cpp
+ *
+ * Description : Test cases for the contiguous series container.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_series.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Selects points with a NaN y */
+static uint8_t nan_y(double x, double y, void *context)
+{
+   (void)x;
+   (void)context;
+   return isnan(y);
+}
+
+TEST_GROUP(SeriesTestGroup)
+{
+   Asciip_Series *series;
+
+   void setup()
+   {
+      series = NULL;
+   }
+
+   void teardown()
+   {
+      asciip_series_destroy(series);
+   }
+};
+
+TEST(SeriesTestGroup, TestSeriesInit)
+{
+   /* Check NULL result does not get initialized */
+   CHECK_TEXT((!asciip_series_init(0, NULL, NULL)), "Series was initialized with NULL result");
+
+   /* Empty series does not allocate columns */
+   series = asciip_series_init(0, &series, NULL);
+   CHECK_TEXT((series), "Series was not initialized with non-NULL result");
+   UNSIGNED_LONGS_EQUAL(0, series->size);
+   UNSIGNED_LONGS_EQUAL(0, series->capacity);
+   CHECK_TEXT((!series->x), "Empty series allocated x column");
+   asciip_series_destroy(series);
+
+   /* Reserved series has room up front */
+   series = asciip_series_init(100, &series, NULL);
+   CHECK_TEXT((series), "Series was not initialized with capacity");
+   UNSIGNED_LONGS_EQUAL(0, series->size);
+   UNSIGNED_LONGS_EQUAL(100, series->capacity);
+}
+
+TEST(SeriesTestGroup, TestSeriesAddGet)
+{
+   Asciip_Point point;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+
+   for (ind = 0; ind < 1000; ind++)
+   {
+      LONGS_EQUAL(0, asciip_series_add(series, (double)ind, (double)(2 * ind), NULL));
+   }
+   UNSIGNED_LONGS_EQUAL(1000, series->size);
+   CHECK_TEXT((series->capacity >= 1000), "Series capacity smaller than size");
+   CHECK_TEXT((series->capacity < 2000), "Series capacity grew more than double");
+
+   POINTERS_EQUAL(&point, asciip_series_get(series, 999, &point, NULL));
+   DOUBLES_EQUAL(999.0, point.x, 0.0);
+   DOUBLES_EQUAL(1998.0, point.y, 0.0);
+
+   /* Out of bounds and NULL arguments fail */
+   CHECK_TEXT((!asciip_series_get(series, 1000, &point, NULL)), "Got point past end of series");
+   CHECK_TEXT((!asciip_series_get(series, 0, NULL, NULL)), "Got point into NULL result");
+   LONGS_EQUAL(-1, asciip_series_add(NULL, 0, 0, NULL));
+}
+
+TEST(SeriesTestGroup, TestSeriesReserve)
+{
+   double *columnp;
+
+   series = asciip_series_init(0, &series, NULL);
+   LONGS_EQUAL(0, asciip_series_reserve(series, 500, NULL));
+   UNSIGNED_LONGS_EQUAL(500, series->capacity);
+
+   /* Adding within the reservation never moves the columns */
+   columnp = series->x;
+   while (series->size < 500)
+   {
+      asciip_series_add(series, 1.0, 1.0, NULL);
+   }
+   POINTERS_EQUAL(columnp, series->x);
+
+   /* Reserve never shrinks */
+   LONGS_EQUAL(0, asciip_series_reserve(series, 10, NULL));
+   UNSIGNED_LONGS_EQUAL(500, series->capacity);
+}
+
+TEST(SeriesTestGroup, TestSeriesFromList)
+{
+   Asciip_List  *list;
+   Asciip_Point *point;
+   size_t ind;
+
+   point = asciip_point_init(0, 10, &point, NULL);
+   list = asciip_list_init(point, &list, NULL);
+   for (ind = 1; ind < 5; ind++)
+   {
+      point = asciip_point_init((double)ind, (double)(10 + ind), &point, NULL);
+      asciip_list_add(list, point, NULL);
+   }
+
+   series = asciip_series_from_list(list, &series, NULL);
+   CHECK_TEXT((series), "Series not created from list");
+   UNSIGNED_LONGS_EQUAL(5, series->size);
+   for (ind = 0; ind < 5; ind++)
+   {
+      DOUBLES_EQUAL((double)ind, series->x[ind], 0.0);
+      DOUBLES_EQUAL((double)(10 + ind), series->y[ind], 0.0);
+   }
+
+   asciip_list_destroy(list, NULL);
+}
+
+TEST(SeriesTestGroup, TestSeriesMemoryBudget)
+{
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   for (ind = 0; ind < 100001; ind++)
+   {
+      asciip_series_add(series, (double)ind, 0, NULL);
+   }
+
+   /* Growth slack must stay within the stated per point budget */
+   CHECK_TEXT((series->capacity * 2 * sizeof(double) <= series->size * ASCIIP_SERIES_MAX_BYTES_PER_POINT),
+              "Series exceeded its memory budget");
+}
+
+/* 10^8 points needs ~1.6 GB, so this only runs with asciip_test -ri.
+ * The list index limits are covered by TestListIndexPastUint32 */
+IGNORE_TEST(SeriesTestGroup, TestSeriesHundredMillionPoints)
+{
+   const size_t count = 100000000;
+   Asciip_Point point;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   for (ind = 0; ind < count; ind++)
+   {
+      LONGS_EQUAL(0, asciip_series_add(series, (double)ind, (double)ind, NULL));
+   }
+   UNSIGNED_LONGS_EQUAL(count, series->size);
+   CHECK_TEXT((series->capacity * 2 * sizeof(double) <= series->size * ASCIIP_SERIES_MAX_BYTES_PER_POINT),
+              "Series exceeded its memory budget");
+
+   asciip_series_get(series, count - 1, &point, NULL);
+   DOUBLES_EQUAL((double)(count - 1), point.x, 0.0);
+}
+
+TEST(SeriesTestGroup, TestSeriesCursorRuns)
+{
+   Asciip_Series_Cursor cursor;
+   const double *xs;
+   const double *ys;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   for (ind = 0; ind < 10; ind++)
+   {
+      asciip_series_add(series, (double)ind, (double)(ind * ind), NULL);
+   }
+
+   /* Bounded runs point straight into the columns */
+   asciip_series_cursor_begin(series, &cursor);
+   UNSIGNED_LONGS_EQUAL(4, asciip_series_cursor_next_run(&cursor, 4, &xs, &ys));
+   POINTERS_EQUAL(series->x, xs);
+   UNSIGNED_LONGS_EQUAL(4, asciip_series_cursor_next_run(&cursor, 4, &xs, &ys));
+   DOUBLES_EQUAL(4.0, xs[0], 0.0);
+   DOUBLES_EQUAL(49.0, ys[3], 0.0);
+   UNSIGNED_LONGS_EQUAL(2, asciip_series_cursor_next_run(&cursor, 4, &xs, &ys));
+   UNSIGNED_LONGS_EQUAL(0, asciip_series_cursor_next_run(&cursor, 4, &xs, &ys));
+
+   /* Unbounded run returns the rest of the series */
+   asciip_series_cursor_begin(series, &cursor);
+   UNSIGNED_LONGS_EQUAL(10, asciip_series_cursor_next_run(&cursor, 0, &xs, &ys));
+   UNSIGNED_LONGS_EQUAL(0, asciip_series_cursor_next_run(&cursor, 0, &xs, &ys));
+}
+
+TEST(SeriesTestGroup, TestSeriesBulkAdd)
+{
+   double xs[100];
+   double ys[100];
+   double xys[200];
+   double *adopt_x;
+   double *adopt_y;
+   size_t ind;
+
+   for (ind = 0; ind < 100; ind++)
+   {
+      xs[ind] = (double)ind;
+      ys[ind] = (double)(100 + ind);
+      xys[2 * ind] = (double)(200 + ind);
+      xys[2 * ind + 1] = (double)(300 + ind);
+   }
+
+   series = asciip_series_init(0, &series, NULL);
+   LONGS_EQUAL(0, asciip_series_add_many(series, xs, ys, 100, NULL));
+   LONGS_EQUAL(0, asciip_series_add_interleaved(series, xys, 100, NULL));
+   UNSIGNED_LONGS_EQUAL(200, series->size);
+   DOUBLES_EQUAL(99.0, series->x[99], 0.0);
+   DOUBLES_EQUAL(199.0, series->y[99], 0.0);
+   DOUBLES_EQUAL(200.0, series->x[100], 0.0);
+   DOUBLES_EQUAL(399.0, series->y[199], 0.0);
+
+   /* Adopting into a non-empty series copies and frees */
+   adopt_x = (double *)malloc(2 * sizeof(double));
+   adopt_y = (double *)malloc(2 * sizeof(double));
+   adopt_x[0] = adopt_x[1] = adopt_y[0] = adopt_y[1] = -1.0;
+   LONGS_EQUAL(0, asciip_series_adopt(series, adopt_x, adopt_y, 2, NULL));
+   UNSIGNED_LONGS_EQUAL(202, series->size);
+   DOUBLES_EQUAL(-1.0, series->y[201], 0.0);
+
+   LONGS_EQUAL(-1, asciip_series_add_many(series, NULL, ys, 1, NULL));
+   UNSIGNED_LONGS_EQUAL(202, series->size);
+}
+
+TEST(SeriesTestGroup, TestSeriesAdoptEmpty)
+{
+   double *xs = (double *)malloc(3 * sizeof(double));
+   double *ys = (double *)malloc(3 * sizeof(double));
+
+   xs[0] = 1; xs[1] = 2; xs[2] = 3;
+   ys[0] = 4; ys[1] = 5; ys[2] = 6;
+
+   /* An empty series takes the arrays without copying */
+   series = asciip_series_init(0, &series, NULL);
+   LONGS_EQUAL(0, asciip_series_adopt(series, xs, ys, 3, NULL));
+   POINTERS_EQUAL(xs, series->x);
+   POINTERS_EQUAL(ys, series->y);
+   UNSIGNED_LONGS_EQUAL(3, series->size);
+
+   /* Appending after adoption grows the adopted columns */
+   LONGS_EQUAL(0, asciip_series_add(series, 7, 8, NULL));
+   DOUBLES_EQUAL(3.0, series->x[2], 0.0);
+   DOUBLES_EQUAL(8.0, series->y[3], 0.0);
+}
+
+TEST(SeriesTestGroup, TestSeriesRemoveBatch)
+{
+   Asciip_Series *removed;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   removed = asciip_series_init(0, &removed, NULL);
+   for (ind = 0; ind < 100; ind++)
+   {
+      asciip_series_add(series, (double)ind, (ind % 10 == 0) ? NAN : (double)ind, NULL);
+   }
+
+   LONGS_EQUAL(-1, asciip_series_remove_range(series, 90, 11, NULL, NULL));
+   LONGS_EQUAL(-1, asciip_series_remove_range(series, 0, 1, series, NULL));
+   UNSIGNED_LONGS_EQUAL(100, series->size);
+
+   /* Leading window trim */
+   LONGS_EQUAL(0, asciip_series_remove_range(series, 0, 5, removed, NULL));
+   UNSIGNED_LONGS_EQUAL(95, series->size);
+   UNSIGNED_LONGS_EQUAL(5, removed->size);
+   DOUBLES_EQUAL(5.0, series->x[0], 0.0);
+   DOUBLES_EQUAL(4.0, removed->x[4], 0.0);
+
+   /* NaN x values fall outside any range */
+   series->x[94] = NAN;
+   LONGS_EQUAL(0, asciip_series_remove_outside(series, 10.0, 90.0, NULL, NULL));
+   UNSIGNED_LONGS_EQUAL(80, series->size);
+   DOUBLES_EQUAL(10.0, series->x[0], 0.0);
+   DOUBLES_EQUAL(89.0, series->x[79], 0.0);
+
+   /* Dropping NaN samples keeps the order of the rest */
+   LONGS_EQUAL(0, asciip_series_remove_if(series, nan_y, NULL, removed, NULL));
+   UNSIGNED_LONGS_EQUAL(72, series->size);
+   UNSIGNED_LONGS_EQUAL(13, removed->size);
+   DOUBLES_EQUAL(11.0, series->x[0], 0.0);
+   DOUBLES_EQUAL(89.0, series->y[71], 0.0);
+   DOUBLES_EQUAL(20.0, removed->x[6], 0.0);
+
+   asciip_series_destroy(removed);
+}
+
+TEST(SeriesTestGroup, TestSeriesRange)
+{
+   Asciip_Series_View view;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   LONGS_EQUAL(0, asciip_series_range(series, 0.0, 1.0, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(0, view.size);
+
+   /* Repeated x values, then a NaN sorted past the end */
+   for (ind = 0; ind < 1000; ind++)
+   {
+      asciip_series_add(series, (double)(ind / 2), (double)ind, NULL);
+   }
+   asciip_series_add(series, NAN, 0.0, NULL);
+
+   LONGS_EQUAL(0, asciip_series_range(series, 10.0, 20.0, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(20, view.offset);
+   UNSIGNED_LONGS_EQUAL(20, view.size);
+   POINTERS_EQUAL(series->x + 20, view.x);
+   POINTERS_EQUAL(series->y + 20, view.y);
+   DOUBLES_EQUAL(39.0, view.y[19], 0.0);
+
+   /* Fractional bounds, bounds past either end and empty ranges */
+   LONGS_EQUAL(0, asciip_series_range(series, 9.5, 10.5, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(20, view.offset);
+   UNSIGNED_LONGS_EQUAL(2, view.size);
+   LONGS_EQUAL(0, asciip_series_range(series, -INFINITY, INFINITY, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(1000, view.size);
+   LONGS_EQUAL(0, asciip_series_range(series, 600.0, 700.0, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(1000, view.offset);
+   UNSIGNED_LONGS_EQUAL(0, view.size);
+   LONGS_EQUAL(0, asciip_series_range(series, 20.0, 10.0, &view, NULL));
+   UNSIGNED_LONGS_EQUAL(0, view.size);
+   LONGS_EQUAL(-1, asciip_series_range(series, NAN, 10.0, &view, NULL));
+
+   UNSIGNED_LONGS_EQUAL(0, asciip_series_lower_bound(series, -1.0));
+   UNSIGNED_LONGS_EQUAL(998, asciip_series_lower_bound(series, 499.0));
+   UNSIGNED_LONGS_EQUAL(1000, asciip_series_lower_bound(series, 499.5));
+}
@@ -0,0 +1,156 @@
+/************************************************************************
+ *
+ * File        : test_asciip_sort.cpp
+ *
+ * Description : Test cases for the radix sort engine and the series
+ *               and list sorts built on it.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_sched.h"
+#include "asciip_series.h"
+#include "asciip_sort.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(SortTestGroup)
+{
+   void setup()
+   {
+      /* Do nothing */
+   }
+
+   void teardown()
+   {
+      /* Do nothing */
+   }
+
+   /* Sorts count random keys drawn from few values with the given thread
+    * count and checks the order and that equal keys kept their order */
+   void check_radix(size_t count, uint32_t threads)
+   {
+      uint64_t *keys = (uint64_t *)malloc(count * sizeof(uint64_t));
+      uint64_t *values = (uint64_t *)malloc(count * sizeof(uint64_t));
+      size_t ind;
+
+      srand(11);
+      for (ind = 0; ind < count; ind++)
+      {
+         keys[ind] = asciip_sort_key((double)(rand() % 1000) - 500.0);
+         values[ind] = ind;
+      }
+
+      LONGS_EQUAL(0, asciip_sort_radix(keys, values, count, threads, NULL));
+
+      for (ind = 1; ind < count; ind++)
+      {
+         CHECK_TEXT((keys[ind - 1] <= keys[ind]), "Keys not sorted");
+         if (keys[ind - 1] == keys[ind])
+         {
+            CHECK_TEXT((values[ind - 1] < values[ind]), "Sort was not stable");
+         }
+      }
+
+      free(keys);
+      free(values);
+   }
+};
+
+TEST(SortTestGroup, TestSortKeyOrder)
+{
+   const double ordered[] = { -INFINITY, -1e300, -2.5, -1e-300, -0.0, 0.0, 1e-300, 2.5, 1e300, INFINITY };
+   size_t ind;
+
+   for (ind = 1; ind < sizeof(ordered) / sizeof(ordered[0]); ind++)
+   {
+      CHECK_TEXT((asciip_sort_key(ordered[ind - 1]) < asciip_sort_key(ordered[ind])), "Keys out of order");
+   }
+
+   /* Keys map back to the same values */
+   for (ind = 0; ind < sizeof(ordered) / sizeof(ordered[0]); ind++)
+   {
+      double value = asciip_sort_value(asciip_sort_key(ordered[ind]));
+
+      MEMCMP_EQUAL(&ordered[ind], &value, sizeof(double));
+   }
+
+   /* NaN sorts above infinity */
+   CHECK_TEXT((asciip_sort_key(INFINITY) < asciip_sort_key(NAN)), "NaN did not sort last");
+}
+
+TEST(SortTestGroup, TestSortRadixSmall)
+{
+   check_radix(10, 0);
+}
+
+TEST(SortTestGroup, TestSortRadixSingleThread)
+{
+   check_radix(100000, 1);
+}
+
+TEST(SortTestGroup, TestSortRadixThreads)
+{
+   check_radix(100003, 4);
+
+   /* The same slices run on scheduler workers */
+   LONGS_EQUAL(0, asciip_sched_set_workers(4, NULL));
+   check_radix(100003, 4);
+   check_radix(ASCIIP_SORT_THREAD_MIN * 4 + 1, 0);
+   LONGS_EQUAL(0, asciip_sched_set_workers(0, NULL));
+}
+
+TEST(SortTestGroup, TestSortSeries)
+{
+   Asciip_Series *series;
+   size_t ind;
+
+   series = asciip_series_init(0, &series, NULL);
+   srand(3);
+   for (ind = 0; ind < 50000; ind++)
+   {
+      double x = (double)(rand() % 20000) / 7.0 - 1000.0;
+
+      /* y remembers x so pairs can be checked after the sort */
+      asciip_series_add(series, x, 2.0 * x, NULL);
+   }
+
+   LONGS_EQUAL(0, asciip_series_sort(series, NULL));
+   UNSIGNED_LONGS_EQUAL(50000, series->size);
+   for (ind = 0; ind < series->size; ind++)
+   {
+      if (ind > 0)
+      {
+         CHECK_TEXT((series->x[ind - 1] <= series->x[ind]), "Series not sorted");
+      }
+      DOUBLES_EQUAL(2.0 * series->x[ind], series->y[ind], 0.0);
+   }
+
+   asciip_series_destroy(series);
+}
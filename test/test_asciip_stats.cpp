@@ -0,0 +1,183 @@
+/************************************************************************
+ *
+ * File        : test_asciip_stats.cpp
+ *
+ * Description : Test cases for the bounds and statistics kernel.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdint.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_sched.h"
+#include "asciip_stats.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(StatsTestGroup)
+{
+   Asciip_Series *series;
+
+   void setup()
+   {
+      series = NULL;
+   }
+
+   void teardown()
+   {
+      asciip_series_destroy(series);
+   }
+};
+
+TEST(StatsTestGroup, TestStatsKernelsAgree)
+{
+   Asciip_Axis_Stats stats[ASCIIP_STATS_AVX2 + 1];
+   double values[1001];
+   size_t count;
+   size_t ind;
+   uint8_t isa;
+
+   /* Integer values keep every summation order exact */
+   for (ind = 0; ind < 1001; ind++)
+   {
+      values[ind] = (ind % 7 == 3) ? NAN : (double)((ind * 37) % 1000) - 500.0;
+   }
+
+   /* Lengths around every vector width and unroll exercise the tails */
+   for (count = 0; count < 20; count++)
+   {
+      for (isa = ASCIIP_STATS_SCALAR; isa <= ASCIIP_STATS_AVX2; isa++)
+      {
+         asciip_stats_column(values + 1, count, isa, &stats[isa]);
+      }
+
+      for (isa = ASCIIP_STATS_SSE2; isa <= ASCIIP_STATS_AVX2; isa++)
+      {
+         UNSIGNED_LONGS_EQUAL(stats[0].count, stats[isa].count);
+         UNSIGNED_LONGS_EQUAL(stats[0].nans, stats[isa].nans);
+         DOUBLES_EQUAL(stats[0].sum, stats[isa].sum, 0.0);
+         CHECK((stats[0].count == 0) || (stats[0].min <= stats[isa].min && stats[0].min >= stats[isa].min));
+         CHECK((stats[0].count == 0) || (stats[0].max <= stats[isa].max && stats[0].max >= stats[isa].max));
+      }
+   }
+
+   asciip_stats_column(values, 1001, asciip_stats_isa(), &stats[0]);
+   UNSIGNED_LONGS_EQUAL(143, stats[0].nans);
+   UNSIGNED_LONGS_EQUAL(858, stats[0].count);
+   DOUBLES_EQUAL(-500.0, stats[0].min, 0.0);
+   DOUBLES_EQUAL(499.0, stats[0].max, 0.0);
+
+   /* No values leaves min and max undefined */
+   asciip_stats_column(values + 3, 1, ASCIIP_STATS_SCALAR, &stats[0]);
+   UNSIGNED_LONGS_EQUAL(0, stats[0].count);
+   UNSIGNED_LONGS_EQUAL(1, stats[0].nans);
+   CHECK(isnan(stats[0].min));
+   CHECK(isnan(stats[0].max));
+}
+
+TEST(StatsTestGroup, TestStatsSeriesAndList)
+{
+   Asciip_Bounds series_bounds;
+   Asciip_Bounds list_bounds;
+   Asciip_Axis_Stats merged;
+   Asciip_List *list;
+   size_t ind;
+
+   LONGS_EQUAL(-1, asciip_stats_series(NULL, &series_bounds, NULL));
+   LONGS_EQUAL(-1, asciip_stats_list(NULL, &list_bounds, NULL));
+
+   series = asciip_series_init(0, &series, NULL);
+   list = asciip_list_init(NULL, &list, NULL);
+   for (ind = 0; ind < 100; ind++)
+   {
+      double y = (ind == 50) ? INFINITY : ((ind == 60) ? NAN : (double)ind);
+
+      asciip_series_add(series, (double)ind - 10.0, y, NULL);
+      asciip_list_add_xy(list, (double)ind - 10.0, y, NULL);
+   }
+
+   LONGS_EQUAL(0, asciip_stats_series(series, &series_bounds, NULL));
+   LONGS_EQUAL(0, asciip_stats_list(list, &list_bounds, NULL));
+
+   DOUBLES_EQUAL(-10.0, series_bounds.x.min, 0.0);
+   DOUBLES_EQUAL(89.0, series_bounds.x.max, 0.0);
+   DOUBLES_EQUAL(3950.0, series_bounds.x.sum, 0.0);
+   UNSIGNED_LONGS_EQUAL(100, series_bounds.x.count);
+   UNSIGNED_LONGS_EQUAL(1, series_bounds.y.nans);
+   UNSIGNED_LONGS_EQUAL(99, series_bounds.y.count);
+   CHECK(isinf(series_bounds.y.max));
+
+   /* The list walk gives the same answer */
+   DOUBLES_EQUAL(series_bounds.x.min, list_bounds.x.min, 0.0);
+   DOUBLES_EQUAL(series_bounds.x.max, list_bounds.x.max, 0.0);
+   DOUBLES_EQUAL(series_bounds.x.sum, list_bounds.x.sum, 0.0);
+   DOUBLES_EQUAL(series_bounds.y.min, list_bounds.y.min, 0.0);
+   UNSIGNED_LONGS_EQUAL(series_bounds.y.nans, list_bounds.y.nans);
+   UNSIGNED_LONGS_EQUAL(series_bounds.y.count, list_bounds.y.count);
+
+   /* Merging per-block statistics equals the whole */
+   asciip_stats_column(series->x, 30, ASCIIP_STATS_SCALAR, &merged);
+   asciip_stats_column(series->x + 30, 70, ASCIIP_STATS_SCALAR, &list_bounds.x);
+   asciip_stats_merge(&merged, &list_bounds.x);
+   DOUBLES_EQUAL(series_bounds.x.min, merged.min, 0.0);
+   DOUBLES_EQUAL(series_bounds.x.max, merged.max, 0.0);
+   DOUBLES_EQUAL(series_bounds.x.sum, merged.sum, 0.0);
+   UNSIGNED_LONGS_EQUAL(100, merged.count);
+
+   LONGS_EQUAL(0, asciip_list_destroy(list, NULL));
+}
+
+TEST(StatsTestGroup, TestStatsSeriesChunked)
+{
+   Asciip_Bounds single;
+   Asciip_Bounds parallel;
+   Asciip_Axis_Stats whole;
+   size_t count = 5 * ASCIIP_STATS_CHUNK + 123;
+   size_t ind;
+
+   series = asciip_series_init(count, &series, NULL);
+   for (ind = 0; ind < count; ind++)
+   {
+      asciip_series_add(series, sin((double)ind) * 1e3, (ind % 1000 == 7) ? NAN : cos((double)ind), NULL);
+   }
+
+   /* Chunks fold to the same bounds on any number of workers */
+   LONGS_EQUAL(0, asciip_sched_set_workers(1, NULL));
+   LONGS_EQUAL(0, asciip_stats_series(series, &single, NULL));
+   LONGS_EQUAL(0, asciip_sched_set_workers(4, NULL));
+   LONGS_EQUAL(0, asciip_stats_series(series, &parallel, NULL));
+   LONGS_EQUAL(0, asciip_sched_set_workers(0, NULL));
+   MEMCMP_EQUAL(&single, &parallel, sizeof(Asciip_Bounds));
+
+   /* and to those of one pass, but for the rounding of the sum */
+   asciip_stats_column(series->y, count, asciip_stats_isa(), &whole);
+   DOUBLES_EQUAL(whole.min, parallel.y.min, 0.0);
+   DOUBLES_EQUAL(whole.max, parallel.y.max, 0.0);
+   DOUBLES_EQUAL(whole.sum, parallel.y.sum, 1e-9);
+   UNSIGNED_LONGS_EQUAL(whole.count, parallel.y.count);
+   UNSIGNED_LONGS_EQUAL(whole.nans, parallel.y.nans);
+}
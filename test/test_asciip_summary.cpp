@@ -0,0 +1,159 @@
+/************************************************************************
+ *
+ * File        : test_asciip_summary.cpp
+ *
+ * Description : Test cases for the running list summary.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_summary.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+
+/* Checks the running summary of list against a full scan */
+static void check_summary(Asciip_List *list)
+{
+   Asciip_Bounds running;
+   Asciip_Bounds scanned;
+
+   LONGS_EQUAL(0, asciip_summary_get(list, &running, NULL));
+   LONGS_EQUAL(0, asciip_stats_list(list, &scanned, NULL));
+
+   UNSIGNED_LONGS_EQUAL(scanned.x.count, running.x.count);
+   UNSIGNED_LONGS_EQUAL(scanned.y.count, running.y.count);
+   UNSIGNED_LONGS_EQUAL(scanned.y.nans, running.y.nans);
+   if (scanned.x.count > 0)
+   {
+      DOUBLES_EQUAL(scanned.x.min, running.x.min, 0.0);
+      DOUBLES_EQUAL(scanned.x.max, running.x.max, 0.0);
+      DOUBLES_EQUAL(scanned.x.sum, running.x.sum, 1e-6);
+   }
+   if (scanned.y.count > 0)
+   {
+      DOUBLES_EQUAL(scanned.y.min, running.y.min, 0.0);
+      DOUBLES_EQUAL(scanned.y.max, running.y.max, 0.0);
+   }
+}
+
+TEST_GROUP(SummaryTestGroup)
+{
+   Asciip_List *list;
+
+   void setup()
+   {
+      list = asciip_list_init(NULL, &list, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_list_destroy(list, NULL);
+   }
+};
+
+TEST(SummaryTestGroup, TestSummaryTracking)
+{
+   Asciip_Bounds bounds;
+   Asciip_Point *point;
+   size_t ind;
+
+   /* Untracked lists have no summary */
+   LONGS_EQUAL(-1, asciip_summary_get(list, &bounds, NULL));
+
+   asciip_list_add_xy(list, 5.0, 50.0, NULL);
+   LONGS_EQUAL(0, asciip_summary_enable(list, 1, NULL));
+   for (ind = 0; ind < 10; ind++)
+   {
+      asciip_list_add_xy(list, (double)ind, (ind == 3) ? NAN : (double)(10 * ind), NULL);
+   }
+   check_summary(list);
+
+   /* Removing the extremes falls back to the next values */
+   point = asciip_list_remove(list, 0, NULL);
+   asciip_point_destroy(point);
+   LONGS_EQUAL(0, asciip_summary_get(list, &bounds, NULL));
+   DOUBLES_EQUAL(90.0, bounds.y.max, 0.0);
+   point = asciip_list_remove(list, 9, NULL);
+   asciip_point_destroy(point);
+   LONGS_EQUAL(0, asciip_summary_get(list, &bounds, NULL));
+   DOUBLES_EQUAL(8.0, bounds.x.max, 0.0);
+   DOUBLES_EQUAL(80.0, bounds.y.max, 0.0);
+   check_summary(list);
+
+   /* Batch removal and runs moved between lists */
+   LONGS_EQUAL(0, asciip_list_remove_outside(list, 2.0, 6.0, NULL, NULL));
+   check_summary(list);
+   UNSIGNED_LONGS_EQUAL(4, list->size);
+
+   LONGS_EQUAL(0, asciip_list_remove_range(list, 0, 4, NULL, NULL));
+   LONGS_EQUAL(0, asciip_summary_get(list, &bounds, NULL));
+   UNSIGNED_LONGS_EQUAL(0, bounds.x.count);
+   CHECK(isnan(bounds.x.min));
+   LONGS_EQUAL(0, asciip_list_add_xy(list, -1.0, -2.0, NULL));
+   check_summary(list);
+
+   LONGS_EQUAL(0, asciip_summary_enable(list, 0, NULL));
+   POINTERS_EQUAL(NULL, list->summary);
+}
+
+TEST(SummaryTestGroup, TestSummarySlidingWindow)
+{
+   Asciip_List *other;
+   size_t ind;
+
+   LONGS_EQUAL(0, asciip_summary_enable(list, 1, NULL));
+   srand(7);
+
+   /* A live window: append at the back, trim from the front */
+   for (ind = 0; ind < 5000; ind++)
+   {
+      asciip_list_add_xy(list, (double)ind, (double)(rand() % 1000), NULL);
+      if (list->size > 300)
+      {
+         asciip_point_destroy(asciip_list_remove(list, 0, NULL));
+      }
+
+      if (ind % 97 == 0)
+      {
+         check_summary(list);
+      }
+   }
+   check_summary(list);
+
+   /* Removed values held by the heaps stay bounded */
+   CHECK(list->summary->x.dead[1].size <= 2 * list->size + ASCIIP_SUMMARY_SLACK);
+
+   other = asciip_list_init(NULL, &other, NULL);
+   asciip_list_add_xy(other, 1e6, -1.0, NULL);
+   LONGS_EQUAL(0, asciip_list_concat(list, other, NULL));
+   check_summary(list);
+   LONGS_EQUAL(0, asciip_list_destroy(other, NULL));
+}
@@ -0,0 +1,131 @@
+/************************************************************************
+ *
+ * File        : test_asciip_term.cpp
+ *
+ * Description : Test cases for dirty cell terminal output.
+ *
+ * Author(s)   : N. McCallum
+ *
+ * Version     : 0.1
+ *
+ ************************************************************************/
+
+/************************************************************************
+ * Standard Header Includes
+ ************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/************************************************************************
+ * Other Header Includes
+ ************************************************************************/
+#include "CppUTest/TestHarness.h"
+#include "asciip_term.h"
+
+/************************************************************************
+ * Macro Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Type and Struct Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Constant and Enumeration Definitions
+ ************************************************************************/
+
+/************************************************************************
+ * Functions
+ ************************************************************************/
+TEST_GROUP(TermTestGroup)
+{
+   Asciip_Canvas *canvas;
+   Asciip_Term *term;
+   FILE *stream;
+
+   void setup()
+   {
+      stream = tmpfile();
+      canvas = asciip_canvas_init(12, 2, &canvas, NULL);
+      term = asciip_term_init(fileno(stream), 12, 2, &term, NULL);
+   }
+
+   void teardown()
+   {
+      asciip_term_destroy(term);
+      asciip_canvas_destroy(canvas);
+      fclose(stream);
+   }
+
+   void check_diff(const char *expected)
+   {
+      const char *frame;
+      size_t length;
+
+      frame = asciip_term_diff(term, canvas, &length, NULL);
+      CHECK(frame != NULL);
+      UNSIGNED_LONGS_EQUAL(strlen(expected), length);
+      MEMCMP_EQUAL(expected, frame, length);
+   }
+};
+
+TEST(TermTestGroup, TestTermDiff)
+{
+   Asciip_Canvas *other;
+   Asciip_Term *small;
+   size_t length;
+
+   CHECK_TEXT((!asciip_term_init(1, 0, 2, &small, NULL)), "Terminal was initialized without columns");
+
+   /* The first frame sends every cell */
+   check_diff("\033[1;1H            \033[2;1H            ");
+   check_diff("");
+
+   /* Adjacent changes need no move, a one cell gap is bridged with the
+    * shown glyph, a wide gap skips ahead, a new row moves */
+   canvas->cells[2] = '*';
+   canvas->cells[3] = '*';
+   canvas->cells[5] = '*';
+   canvas->cells[11] = '*';
+   canvas->cells[canvas->stride + 4] = '#';
+   check_diff("\033[1;3H** *\033[5C*\033[2;5H#");
+
+   /* Braille cells go out as UTF-8, empty ones as spaces */
+   LONGS_EQUAL(0, asciip_canvas_set_mode(canvas, ASCIIP_CANVAS_BRAILLE, NULL));
+   canvas->dots[1] = 0x01;
+   check_diff("\033[1;2H\xE2\xA0\x81" "    \033[5C \033[2;5H ");
+
+   /* Invalidating redraws everything, a size mismatch is refused */
+   asciip_term_invalidate(term);
+   CHECK(asciip_term_diff(term, canvas, &length, NULL) != NULL);
+   UNSIGNED_LONGS_EQUAL(2 * 6 + 23 + 3, length);
+   other = asciip_canvas_init(3, 2, &other, NULL);
+   CHECK(asciip_term_diff(term, other, &length, NULL) == NULL);
+   asciip_canvas_destroy(other);
+}
+
+TEST(TermTestGroup, TestTermDraw)
+{
+   char sent[64];
+
+   /* One write per frame, none when nothing changed */
+   canvas->cells[0] = 'x';
+   LONGS_EQUAL(0, asciip_term_draw(term, canvas, NULL));
+   UNSIGNED_LONGS_EQUAL(1, term->writes);
+   UNSIGNED_LONGS_EQUAL(36, term->bytes);
+
+   LONGS_EQUAL(0, asciip_term_draw(term, canvas, NULL));
+   UNSIGNED_LONGS_EQUAL(0, term->writes);
+   UNSIGNED_LONGS_EQUAL(0, term->bytes);
+
+   canvas->cells[1] = 'y';
+   LONGS_EQUAL(0, asciip_term_draw(term, canvas, NULL));
+   UNSIGNED_LONGS_EQUAL(3, term->frames);
+   UNSIGNED_LONGS_EQUAL(43, term->total_bytes);
+   UNSIGNED_LONGS_EQUAL(2, term->total_writes);
+
+   rewind(stream);
+   UNSIGNED_LONGS_EQUAL(43, fread(sent, 1, sizeof(sent), stream));
+   MEMCMP_EQUAL("\033[1;2Hy", sent + 36, 7);
+}